@@ -11,6 +11,8 @@ set LinkerFlags=/incremental:no /opt:ref
 
 call cl %CompilerFlags% ..\sim8086.c /link %LinkerFlags%
 @REM call cl %CompilerFlags% ..\sim8086_v2.c /link %LinkerFlags%
+@REM NOTE: Regenerate the baked opcode table whenever 8086_decoding_guide.txt changes.
+@REM call sim8086_v2.exe -bake ..\8086_decoding_guide.txt ..\sim8086_v2_table.h
 @REM call cl %CompilerFlags% ..\permute.c /link %LinkerFlags%
 
 @REM call nasm ..\all.asm -o %~dp0build\all
@@ -150,6 +150,28 @@ typedef enum instruction_flag : u32
     Inst_Far = 0x10,
 } instruction_flag;
 
+typedef enum register_mapping_8086
+{
+    Register_none,
+
+    Register_a,
+    Register_b,
+    Register_c,
+    Register_d,
+    Register_sp,
+    Register_bp,
+    Register_si,
+    Register_di,
+    Register_es,
+    Register_cs,
+    Register_ss,
+    Register_ds,
+    Register_ip,
+    Register_flags,
+
+    Register_count,
+} register_mapping_8086;
+
 typedef struct register_access
 {
     u32 Index;
@@ -214,6 +236,32 @@ typedef struct instruction
 
     u32 SegmentOverride;
 } instruction;
+typedef enum packed_operand_flag : u8
+{
+    PackedOperand_TypeMask = 0x3,
+    PackedOperand_Negative = 0x4,
+    PackedOperand_RelativeJumpDisplacement = 0x8,
+    PackedOperand_ExplicitSegment = 0x10,
+    PackedOperand_HighByte = 0x20,
+    PackedOperand_Wide = 0x40,
+} packed_operand_flag;
+typedef struct packed_operand
+{
+    u8 Flags;
+    u8 Registers;
+    u16 Value;
+} packed_operand;
+
+typedef struct packed_instruction
+{
+    u32 Address;
+    u8 Op;
+    u8 Size;
+    u8 Flags;
+    u8 SegmentOverride;
+
+    packed_operand Operands[2];
+} packed_instruction;
 typedef enum instruction_bits_usage : u8
 {
     Bits_End,
@@ -262,6 +310,47 @@ typedef struct instruction_table
     u32 MaxInstructionByteCount;
 } instruction_table;
 
+typedef enum decode_block_stop : u32
+{
+    DecodeBlock_EndOfSource,
+    DecodeBlock_DestFull,
+    DecodeBlock_Unrecognized,
+    DecodeBlock_Truncated,
+} decode_block_stop;
+
+typedef struct decode_block_result
+{
+    u32 ByteCount;
+    u32 InstructionCount;
+    decode_block_stop Stop;
+} decode_block_result;
+
+typedef enum machine_flag : u32
+{
+    Flag_Carry = 0x1,
+    Flag_Parity = 0x4,
+    Flag_AuxiliaryCarry = 0x10,
+    Flag_Zero = 0x40,
+    Flag_Sign = 0x80,
+    Flag_Trap = 0x100,
+    Flag_Interrupt = 0x200,
+    Flag_Direction = 0x400,
+    Flag_Overflow = 0x800,
+} machine_flag;
+
+typedef enum machine_status : u32
+{
+    Machine_Running,
+    Machine_Halted,
+    Machine_Unrecognized,
+    Machine_Unimplemented,
+    Machine_Stopped,
+} machine_status;
+
+typedef struct machine machine;
+
+typedef b32 machine_step_callback(void *Context, machine *Machine, instruction *Executed);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -270,6 +359,22 @@ void Sim86_Decode8086Instruction(u32 SourceSize, u8 *Source, instruction *Dest);
 char const *Sim86_RegisterNameFromOperand(register_access *RegAccess);
 char const *Sim86_MnemonicFromOperationType(operation_type Type);
 void Sim86_Get8086InstructionTable(instruction_table *Dest);
+u32 Sim86_DecodeBlock(u8 *Source, u32 SourceSize, instruction *Dest, u32 DestCapacity, decode_block_result *Consumed);
+u32 Sim86_DecodeBlockPacked(u8 *Source, u32 SourceSize, packed_instruction *Dest, u32 DestCapacity,
+                            decode_block_result *Consumed);
+void Sim86_PackInstruction(instruction *Source, packed_instruction *Dest);
+void Sim86_UnpackInstruction(packed_instruction *Source, instruction *Dest);
+u32 Sim86_DecodeLengths(u8 *Source, u32 SourceSize, u8 *Dest, u32 DestCapacity, decode_block_result *Consumed);
+machine *Sim86_CreateMachine(void);
+void Sim86_DestroyMachine(machine *Machine);
+u16 Sim86_GetRegister(machine *Machine, register_access *Register);
+void Sim86_SetRegister(machine *Machine, register_access *Register, u16 Value);
+u32 Sim86_ReadMemory(machine *Machine, u32 Address, u8 *Dest, u32 Count);
+u32 Sim86_WriteMemory(machine *Machine, u32 Address, u8 *Source, u32 Count);
+machine_status Sim86_Step(machine *Machine, instruction *Executed);
+u64 Sim86_Run(machine *Machine, u64 MaxInstructionCount, machine_step_callback *Callback, void *CallbackContext,
+              machine_status *Status);
+u64 Sim86_RunBlocks(machine *Machine, u64 MaxInstructionCount, machine_status *Status);
 #ifdef __cplusplus
 }
 #endif
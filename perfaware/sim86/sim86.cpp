@@ -24,8 +24,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#include <new>
+#include <thread>
+
 #include "sim86_instruction.h"
 #include "sim86_instruction_table.h"
 #include "sim86_memory.h"
@@ -78,16 +82,53 @@ static segmented_access AllocateMemoryPow2(u32 SizePow2)
     return Result;
 }
 
-static void DisAsm8086(u32 DisAsmByteCount, segmented_access DisAsmStart)
+enum label_mark : u32
+{
+    LabelMark_InstructionStart = 0x1,
+    LabelMark_JumpTarget = 0x2,
+};
+
+/* NOTE(chuck): With labels, disassembly takes two passes. The first decodes the whole region into
+   packed instructions and marks every instruction start and every relative jump, call and loop
+   target in a per-byte table. Targets that land on an instruction get numbered in address order,
+   and the second pass prints from the packed instructions with those numbers. Both passes are
+   linear, and a target that isn't on an instruction boundary just keeps its $+N form. */
+static void DisAsm8086(u32 DisAsmByteCount, segmented_access DisAsmStart, disasm_format Format, text_buffer *Output,
+                       b32 UseLabels = false)
 {
     segmented_access At = DisAsmStart;
     
-    instruction_table Table = Get8086InstructionTable();
+    instruction_dispatch *Dispatch = Get8086InstructionDispatch();
     
+    label_table Labels = {};
+    packed_instruction *Instructions = 0;
+    u32 InstructionCount = 0;
+    if(UseLabels && (Format == DisAsmFormat_ASM))
+    {
+        // NOTE(chuck): Every instruction is at least one byte, so there can't be more instructions
+        // than there are bytes.
+        Labels.BaseAddress = GetAbsoluteAddressOf(DisAsmStart);
+        Labels.ByteCount = DisAsmByteCount;
+        Labels.LabelAt = (u32 *)calloc(DisAsmByteCount + 1, sizeof(u32));
+        Instructions = (packed_instruction *)malloc((DisAsmByteCount + 1)*sizeof(packed_instruction));
+        if(!Labels.LabelAt || !Instructions)
+        {
+            FlushText(Output);
+            fprintf(stderr, "ERROR: Unable to allocate label memory, disassembling without labels.\n");
+            UseLabels = false;
+        }
+    }
+    else
+    {
+        UseLabels = false;
+    }
+    
+    char const *Error = 0;
     u32 Count = DisAsmByteCount;
     while(Count)
     {
-        instruction Instruction = DecodeInstruction(Table, At);
+        instruction Instruction = DecodeInstruction(Dispatch, At);
+        u8 *Bytes = AccessMemory(At);
         if(Instruction.Op)
         {
             if(Count >= Instruction.Size)
@@ -97,21 +138,509 @@ static void DisAsm8086(u32 DisAsmByteCount, segmented_access DisAsmStart)
             }
             else
             {
+                Error = "ERROR: Instruction extends outside disassembly region\n";
+                break;
+            }
+            
+            if(UseLabels)
+            {
+                Labels.LabelAt[Instruction.Address - Labels.BaseAddress] |= LabelMark_InstructionStart;
+                
+                u32 Target = 0;
+                if(GetRelativeJumpTarget(Instruction, &Target) &&
+                   ((Target - Labels.BaseAddress) < Labels.ByteCount))
+                {
+                    Labels.LabelAt[Target - Labels.BaseAddress] |= LabelMark_JumpTarget;
+                }
+                
+                Instructions[InstructionCount++] = PackInstruction(Instruction);
+            }
+            else
+            {
+                FormatDisAsmLine(Format, Instruction, Bytes, Output);
+            }
+        }
+        else
+        {
+            Error = "ERROR: Unrecognized binary in instruction stream.\n";
+            break;
+        }
+    }
+    
+    if(UseLabels)
+    {
+        u32 LabelCount = 0;
+        for(u32 Offset = 0; Offset < Labels.ByteCount; ++Offset)
+        {
+            u32 Marks = Labels.LabelAt[Offset];
+            u32 BothMarks = (LabelMark_InstructionStart | LabelMark_JumpTarget);
+            Labels.LabelAt[Offset] = ((Marks & BothMarks) == BothMarks) ? ++LabelCount : 0;
+        }
+        
+        for(u32 InstructionIndex = 0; InstructionIndex < InstructionCount; ++InstructionIndex)
+        {
+            instruction Instruction = UnpackInstruction(Instructions[InstructionIndex]);
+            
+            u32 Label = GetLabel(&Labels, Instruction.Address);
+            if(Label)
+            {
+                AppendText(Output, "\n", 1);
+                FormatLabel(Label, Output);
+                AppendText(Output, ":\n", 2);
+            }
+            
+            FormatDisAsmLine(Format, Instruction, 0, Output, &Labels);
+        }
+    }
+    
+    free(Instructions);
+    free(Labels.LabelAt);
+    
+    if(Error)
+    {
+        FlushText(Output);
+        fprintf(stderr, "%s", Error);
+    }
+}
+
+static segmented_access AtWindowOffset(segmented_access Window, u32 Offset)
+{
+    // NOTE(chuck): MoveBaseBy only carries 16 bits of offset, so window positions past 64k
+    // have to go through the segment base instead.
+    segmented_access Result = Window;
+    Result.SegmentBase = (u16)(Offset >> 4);
+    Result.SegmentOffset = (u16)(Offset & 0xf);
+    return Result;
+}
+
+static void StreamDisAsm8086(FILE *File, segmented_access Window, disasm_format Format, text_buffer *Output)
+{
+    instruction_dispatch *Dispatch = Get8086InstructionDispatch();
+    
+    // NOTE(chuck): The window is refilled whenever fewer than Lookahead bytes are left in it,
+    // so an instruction that straddles the end of one read is always decoded from contiguous
+    // bytes after the tail has been slid down to the front. The decoder can peek a little past
+    // the longest instruction while chasing prefixes, hence the slack.
+    u32 WindowSize = GetHighestAddress(Window) + 1;
+    u32 Lookahead = 2*Dispatch->Table.MaxInstructionByteCount;
+    assert(Lookahead < WindowSize);
+    
+    u32 Filled = 0;
+    u32 Offset = 0;
+    u32 WindowFileOffset = 0;
+    b32 EndOfFile = false;
+    for(;;)
+    {
+        if(!EndOfFile && ((Filled - Offset) < Lookahead))
+        {
+            u32 Remaining = Filled - Offset;
+            memmove(Window.Memory, Window.Memory + Offset, Remaining);
+            WindowFileOffset += Offset;
+            Filled = Remaining;
+            Offset = 0;
+            
+            while(!EndOfFile && (Filled < WindowSize))
+            {
+                size_t BytesRead = fread(Window.Memory + Filled, 1, WindowSize - Filled, File);
+                Filled += (u32)BytesRead;
+                EndOfFile = (BytesRead == 0);
+            }
+            
+            if(EndOfFile)
+            {
+                // NOTE(chuck): Anything the decoder peeks at past the end of the file reads as zero,
+                // and the size check below catches instructions that would need those bytes.
+                memset(Window.Memory + Filled, 0, WindowSize - Filled);
+            }
+        }
+        
+        u32 Count = Filled - Offset;
+        if(Count == 0)
+        {
+            break;
+        }
+        
+        instruction Instruction = DecodeInstruction(Dispatch, AtWindowOffset(Window, Offset));
+        if(Instruction.Op)
+        {
+            u8 *Bytes = Window.Memory + Offset;
+            Instruction.Address = WindowFileOffset + Offset;
+            if(Count >= Instruction.Size)
+            {
+                Offset += Instruction.Size;
+            }
+            else
+            {
+                FlushText(Output);
                 fprintf(stderr, "ERROR: Instruction extends outside disassembly region\n");
                 break;
             }
             
-            PrintInstruction(Instruction, stdout);
-            printf("\n");
+            FormatDisAsmLine(Format, Instruction, Bytes, Output);
         }
         else
         {
+            FlushText(Output);
             fprintf(stderr, "ERROR: Unrecognized binary in instruction stream.\n");
             break;
         }
     }
 }
 
+enum disasm_stop : u32
+{
+    DisAsmStop_None,
+    DisAsmStop_Unrecognized,
+    DisAsmStop_Truncated,
+};
+
+static disasm_stop DecodeForDisAsm(instruction_dispatch *Dispatch, u8 *Data, u32 Offset, u32 DataSize,
+                                   u32 BaseAddress, instruction *Result)
+{
+    // NOTE(chuck): The caller guarantees that Data is readable (zero padded if need be) for the
+    // longest instruction past Offset, so the decode never needs to wrap.
+    disasm_stop Stop = DisAsmStop_None;
+    
+    *Result = DecodeInstruction(Dispatch, FixedMemoryPow2(20, Data + Offset));
+    if(!Result->Op)
+    {
+        Stop = DisAsmStop_Unrecognized;
+    }
+    else if((DataSize - Offset) < Result->Size)
+    {
+        Stop = DisAsmStop_Truncated;
+    }
+    else
+    {
+        Result->Address = BaseAddress + Offset;
+    }
+    
+    return Stop;
+}
+
+static void PrintDisAsmStop(disasm_stop Stop, text_buffer *Output)
+{
+    // NOTE(chuck): Get everything before the error out first, so that the two interleave properly.
+    FlushText(Output);
+    
+    if(Stop == DisAsmStop_Unrecognized)
+    {
+        fprintf(stderr, "ERROR: Unrecognized binary in instruction stream.\n");
+    }
+    else if(Stop == DisAsmStop_Truncated)
+    {
+        fprintf(stderr, "ERROR: Instruction extends outside disassembly region\n");
+    }
+}
+
+static b32 DisAsmOneInstruction(instruction_dispatch *Dispatch, u8 *Data, u32 *Offset, u32 DataSize,
+                                u32 BaseAddress, disasm_format Format, text_buffer *Output)
+{
+    instruction Instruction;
+    disasm_stop Stop = DecodeForDisAsm(Dispatch, Data, *Offset, DataSize, BaseAddress, &Instruction);
+    if(Stop == DisAsmStop_None)
+    {
+        FormatDisAsmLine(Format, Instruction, Data + *Offset, Output);
+        *Offset += Instruction.Size;
+    }
+    else
+    {
+        PrintDisAsmStop(Stop, Output);
+    }
+    
+    b32 Stopped = (Stop != DisAsmStop_None);
+    return Stopped;
+}
+
+struct disasm_chunk
+{
+    instruction_dispatch *Dispatch;
+    instruction_length_table *Lengths;
+    disasm_format Format;
+    u8 *Data;
+    u32 DataSize;
+    u32 BaseAddress; // NOTE(chuck): Where Data starts in the file
+    
+    u32 Start;
+    u32 Boundary;
+    u32 End;
+    
+    // NOTE(chuck): Each worker formats its own text. For every instruction it records where the
+    // instruction starts in the source and where its line ends in Text, so the stitcher can start
+    // copying text from any instruction.
+    u32 Capacity;
+    u32 *InstructionOffsets;
+    u32 *TextEnds;
+    text_buffer Text;
+    
+    u32 InstructionCount;
+    u32 StopOffset;
+    disasm_stop Stop;
+};
+
+static void DisAsmChunk(disasm_chunk *Chunk)
+{
+    Chunk->InstructionCount = 0;
+    Chunk->Stop = DisAsmStop_None;
+    Chunk->Text.Used = 0;
+    
+    // NOTE(chuck): Nothing before the boundary ever gets stitched in, so only the lengths matter
+    // there. Walking them is enough to get back in sync without decoding or formatting anything.
+    u32 Offset = Chunk->Start;
+    while((Offset < Chunk->Boundary) && (Offset < Chunk->DataSize))
+    {
+        u32 Length = GetInstructionLength(Chunk->Lengths, Chunk->Data + Offset);
+        if(!Length)
+        {
+            break;
+        }
+        Offset += Length;
+    }
+    
+    // NOTE(chuck): If the text buffer fills up, the worker just stops early. The stitcher treats
+    // that like any other place the worker's results run out and decodes the rest itself.
+    while((Offset < Chunk->End) && (Offset < Chunk->DataSize) &&
+          (Chunk->InstructionCount < Chunk->Capacity) &&
+          ReserveText(&Chunk->Text, MaxInstructionTextLength + 1))
+    {
+        instruction Instruction;
+        Chunk->Stop = DecodeForDisAsm(Chunk->Dispatch, Chunk->Data, Offset, Chunk->DataSize,
+                                      Chunk->BaseAddress, &Instruction);
+        if(Chunk->Stop != DisAsmStop_None)
+        {
+            break;
+        }
+        
+        FormatDisAsmLine(Chunk->Format, Instruction, Chunk->Data + Offset, &Chunk->Text);
+        
+        Chunk->InstructionOffsets[Chunk->InstructionCount] = Offset;
+        Chunk->TextEnds[Chunk->InstructionCount] = Chunk->Text.Used;
+        ++Chunk->InstructionCount;
+        
+        Offset += Instruction.Size;
+    }
+    
+    Chunk->StopOffset = Offset;
+}
+
+/* NOTE(chuck): Parallel disassembly reads the file in batches of one chunk per thread. Every
+   worker but the first starts a little before its chunk boundary, walks instruction lengths up to
+   the boundary, and decodes from there until it has reached the end of its chunk, so its instruction boundaries overlap the start of the next
+   chunk's. The main thread then stitches the chunks together in order, starting from offset 0
+   which is always a real boundary. Whenever the stitched position lands on a boundary a worker
+   also found, every instruction after it in that worker is exactly what a sequential decode
+   would have produced, so the rest of the worker's results are taken as-is. If it lands between
+   a worker's boundaries (the worker started in the middle of an instruction and hasn't resynced
+   yet), the main thread decodes by itself until the two agree. This makes the output identical
+   to the sequential run, no matter where the chunk boundaries fall.
+*/
+static u32 const DisAsmChunkSize = 256*1024;
+static u32 const DisAsmResyncBytes = 64;
+
+// NOTE(chuck): Roughly the most text one source byte turns into, which is a lot more for structured output.
+static u32 GetDisAsmTextBytesPerSourceByte(disasm_format Format)
+{
+    u32 Result = 0;
+    switch(Format)
+    {
+        case DisAsmFormat_ASM: {Result = 8;} break;
+        case DisAsmFormat_CSV: {Result = 32;} break;
+        case DisAsmFormat_JSONL: {Result = 96;} break;
+    }
+    return Result;
+}
+
+static void FreeDisAsmChunks(disasm_chunk *Chunks, u32 ThreadCount)
+{
+    if(Chunks)
+    {
+        for(u32 ChunkIndex = 0; ChunkIndex < ThreadCount; ++ChunkIndex)
+        {
+            free(Chunks[ChunkIndex].InstructionOffsets);
+            free(Chunks[ChunkIndex].TextEnds);
+            free(Chunks[ChunkIndex].Text.Base);
+        }
+        free(Chunks);
+    }
+}
+
+static disasm_chunk *AllocateDisAsmChunks(u32 ThreadCount, u32 ChunkCapacity, u32 ChunkTextSize)
+{
+    disasm_chunk *Result = (disasm_chunk *)calloc(ThreadCount, sizeof(disasm_chunk));
+    for(u32 ChunkIndex = 0; Result && (ChunkIndex < ThreadCount); ++ChunkIndex)
+    {
+        disasm_chunk *Chunk = Result + ChunkIndex;
+        Chunk->Capacity = ChunkCapacity;
+        Chunk->InstructionOffsets = (u32 *)malloc(ChunkCapacity*sizeof(u32));
+        Chunk->TextEnds = (u32 *)malloc(ChunkCapacity*sizeof(u32));
+        Chunk->Text = TextBuffer((u8 *)malloc(ChunkTextSize), ChunkTextSize);
+        if(!Chunk->InstructionOffsets || !Chunk->TextEnds || !Chunk->Text.Base)
+        {
+            FreeDisAsmChunks(Result, ThreadCount);
+            Result = 0;
+        }
+    }
+    
+    return Result;
+}
+
+/* NOTE(chuck): Returns false without reading anything from the file if there isn't memory for even
+   one worker, so the caller can disassemble it some other way. With less memory than the thread
+   count wants, it halves the thread count until everything fits. */
+static b32 ParallelDisAsm8086(FILE *File, u32 ThreadCount, disasm_format Format, text_buffer *Output)
+{
+    instruction_dispatch *Dispatch = Get8086InstructionDispatch();
+    instruction_length_table *Lengths = Get8086InstructionLengthTable();
+    u32 Lookahead = 2*Dispatch->Table.MaxInstructionByteCount;
+    
+    u32 ChunkCapacity = DisAsmChunkSize + DisAsmResyncBytes + Lookahead;
+    u32 ChunkTextSize = DisAsmChunkSize*GetDisAsmTextBytesPerSourceByte(Format);
+    
+    u8 *Buffer = 0;
+    disasm_chunk *Chunks = 0;
+    std::thread *Threads = 0;
+    while(ThreadCount)
+    {
+        Buffer = (u8 *)malloc(ThreadCount*DisAsmChunkSize + 2*Lookahead);
+        Chunks = AllocateDisAsmChunks(ThreadCount, ChunkCapacity, ChunkTextSize);
+        Threads = new(std::nothrow) std::thread[ThreadCount];
+        if(Buffer && Chunks && Threads)
+        {
+            break;
+        }
+        
+        free(Buffer);
+        FreeDisAsmChunks(Chunks, ThreadCount);
+        delete [] Threads;
+        ThreadCount /= 2;
+    }
+    
+    b32 Result = (ThreadCount != 0);
+    if(Result)
+    {
+        u32 BatchSize = ThreadCount*DisAsmChunkSize;
+            
+        u32 Filled = 0;
+        u32 BufferFileOffset = 0;
+        b32 EndOfFile = false;
+        b32 Stopped = false;
+        while(!Stopped)
+        {
+            while(!EndOfFile && (Filled < (BatchSize + Lookahead)))
+            {
+                size_t BytesRead = fread(Buffer + Filled, 1, (BatchSize + Lookahead) - Filled, File);
+                Filled += (u32)BytesRead;
+                EndOfFile = (BytesRead == 0);
+            }
+            memset(Buffer + Filled, 0, Lookahead);
+            
+            // NOTE(chuck): Unless this is the end of the file, only instructions that start before Limit
+            // are decoded in this batch, so that all of their bytes are guaranteed to be in the buffer.
+            u32 Limit = EndOfFile ? Filled : (Filled - Lookahead);
+            if(Limit == 0)
+            {
+                break;
+            }
+            
+            for(u32 ChunkIndex = 0; ChunkIndex < ThreadCount; ++ChunkIndex)
+            {
+                disasm_chunk *Chunk = Chunks + ChunkIndex;
+                u32 Boundary = (u32)(((u64)Limit*ChunkIndex) / ThreadCount);
+                
+                Chunk->Dispatch = Dispatch;
+                Chunk->Lengths = Lengths;
+                Chunk->Format = Format;
+                Chunk->Data = Buffer;
+                Chunk->DataSize = Filled;
+                Chunk->BaseAddress = BufferFileOffset;
+                Chunk->Start = (Boundary > DisAsmResyncBytes) ? (Boundary - DisAsmResyncBytes) : 0;
+                Chunk->Boundary = Boundary;
+                Chunk->End = (u32)(((u64)Limit*(ChunkIndex + 1)) / ThreadCount);
+                Threads[ChunkIndex] = std::thread(DisAsmChunk, Chunk);
+            }
+            
+            for(u32 ChunkIndex = 0; ChunkIndex < ThreadCount; ++ChunkIndex)
+            {
+                Threads[ChunkIndex].join();
+            }
+            
+            u32 Offset = 0;
+            for(u32 ChunkIndex = 0; !Stopped && (ChunkIndex < ThreadCount); ++ChunkIndex)
+            {
+                disasm_chunk *Chunk = Chunks + ChunkIndex;
+                u32 InstructionIndex = 0;
+                while(!Stopped && (Offset < Chunk->StopOffset))
+                {
+                    while((InstructionIndex < Chunk->InstructionCount) &&
+                          (Chunk->InstructionOffsets[InstructionIndex] < Offset))
+                    {
+                        ++InstructionIndex;
+                    }
+                    
+                    if((InstructionIndex < Chunk->InstructionCount) &&
+                       (Chunk->InstructionOffsets[InstructionIndex] == Offset))
+                    {
+                        u32 TextStart = InstructionIndex ? Chunk->TextEnds[InstructionIndex - 1] : 0;
+                        AppendText(Output, (char *)Chunk->Text.Base + TextStart, Chunk->Text.Used - TextStart);
+                        
+                        Offset = Chunk->StopOffset;
+                        if(Chunk->Stop != DisAsmStop_None)
+                        {
+                            PrintDisAsmStop(Chunk->Stop, Output);
+                            Stopped = true;
+                        }
+                    }
+                    else
+                    {
+                        Stopped = DisAsmOneInstruction(Dispatch, Buffer, &Offset, Filled, BufferFileOffset, Format, Output);
+                    }
+                }
+            }
+            
+            // NOTE(chuck): If the last worker stopped before it got back in sync, finish the batch here.
+            while(!Stopped && (Offset < Limit))
+            {
+                Stopped = DisAsmOneInstruction(Dispatch, Buffer, &Offset, Filled, BufferFileOffset, Format, Output);
+            }
+            
+            if(EndOfFile)
+            {
+                break;
+            }
+            
+            // NOTE(chuck): The last chunk always runs to Limit or past it, so the stitched offset is
+            // where the next batch starts. Slide the leftover bytes down to the front.
+            assert(Stopped || (Offset >= Limit));
+            memmove(Buffer, Buffer + Offset, Filled - Offset);
+            Filled -= Offset;
+            BufferFileOffset += Offset;
+        }
+            
+        delete [] Threads;
+        FreeDisAsmChunks(Chunks, ThreadCount);
+        free(Buffer);
+    }
+    
+    return Result;
+}
+
+static void PrintDisAsmHeader(char *FileName, disasm_format Format, b32 *WroteCSVHeader, text_buffer *Output)
+{
+    if(Format == DisAsmFormat_ASM)
+    {
+        AppendText(Output, "; ", 2);
+        AppendText(Output, FileName);
+        AppendText(Output, " disassembly:\n");
+        AppendText(Output, "bits 16\n");
+    }
+    else if((Format == DisAsmFormat_CSV) && !*WroteCSVHeader)
+    {
+        // NOTE(chuck): Rows from every file go in one table, so the column names only go out once.
+        FormatCSVHeader(Output);
+        *WroteCSVHeader = true;
+    }
+}
+
 int main(int ArgCount, char **Args)
 {
     segmented_access MainMemory = AllocateMemoryPow2(20);
@@ -119,19 +648,97 @@ int main(int ArgCount, char **Args)
     {
         if(ArgCount > 1)
         {
+            // NOTE(chuck): All disassembly text goes through here, and only hits stdout in big blocks.
+            u32 OutputSize = 1024*1024;
+            text_buffer Output = TextBuffer((u8 *)malloc(OutputSize), OutputSize, stdout);
+            if(!Output.Base)
+            {
+                // NOTE(chuck): A buffer with no memory writes everything straight through, just more slowly.
+                fprintf(stderr, "WARNING: Unable to allocate output buffer, writing unbuffered.\n");
+            }
+            
+            b32 Stream = false;
+            b32 UseLabels = false;
+            disasm_format Format = DisAsmFormat_ASM;
+            b32 WroteCSVHeader = false;
+            u32 ThreadCount = 0;
             for(int ArgIndex = 1; ArgIndex < ArgCount; ++ArgIndex)
             {
                 char *FileName = Args[ArgIndex];
-                u32 BytesRead = LoadMemoryFromFile(FileName, MainMemory, 0);
-                
-                printf("; %s disassembly:\n", FileName);
-                printf("bits 16\n");
-                DisAsm8086(BytesRead, MainMemory);
+                if(strcmp(FileName, "-stream") == 0)
+                {
+                    Stream = true;
+                }
+                else if(strcmp(FileName, "--format=asm") == 0)
+                {
+                    Format = DisAsmFormat_ASM;
+                }
+                else if(strcmp(FileName, "--format=jsonl") == 0)
+                {
+                    Format = DisAsmFormat_JSONL;
+                }
+                else if(strcmp(FileName, "--format=csv") == 0)
+                {
+                    Format = DisAsmFormat_CSV;
+                }
+                else if(strcmp(FileName, "-labels") == 0)
+                {
+                    UseLabels = true;
+                }
+                else if(strcmp(FileName, "-parallel") == 0)
+                {
+                    ThreadCount = std::thread::hardware_concurrency();
+                    if(ThreadCount == 0)
+                    {
+                        ThreadCount = 1;
+                    }
+                }
+                else if(Stream || ThreadCount)
+                {
+                    // NOTE(chuck): In stream mode, main memory is just a sliding window over the file,
+                    // so files of any size disassemble without being cut off at 1mb.
+                    FILE *File = fopen(FileName, "rb");
+                    if(File)
+                    {
+                        PrintDisAsmHeader(FileName, Format, &WroteCSVHeader, &Output);
+                        b32 Done = false;
+                        if(ThreadCount)
+                        {
+                            Done = ParallelDisAsm8086(File, ThreadCount, Format, &Output);
+                            if(!Done)
+                            {
+                                FlushText(&Output);
+                                fprintf(stderr, "ERROR: Unable to allocate parallel disassembly memory, streaming instead.\n");
+                            }
+                        }
+                        
+                        if(!Done)
+                        {
+                            StreamDisAsm8086(File, MainMemory, Format, &Output);
+                        }
+                        fclose(File);
+                    }
+                    else
+                    {
+                        FlushText(&Output);
+                        fprintf(stderr, "ERROR: Unable to open %s.\n", FileName);
+                    }
+                }
+                else
+                {
+                    FlushText(&Output);
+                    u32 BytesRead = LoadMemoryFromFile(FileName, MainMemory, 0);
+                    
+                    PrintDisAsmHeader(FileName, Format, &WroteCSVHeader, &Output);
+                    DisAsm8086(BytesRead, MainMemory, Format, &Output, UseLabels);
+                }
             }
+            
+            FlushText(&Output);
         }
         else
         {
-            fprintf(stderr, "USAGE: %s [8086 machine code file] ...\n", Args[0]);
+            fprintf(stderr, "USAGE: %s [--format=asm|jsonl|csv] [-labels] [-stream] [-parallel] [8086 machine code file] ...\n", Args[0]);
         }
     }
     else
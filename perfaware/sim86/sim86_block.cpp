@@ -0,0 +1,513 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+static b32 IsCodeByte(block_cache *Cache, u32 Address)
+{
+    b32 Result = ((Cache->CodeMap[Address >> 3] & (1 << (Address & 7))) != 0);
+    return Result;
+}
+
+// NOTE(chuck): Register writes come through here too, and they never land inside memory.
+static void NoteMemoryWrite(machine *Machine, u8 *Byte)
+{
+    size_t Offset = (size_t)Byte - (size_t)Machine->Memory.Memory;
+    if((Offset <= Machine->Memory.Mask) && IsCodeByte(Machine->Blocks, (u32)Offset))
+    {
+        Machine->Blocks->CodeWritten = true;
+    }
+}
+
+static void FlushBlocks(block_cache *Cache)
+{
+    memset(Cache->Buckets, 0, sizeof(Cache->Buckets));
+    memset(Cache->CodeMap, 0, sizeof(Cache->CodeMap));
+    Cache->BlockCount = 0;
+    Cache->OpCount = 0;
+    Cache->CodeWritten = false;
+    Cache->JitUsed = 0;
+}
+
+static code_block **GetBucket(block_cache *Cache, u32 Address)
+{
+    u32 Hash = (Address ^ (Address >> 12)) & (ArrayCount(Cache->Buckets) - 1);
+    code_block **Result = &Cache->Buckets[Hash];
+    return Result;
+}
+
+static code_block *FindBlock(block_cache *Cache, u32 Address)
+{
+    code_block *Result = *GetBucket(Cache, Address);
+    while(Result && (Result->Address != Address))
+    {
+        Result = Result->NextInBucket;
+    }
+    return Result;
+}
+
+static void AdvanceIP(machine *Machine, threaded_op *Op)
+{
+    Machine->Registers[Register_ip] += (u16)Op->Instruction.Size;
+}
+
+static u32 GetSourceValue(threaded_op *Op)
+{
+    u32 Result = Op->Source.Low ? ReadLocation(Op->Source, Op->Wide) : Op->Immediate;
+    return Result;
+}
+
+static machine_status ExecuteGeneric(machine *Machine, threaded_op *Op)
+{
+    u16 IP = Machine->Registers[Register_ip];
+    AdvanceIP(Machine, Op);
+    machine_status Result = ExecuteInstruction(Machine, &Op->Instruction);
+    if(Result == Machine_Unimplemented)
+    {
+        Machine->Registers[Register_ip] = IP;
+    }
+    return Result;
+}
+
+static machine_status ExecuteMov(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    WriteLocation(Machine, Op->Dest, Op->Wide, GetSourceValue(Op));
+    return Machine_Running;
+}
+
+static machine_status ExecuteAdd(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    u32 Value = AddWithFlags(Machine, ReadLocation(Op->Dest, Op->Wide), GetSourceValue(Op), 0, Op->Wide);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+static machine_status ExecuteSub(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    u32 Value = SubtractWithFlags(Machine, ReadLocation(Op->Dest, Op->Wide), GetSourceValue(Op), 0, Op->Wide);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+static machine_status ExecuteCmp(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    SubtractWithFlags(Machine, ReadLocation(Op->Dest, Op->Wide), GetSourceValue(Op), 0, Op->Wide);
+    return Machine_Running;
+}
+
+static machine_status ExecuteAnd(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    u32 Value = ReadLocation(Op->Dest, Op->Wide) & GetSourceValue(Op);
+    SetLogicFlags(Machine, Value, Op->Wide);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+static machine_status ExecuteTest(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    SetLogicFlags(Machine, ReadLocation(Op->Dest, Op->Wide) & GetSourceValue(Op), Op->Wide);
+    return Machine_Running;
+}
+
+static machine_status ExecuteOr(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    u32 Value = ReadLocation(Op->Dest, Op->Wide) | GetSourceValue(Op);
+    SetLogicFlags(Machine, Value, Op->Wide);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+static machine_status ExecuteXor(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    u32 Value = ReadLocation(Op->Dest, Op->Wide) ^ GetSourceValue(Op);
+    SetLogicFlags(Machine, Value, Op->Wide);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+// NOTE(chuck): inc and dec leave carry alone.
+static machine_status ExecuteInc(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    b32 Carry = IsSet(Machine, Flag_Carry);
+    u32 Value = AddWithFlags(Machine, ReadLocation(Op->Dest, Op->Wide), 1, 0, Op->Wide);
+    SetFlag(Machine, Flag_Carry, Carry);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+static machine_status ExecuteDec(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    b32 Carry = IsSet(Machine, Flag_Carry);
+    u32 Value = SubtractWithFlags(Machine, ReadLocation(Op->Dest, Op->Wide), 1, 0, Op->Wide);
+    SetFlag(Machine, Flag_Carry, Carry);
+    WriteLocation(Machine, Op->Dest, Op->Wide, Value);
+    return Machine_Running;
+}
+
+static machine_status ExecuteJump(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    Machine->Registers[Register_ip] += (u16)Op->Immediate;
+    return Machine_Running;
+}
+
+static machine_status ExecuteConditionalJump(machine *Machine, threaded_op *Op)
+{
+    AdvanceIP(Machine, Op);
+    if(ShouldJump(Machine, Op->Instruction.Op))
+    {
+        Machine->Registers[Register_ip] += (u16)Op->Immediate;
+    }
+    return Machine_Running;
+}
+
+static b32 IsRegisterOrImmediate(instruction_operand *Operand)
+{
+    b32 Result = ((Operand->Type == Operand_Register) || (Operand->Type == Operand_Immediate));
+    return Result;
+}
+
+/* NOTE(chuck): Picks the handler for a decoded instruction. Only register and immediate operands
+   get handlers of their own, since those can be resolved once and for all here. Anything that
+   touches memory needs its effective address worked out each time, and goes through
+   ExecuteInstruction. */
+static threaded_op CompileOp(machine *Machine, instruction Instruction)
+{
+    threaded_op Result = {};
+    Result.Handler = ExecuteGeneric;
+    Result.Wide = IsWide(&Instruction);
+    Result.Instruction = Instruction;
+
+    instruction_operand *Dest = &Instruction.Operands[0];
+    instruction_operand *Source = &Instruction.Operands[1];
+    if((Dest->Type == Operand_Register) && IsRegisterOrImmediate(Source))
+    {
+        Result.Dest = GetRegisterLocation(Machine, Dest->Register);
+        if(Source->Type == Operand_Register)
+        {
+            Result.Source = GetRegisterLocation(Machine, Source->Register);
+        }
+        else
+        {
+            Result.Immediate = (u32)Source->Immediate.Value & (Result.Wide ? 0xffff : 0xff);
+        }
+
+        switch(Instruction.Op)
+        {
+            case Op_mov: {Result.Handler = ExecuteMov;} break;
+            case Op_add: {Result.Handler = ExecuteAdd;} break;
+            case Op_sub: {Result.Handler = ExecuteSub;} break;
+            case Op_cmp: {Result.Handler = ExecuteCmp;} break;
+            case Op_and: {Result.Handler = ExecuteAnd;} break;
+            case Op_test: {Result.Handler = ExecuteTest;} break;
+            case Op_or: {Result.Handler = ExecuteOr;} break;
+            case Op_xor: {Result.Handler = ExecuteXor;} break;
+            default: {} break;
+        }
+
+        // NOTE(chuck): A write to cs has to end the block, which only the generic path knows to do.
+        if(Dest->Register.Index == Register_cs)
+        {
+            Result.Handler = ExecuteGeneric;
+        }
+    }
+    else if(((Instruction.Op == Op_inc) || (Instruction.Op == Op_dec)) &&
+            (GetSingleOperand(&Instruction)->Type == Operand_Register))
+    {
+        Result.Dest = GetRegisterLocation(Machine, GetSingleOperand(&Instruction)->Register);
+        Result.Handler = (Instruction.Op == Op_inc) ? ExecuteInc : ExecuteDec;
+    }
+    else if(Dest->Type == Operand_Immediate)
+    {
+        Result.Immediate = (u32)Dest->Immediate.Value;
+        switch(Instruction.Op)
+        {
+            case Op_jmp:
+            {
+                if(!(Instruction.Flags & Inst_Far))
+                {
+                    Result.Handler = ExecuteJump;
+                }
+            } break;
+
+            case Op_je:
+            case Op_jl:
+            case Op_jle:
+            case Op_jb:
+            case Op_jbe:
+            case Op_jp:
+            case Op_jo:
+            case Op_js:
+            case Op_jne:
+            case Op_jnl:
+            case Op_jg:
+            case Op_jnb:
+            case Op_ja:
+            case Op_jnp:
+            case Op_jno:
+            case Op_jns:
+            case Op_loop:
+            case Op_loopz:
+            case Op_loopnz:
+            case Op_jcxz:
+            {
+                Result.Handler = ExecuteConditionalJump;
+            } break;
+
+            default: {} break;
+        }
+    }
+
+    return Result;
+}
+
+/* NOTE(chuck): Anything that can leave CS:IP somewhere other than the next instruction ends a block.
+   That includes div and idiv, which go through interrupt 0 when they fail, and anything that writes
+   cs. */
+static b32 EndsBlock(instruction *Instruction)
+{
+    b32 Result = false;
+    switch(Instruction->Op)
+    {
+        case Op_call:
+        case Op_jmp:
+        case Op_ret:
+        case Op_retf:
+        case Op_je:
+        case Op_jl:
+        case Op_jle:
+        case Op_jb:
+        case Op_jbe:
+        case Op_jp:
+        case Op_jo:
+        case Op_js:
+        case Op_jne:
+        case Op_jnl:
+        case Op_jg:
+        case Op_jnb:
+        case Op_ja:
+        case Op_jnp:
+        case Op_jno:
+        case Op_jns:
+        case Op_loop:
+        case Op_loopz:
+        case Op_loopnz:
+        case Op_jcxz:
+        case Op_int:
+        case Op_int3:
+        case Op_into:
+        case Op_iret:
+        case Op_div:
+        case Op_idiv:
+        case Op_hlt:
+        {
+            Result = true;
+        } break;
+
+        default:
+        {
+            instruction_operand *Dest = GetSingleOperand(Instruction);
+            Result = ((Dest->Type == Operand_Register) && (Dest->Register.Index == Register_cs));
+        } break;
+    }
+
+    return Result;
+}
+
+static b32 HasRoomForBlock(block_cache *Cache)
+{
+    b32 Result = ((Cache->BlockCount < ArrayCount(Cache->Blocks)) &&
+                  ((ArrayCount(Cache->Ops) - Cache->OpCount) >= MAX_BLOCK_OPS));
+    return Result;
+}
+
+// NOTE(chuck): Returns null when the instruction at CS:IP doesn't decode, so there is no block to run.
+static code_block *BuildBlock(machine *Machine, block_cache *Cache, u32 Address)
+{
+    assert(HasRoomForBlock(Cache));
+
+    code_block *Block = &Cache->Blocks[Cache->BlockCount];
+    *Block = {};
+    Block->Address = Address;
+    Block->Ops = &Cache->Ops[Cache->OpCount];
+
+    segmented_access At = Machine->Memory;
+    At.SegmentBase = Machine->Registers[Register_cs];
+    At.SegmentOffset = Machine->Registers[Register_ip];
+    while(Block->OpCount < MAX_BLOCK_OPS)
+    {
+        instruction Instruction = DecodeInstruction(Machine->Dispatch, At);
+        if(!Instruction.Op || ((At.SegmentOffset + Instruction.Size) > 0x10000))
+        {
+            break;
+        }
+
+        Block->Ops[Block->OpCount++] = CompileOp(Machine, Instruction);
+        for(u32 ByteIndex = 0; ByteIndex < Instruction.Size; ++ByteIndex)
+        {
+            u32 ByteAddress = GetAbsoluteAddressOf(At, (u16)ByteIndex);
+            Cache->CodeMap[ByteAddress >> 3] |= (u8)(1 << (ByteAddress & 7));
+        }
+
+        At.SegmentOffset += (u16)Instruction.Size;
+        Block->ByteCount += Instruction.Size;
+        if(EndsBlock(&Instruction))
+        {
+            break;
+        }
+    }
+
+    code_block *Result = 0;
+    if(Block->OpCount)
+    {
+        code_block **Bucket = GetBucket(Cache, Address);
+        Block->NextInBucket = *Bucket;
+        *Bucket = Block;
+
+        ++Cache->BlockCount;
+        Cache->OpCount += Block->OpCount;
+        Result = Block;
+    }
+
+    return Result;
+}
+
+/* NOTE(chuck): Same results as RunMachine without a callback, including the instruction count. A
+   block that has more instructions than are left to run is stepped through one instruction at a
+   time instead. */
+static u64 RunBlocks(machine *Machine, u64 MaxInstructionCount, machine_status *Status)
+{
+    block_cache *Cache = Machine->Blocks;
+    if(Cache->CodeWritten)
+    {
+        FlushBlocks(Cache);
+    }
+
+    machine_status Stop = Machine_Running;
+    u64 Count = 0;
+    code_block *Previous = 0;
+    while((Stop == Machine_Running) && (Count < MaxInstructionCount))
+    {
+        u32 Address = GetAbsoluteAddressOf(Machine->Memory.Mask, Machine->Registers[Register_cs],
+                                           Machine->Registers[Register_ip], 0);
+
+        code_block *Block = 0;
+        if(Previous)
+        {
+            if(Previous->Successors[0] && (Previous->Successors[0]->Address == Address))
+            {
+                Block = Previous->Successors[0];
+            }
+            else if(Previous->Successors[1] && (Previous->Successors[1]->Address == Address))
+            {
+                Block = Previous->Successors[1];
+            }
+        }
+
+        if(!Block)
+        {
+            Block = FindBlock(Cache, Address);
+            if(!Block)
+            {
+                if(!HasRoomForBlock(Cache))
+                {
+                    FlushBlocks(Cache);
+                    Previous = 0;
+                }
+                Block = BuildBlock(Machine, Cache, Address);
+            }
+
+            if(Previous && Block)
+            {
+                Previous->Successors[Previous->NextSuccessor] = Block;
+                Previous->NextSuccessor ^= 1;
+            }
+        }
+
+        // NOTE(chuck): Entered through a CS:IP where IP would wrap partway through, so it gets stepped instead.
+        if(Block && ((Machine->Registers[Register_ip] + Block->ByteCount) > 0x10000))
+        {
+            Block = 0;
+        }
+
+        if(Block && Block->Compiled && (Block->OpCount <= (MaxInstructionCount - Count)))
+        {
+            // NOTE(chuck): Compiled code stops short of the end of the block when the next instruction would write to code.
+            u32 Executed = Block->Compiled(Machine);
+            Count += Executed;
+            if(Executed < Block->OpCount)
+            {
+                instruction Stepped;
+                Stop = StepMachine(Machine, &Stepped);
+                Count += (Stop == Machine_Running) || (Stop == Machine_Halted);
+            }
+
+            Previous = Block;
+        }
+        else if(Block && (Block->OpCount <= (MaxInstructionCount - Count)))
+        {
+            threaded_op *Op = Block->Ops;
+            threaded_op *End = Block->Ops + Block->OpCount;
+            while(Op < End)
+            {
+                Stop = Op->Handler(Machine, Op);
+                if(Stop != Machine_Running)
+                {
+                    Count += (Stop == Machine_Halted);
+                    break;
+                }
+
+                ++Count;
+                ++Op;
+                if(Cache->CodeWritten)
+                {
+                    break;
+                }
+            }
+
+            if((++Block->RunCount == COMPILE_AFTER_RUNS) && !Cache->CodeWritten)
+            {
+                Block->Compiled = CompileBlock(Machine, Cache, Block);
+            }
+
+            Previous = Block;
+        }
+        else
+        {
+            instruction Executed;
+            Stop = StepMachine(Machine, &Executed);
+            Count += (Stop == Machine_Running) || (Stop == Machine_Halted);
+            Previous = 0;
+        }
+
+        if(Cache->CodeWritten)
+        {
+            FlushBlocks(Cache);
+            Previous = 0;
+        }
+    }
+
+    if(Status)
+    {
+        *Status = Stop;
+    }
+
+    return Count;
+}
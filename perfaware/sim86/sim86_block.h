@@ -0,0 +1,88 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+/* NOTE(chuck): The block engine decodes a run of instructions once, up to and including the first
+   one that can change CS:IP, and keeps it as an array of threaded_ops. Each op has its handler and
+   operands worked out ahead of time (registers as pointers into the machine, immediates as values),
+   so running it again is a call through a function pointer with no decoding. Anything without a
+   handler of its own goes through ExecuteInstruction with the instruction that was decoded for it.
+
+   Blocks are keyed by the linear address of their first byte, but the same bytes can be reached
+   through any number of CS:IP pairs, and IP wraps at the end of the segment. A block is only run
+   when all of its bytes fit before the end of the segment it is entered from. Otherwise the machine
+   steps through those instructions one at a time, the same as it would without blocks. */
+
+struct threaded_op;
+typedef machine_status threaded_handler(machine *Machine, threaded_op *Op);
+
+// NOTE(chuck): Host code for a whole block. Returns how many of the block's instructions it ran.
+typedef u32 compiled_block(machine *Machine);
+
+struct threaded_op
+{
+    threaded_handler *Handler;
+
+    // NOTE(chuck): Source.Low is null when the source is an immediate, in which case it's in Immediate.
+    operand_location Dest;
+    operand_location Source;
+    u32 Immediate;
+    b32 Wide;
+
+    instruction Instruction;
+};
+
+struct code_block
+{
+    u32 Address;
+    u32 ByteCount;
+    u32 OpCount;
+    threaded_op *Ops;
+
+    code_block *NextInBucket;
+
+    /* NOTE(chuck): The blocks this one was last seen going to. A conditional branch has two places
+       it can go, so two is enough to skip the lookup on both sides of a loop. */
+    code_block *Successors[2];
+    u32 NextSuccessor;
+
+    // NOTE(chuck): Blocks that run often enough get compiled to host code (see sim86_jit.cpp).
+    u32 RunCount;
+    compiled_block *Compiled;
+};
+
+static u32 const MAX_BLOCK_OPS = 32;
+static u32 const COMPILE_AFTER_RUNS = 16;
+
+/* NOTE(chuck): Everything is allocated up front and thrown away all at once. When the cache fills
+   up, or the program writes to a byte that some block was decoded from, every block is dropped and
+   they get rebuilt from memory as they run again. */
+struct block_cache
+{
+    code_block *Buckets[4096];
+
+    u32 BlockCount;
+    code_block Blocks[4096];
+
+    u32 OpCount;
+    threaded_op Ops[16384];
+
+    // NOTE(chuck): One bit for every byte of the 1mb address space that a cached block was decoded from.
+    u8 CodeMap[(1 << 20) / 8];
+    b32 CodeWritten;
+
+    // NOTE(chuck): Null when the host can't run compiled code, in which case everything stays threaded.
+    u8 *JitCode;
+    u32 JitUsed;
+};
+
+static void NoteMemoryWrite(machine *Machine, u8 *Byte);
+static u64 RunBlocks(machine *Machine, u64 MaxInstructionCount, machine_status *Status);
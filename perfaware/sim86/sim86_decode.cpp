@@ -10,28 +10,6 @@
    
    ======================================================================== */
 
-enum register_mapping_8086
-{
-    Register_none,
-    
-    Register_a,
-    Register_b,
-    Register_c,
-    Register_d,
-    Register_sp,
-    Register_bp,
-    Register_si,
-    Register_di,
-    Register_es,
-    Register_cs,
-    Register_ss,
-    Register_ds,
-    Register_ip,
-    Register_flags,
-    
-    Register_count,
-};
-
 struct decode_context
 {
     u32 DefaultSegment;
@@ -60,6 +38,34 @@ static instruction_operand GetRegOperand(u32 IntelRegIndex, b32 Wide)
     return Result;
 }
 
+static instruction_operand GetModOperand(u32 Mod, u32 RM, b32 Wide, s16 Displacement)
+{
+    instruction_operand Result = {};
+    
+    if(Mod == 0b11)
+    {
+        Result = GetRegOperand(RM, Wide);
+    }
+    else
+    {
+        register_mapping_8086 IntelTerm0[8] = { Register_b,  Register_b, Register_bp, Register_bp, Register_si, Register_di, Register_bp, Register_b};
+        register_mapping_8086 IntelTerm1[8] = {Register_si, Register_di, Register_si, Register_di};
+        
+        u32 I = RM&0x7;
+        register_mapping_8086 Term0 = IntelTerm0[I];
+        register_mapping_8086 Term1 = IntelTerm1[I];
+        if((Mod == 0b00) && (RM == 0b110))
+        {
+            Term0 = {};
+            Term1 = {};
+        }
+        
+        Result = EffectiveAddressOperand(RegisterAccess(Term0, 0, 2), RegisterAccess(Term1, 0, 2), Displacement);
+    }
+    
+    return Result;
+}
+
 // NOTE(casey): ParseDataValue is not a real function, it's basically just a macro that is used in
 // TryParse. It should never be called otherwise, but that is not something you can do in C++.
 // In other languages it would be a "local function".
@@ -194,26 +200,7 @@ static instruction TryDecode(decode_context *Context, instruction_encoding *Inst
         
         if(Has[Bits_MOD])
         {
-            if(Mod == 0b11)
-            {
-                *ModOperand = GetRegOperand(RM, W || (Bits[Bits_RMRegAlwaysW]));
-            }
-            else
-            {
-                register_mapping_8086 IntelTerm0[8] = { Register_b,  Register_b, Register_bp, Register_bp, Register_si, Register_di, Register_bp, Register_b};
-                register_mapping_8086 IntelTerm1[8] = {Register_si, Register_di, Register_si, Register_di};
-                
-                u32 I = RM&0x7;
-                register_mapping_8086 Term0 = IntelTerm0[I];
-                register_mapping_8086 Term1 = IntelTerm1[I];
-                if((Mod == 0b00) && (RM == 0b110))
-                {
-                    Term0 = {};
-                    Term1 = {};
-                }
-                
-                *ModOperand = EffectiveAddressOperand(RegisterAccess(Term0, 0, 2), RegisterAccess(Term1, 0, 2), Displacement);
-            }
+            *ModOperand = GetModOperand(Mod, RM, W || (Bits[Bits_RMRegAlwaysW]), Displacement);
         }
         
         if(Has[Bits_Data] && Has[Bits_Disp] && !Has[Bits_MOD])
@@ -259,13 +246,385 @@ static instruction TryDecode(decode_context *Context, instruction_encoding *Inst
     return Dest;
 }
 
-static instruction DecodeInstruction(instruction_table Table, segmented_access At)
+static constexpr encoding_layout GetEncodingLayout(instruction_encoding Inst)
+{
+    encoding_layout Result = {};
+    Result.Op = Inst.Op;
+    
+    u32 BitOffset = 0;
+    for(u32 BitsIndex = 0; BitsIndex < ArrayCount(Inst.Bits); ++BitsIndex)
+    {
+        instruction_bits TestBits = Inst.Bits[BitsIndex];
+        if(TestBits.Usage == Bits_End)
+        {
+            break;
+        }
+        
+        encoding_field &Field = Result.Fields[TestBits.Usage];
+        if(TestBits.BitCount != 0)
+        {
+            // NOTE(chuck): Same bit order as TryDecode: fields are read from the top of each byte down.
+            u32 ByteIndex = BitOffset / 8;
+            u8 Shift = (u8)(8 - (BitOffset % 8) - TestBits.BitCount);
+            u8 Mask = (u8)((1 << TestBits.BitCount) - 1);
+            if(TestBits.Usage == Bits_Literal)
+            {
+                Result.LiteralMask[ByteIndex] |= (u8)(Mask << Shift);
+                Result.LiteralValue[ByteIndex] |= (u8)(TestBits.Value << Shift);
+            }
+            else
+            {
+                encoding_field_piece &Piece = Field.Pieces[Field.PieceCount++];
+                Piece.ByteIndex = (u8)ByteIndex;
+                Piece.Shift = Shift;
+                Piece.Mask = Mask;
+                Piece.DestShift = TestBits.Shift;
+            }
+            
+            BitOffset += TestBits.BitCount;
+        }
+        else
+        {
+            Field.ImplicitValue |= (TestBits.Value << TestBits.Shift);
+        }
+        
+        Field.Has = true;
+    }
+    
+    Result.ByteCount = (BitOffset + 7) / 8;
+    
+    return Result;
+}
+
+static u32 GetEncodingField(encoding_field Field, u8 *Bytes)
+{
+    u32 Result = Field.ImplicitValue;
+    for(u32 PieceIndex = 0; PieceIndex < Field.PieceCount; ++PieceIndex)
+    {
+        encoding_field_piece Piece = Field.Pieces[PieceIndex];
+        Result |= ((Bytes[Piece.ByteIndex] >> Piece.Shift) & Piece.Mask) << Piece.DestShift;
+    }
+    
+    return Result;
+}
+
+/* NOTE(chuck): This is TryDecode specialized to a single entry of InstructionTable8086. The layout is
+   computed by the compiler, so every literal mask, field position and "does this encoding have X"
+   test below is a constant in each instantiation, and the optimizer folds away everything that
+   doesn't apply. If you change what TryDecode produces, change it here too. */
+template<u32 EncodingIndex>
+static instruction DecodeEncoding8086(decode_context *Context, segmented_access At)
+{
+    constexpr encoding_layout Layout = GetEncodingLayout(InstructionTable8086Constant[EncodingIndex]);
+    static_assert(Layout.ByteCount <= ArrayCount(Layout.LiteralMask), "8086 encodings never have literal bits past the second byte");
+    
+    instruction Dest = {};
+    
+    u32 StartingAddress = GetAbsoluteAddressOf(At);
+    u8 Bytes[2] = {*AccessMemory(At, 0), *AccessMemory(At, 1)};
+    if(((Bytes[0] & Layout.LiteralMask[0]) == Layout.LiteralValue[0]) &&
+       ((Bytes[1] & Layout.LiteralMask[1]) == Layout.LiteralValue[1]))
+    {
+        At.SegmentOffset += Layout.ByteCount;
+        
+        u32 Mod = GetEncodingField(Layout.Fields[Bits_MOD], Bytes);
+        u32 RM = GetEncodingField(Layout.Fields[Bits_RM], Bytes);
+        u32 W = GetEncodingField(Layout.Fields[Bits_W], Bytes);
+        b32 S = GetEncodingField(Layout.Fields[Bits_S], Bytes);
+        b32 D = GetEncodingField(Layout.Fields[Bits_D], Bytes);
+        
+        b32 HasDirectAddress = ((Mod == 0b00) && (RM == 0b110));
+        b32 HasDisp = ((Layout.Fields[Bits_Disp].Has) || (Mod == 0b10) || (Mod == 0b01) || HasDirectAddress);
+        
+        b32 DisplacementIsW = ((Layout.Fields[Bits_DispAlwaysW].ImplicitValue) || (Mod == 0b10) || HasDirectAddress);
+        b32 DataIsW = ((Layout.Fields[Bits_WMakesDataW].ImplicitValue) && !S && W);
+        
+        u32 Disp = GetEncodingField(Layout.Fields[Bits_Disp], Bytes);
+        u32 Data = GetEncodingField(Layout.Fields[Bits_Data], Bytes);
+        Disp |= ParseDataValue(&At, HasDisp, DisplacementIsW, (!DisplacementIsW));
+        Data |= ParseDataValue(&At, Layout.Fields[Bits_Data].Has, DataIsW, S);
+        
+        Dest.Op = Layout.Op;
+        Dest.Flags = Context->AdditionalFlags;
+        Dest.Address = StartingAddress;
+        Dest.Size = GetAbsoluteAddressOf(At) - StartingAddress;
+        Dest.SegmentOverride = Context->DefaultSegment;
+        
+        if(W)
+        {
+            Dest.Flags |= Inst_Wide;
+        }
+        
+        if(Layout.Fields[Bits_Far].ImplicitValue)
+        {
+            Dest.Flags |= Inst_Far;
+        }
+        
+        s16 Displacement = (s16)Disp;
+        
+        instruction_operand *RegOperand = &Dest.Operands[D ? 0 : 1];
+        instruction_operand *ModOperand = &Dest.Operands[D ? 1 : 0];
+        
+        if(Layout.Fields[Bits_SR].Has)
+        {
+            *RegOperand = RegisterOperand(Register_es + (GetEncodingField(Layout.Fields[Bits_SR], Bytes) & 0x3), 2);
+        }
+        
+        if(Layout.Fields[Bits_REG].Has)
+        {
+            *RegOperand = GetRegOperand(GetEncodingField(Layout.Fields[Bits_REG], Bytes), W);
+        }
+        
+        if(Layout.Fields[Bits_MOD].Has)
+        {
+            *ModOperand = GetModOperand(Mod, RM, W || (Layout.Fields[Bits_RMRegAlwaysW].ImplicitValue), Displacement);
+        }
+        
+        if(Layout.Fields[Bits_Data].Has && HasDisp && !Layout.Fields[Bits_MOD].Has)
+        {
+            Dest.Operands[0] = IntersegmentAddressOperand(Data, Disp);
+        }
+        else
+        {
+            instruction_operand *LastOperand = &Dest.Operands[0];
+            if(LastOperand->Type)
+            {
+                LastOperand = &Dest.Operands[1];
+            }
+            
+            if(Layout.Fields[Bits_RelJMPDisp].ImplicitValue)
+            {
+                *LastOperand = ImmediateOperand(Displacement, Immediate_RelativeJumpDisplacement);
+            }
+            else if(Layout.Fields[Bits_Data].Has)
+            {
+                *LastOperand = ImmediateOperand(Data);
+            }
+            else if(Layout.Fields[Bits_V].Has)
+            {
+                if(GetEncodingField(Layout.Fields[Bits_V], Bytes))
+                {
+                    *LastOperand = RegisterOperand(Register_c, 1);
+                }
+                else
+                {
+                    *LastOperand = ImmediateOperand(1);
+                }
+            }
+        }
+    }
+    
+    return Dest;
+}
+
+// NOTE(chuck): Fills Dest[0..Count) with one DecodeEncoding8086 instantiation per table entry.
+template<u32 Count>
+struct encoding_decoder_list
+{
+    static void Fill(encoding_decoder **Dest)
+    {
+        encoding_decoder_list<Count - 1>::Fill(Dest);
+        Dest[Count - 1] = DecodeEncoding8086<Count - 1>;
+    }
+};
+
+template<>
+struct encoding_decoder_list<0>
+{
+    static void Fill(encoding_decoder **)
+    {
+    }
+};
+
+static instruction_dispatch BuildInstructionDispatch(instruction_table Table)
+{
+    instruction_dispatch Result = {};
+    Result.Table = Table;
+    
+    // NOTE(chuck): Slots store encoding indices as bytes.
+    assert(Table.EncodingCount <= 256);
+    
+    for(u32 EncodingIndex = 0; EncodingIndex < Table.EncodingCount; ++EncodingIndex)
+    {
+        instruction_encoding *Inst = &Table.Encodings[EncodingIndex];
+        
+        // NOTE(chuck): Gather the literal bits that fall in the first two bytes. Those are the only
+        // bits the dispatch looks at, so an encoding lands in every slot its literals don't rule out,
+        // and TryDecode still does the full check on whatever is left.
+        u32 LiteralMask[2] = {};
+        u32 LiteralValue[2] = {};
+        u32 BitOffset = 0;
+        for(u32 BitsIndex = 0; BitsIndex < ArrayCount(Inst->Bits); ++BitsIndex)
+        {
+            instruction_bits TestBits = Inst->Bits[BitsIndex];
+            if(TestBits.Usage == Bits_End)
+            {
+                break;
+            }
+            
+            if(TestBits.BitCount != 0)
+            {
+                u32 ByteIndex = BitOffset / 8;
+                u32 Shift = 8 - (BitOffset % 8) - TestBits.BitCount;
+                if((TestBits.Usage == Bits_Literal) && (ByteIndex < ArrayCount(LiteralMask)))
+                {
+                    LiteralMask[ByteIndex] |= ((1 << TestBits.BitCount) - 1) << Shift;
+                    LiteralValue[ByteIndex] |= TestBits.Value << Shift;
+                }
+                
+                BitOffset += TestBits.BitCount;
+            }
+        }
+        
+        u32 RegMask = LiteralMask[1] & 0x38;
+        for(u32 FirstByte = 0; FirstByte < ArrayCount(Result.Slots); ++FirstByte)
+        {
+            if((FirstByte & LiteralMask[0]) == LiteralValue[0])
+            {
+                for(u32 Reg = 0; Reg < ArrayCount(Result.Slots[0]); ++Reg)
+                {
+                    if(((Reg << 3) & RegMask) == (LiteralValue[1] & RegMask))
+                    {
+                        instruction_dispatch_slot *Slot = &Result.Slots[FirstByte][Reg];
+                        
+                        // NOTE(chuck): If this assert fires, the table has more overlapping encodings
+                        // than a slot can hold, and the slot needs to get bigger.
+                        assert(Slot->EncodingCount < ArrayCount(Slot->EncodingIndex));
+                        Slot->EncodingIndex[Slot->EncodingCount++] = (u8)EncodingIndex;
+                    }
+                }
+            }
+        }
+    }
+    
+    return Result;
+}
+
+static instruction_dispatch Build8086InstructionDispatch()
+{
+    instruction_dispatch Result = BuildInstructionDispatch(Get8086InstructionTable());
+    
+    static_assert(ArrayCount(InstructionTable8086Constant) == ArrayCount(InstructionTable8086), "8086 tables out of sync");
+    static_assert(ArrayCount(InstructionTable8086Constant) <= ArrayCount(Result.Decoders), "Too many 8086 encodings for the dispatch");
+    encoding_decoder_list<ArrayCount(InstructionTable8086Constant)>::Fill(Result.Decoders);
+    
+    return Result;
+}
+
+static instruction_dispatch *Get8086InstructionDispatch()
+{
+    // NOTE(chuck): Built once, on first use. Function-local statics are initialized thread-safely.
+    static instruction_dispatch Dispatch = Build8086InstructionDispatch();
+    return &Dispatch;
+}
+
+static b32 FieldTouchesSecondByte(encoding_field Field)
+{
+    b32 Result = false;
+    for(u32 PieceIndex = 0; PieceIndex < Field.PieceCount; ++PieceIndex)
+    {
+        Result = Result || (Field.Pieces[PieceIndex].ByteIndex != 0);
+    }
+    
+    return Result;
+}
+
+static u32 GetDisplacementSize(b32 AlwaysHasDisp, b32 DispAlwaysW, u32 Mod, u32 RM)
 {
-    /* TODO(casey): Hmm. It seems like this is a very inefficient way to parse
-       instructions, isn't it? For every instruction, we check every entry in the
-       table until we find a match. Is this bad design? Or did the person who wrote
-       it know what they were doing, and has a plan for how it can be optimized
-       later? Only time will tell... :) */
+    // NOTE(chuck): Same rules as TryDecode.
+    b32 HasDirectAddress = ((Mod == 0b00) && (RM == 0b110));
+    b32 HasDisp = (AlwaysHasDisp || (Mod == 0b10) || (Mod == 0b01) || HasDirectAddress);
+    b32 DisplacementIsW = (DispAlwaysW || (Mod == 0b10) || HasDirectAddress);
+    
+    u32 Result = HasDisp ? (DisplacementIsW ? 2 : 1) : 0;
+    return Result;
+}
+
+static instruction_length_table BuildInstructionLengthTable(instruction_dispatch *Dispatch)
+{
+    instruction_length_table Result = {};
+    Result.MaxInstructionByteCount = Dispatch->Table.MaxInstructionByteCount;
+    
+    for(u32 Row = 0; Row < ArrayCount(Result.ModRMDisplacementSize); ++Row)
+    {
+        for(u32 ModRM = 0; ModRM < ArrayCount(Result.ModRMDisplacementSize[0]); ++ModRM)
+        {
+            Result.ModRMDisplacementSize[Row][ModRM] =
+                (u8)GetDisplacementSize(Row & 1, Row & 2, ModRM >> 6, ModRM & 0x7);
+        }
+    }
+    
+    for(u32 FirstByte = 0; FirstByte < ArrayCount(Result.Slots); ++FirstByte)
+    {
+        for(u32 Reg = 0; Reg < ArrayCount(Result.Slots[0]); ++Reg)
+        {
+            instruction_dispatch_slot DispatchSlot = Dispatch->Slots[FirstByte][Reg];
+            if(DispatchSlot.EncodingCount)
+            {
+                // NOTE(chuck): If this assert fires, two encodings now share a slot, and the length
+                // table needs to learn how to tell them apart by their second byte.
+                assert(DispatchSlot.EncodingCount == 1);
+                
+                encoding_layout Layout = GetEncodingLayout(Dispatch->Table.Encodings[DispatchSlot.EncodingIndex[0]]);
+                u8 Bytes[2] = {(u8)FirstByte, (u8)(Reg << 3)};
+                
+                // NOTE(chuck): The data size has to be settled by the first byte alone for BaseSize to
+                // work, and the displacement can only depend on a real ModRM byte.
+                assert(!FieldTouchesSecondByte(Layout.Fields[Bits_W]));
+                assert(!FieldTouchesSecondByte(Layout.Fields[Bits_S]));
+                assert(FieldTouchesSecondByte(Layout.Fields[Bits_RM]) == FieldTouchesSecondByte(Layout.Fields[Bits_MOD]));
+                
+                u32 W = GetEncodingField(Layout.Fields[Bits_W], Bytes);
+                b32 S = GetEncodingField(Layout.Fields[Bits_S], Bytes);
+                b32 DataIsW = ((Layout.Fields[Bits_WMakesDataW].ImplicitValue) && !S && W);
+                b32 AlwaysHasDisp = Layout.Fields[Bits_Disp].Has;
+                b32 DispAlwaysW = Layout.Fields[Bits_DispAlwaysW].ImplicitValue;
+                
+                instruction_length_slot *Slot = &Result.Slots[FirstByte][Reg];
+                Slot->Flags = Length_Valid;
+                Slot->SecondByteMask = Layout.LiteralMask[1];
+                Slot->SecondByteValue = Layout.LiteralValue[1];
+                
+                u32 Size = Layout.ByteCount;
+                if(Layout.Fields[Bits_Data].Has)
+                {
+                    Size += DataIsW ? 2 : 1;
+                }
+                
+                if(FieldTouchesSecondByte(Layout.Fields[Bits_MOD]))
+                {
+                    Slot->Flags |= Length_ModRM;
+                    Slot->DisplacementRow = (u8)((AlwaysHasDisp ? 1 : 0) | (DispAlwaysW ? 2 : 0));
+                }
+                else
+                {
+                    Size += GetDisplacementSize(AlwaysHasDisp, DispAlwaysW,
+                                                GetEncodingField(Layout.Fields[Bits_MOD], Bytes),
+                                                GetEncodingField(Layout.Fields[Bits_RM], Bytes));
+                }
+                
+                if((Layout.Op == Op_lock) || (Layout.Op == Op_rep) || (Layout.Op == Op_segment))
+                {
+                    Slot->Flags |= Length_Prefix;
+                }
+                
+                Slot->BaseSize = (u8)Size;
+            }
+        }
+    }
+    
+    return Result;
+}
+
+static instruction_length_table *Get8086InstructionLengthTable()
+{
+    static instruction_length_table LengthTable = BuildInstructionLengthTable(Get8086InstructionDispatch());
+    return &LengthTable;
+}
+
+static instruction DecodeInstruction(instruction_dispatch *Dispatch, segmented_access At)
+{
+    instruction_table Table = Dispatch->Table;
     
     decode_context Context = {};
     instruction Result = {};
@@ -275,10 +634,25 @@ static instruction DecodeInstruction(instruction_table Table, segmented_access A
     while(TotalSize < Table.MaxInstructionByteCount)
     {
         Result = {};
-        for(u32 Index = 0; Index < Table.EncodingCount; ++Index)
+        
+        // NOTE(chuck): Slots keep the table's order, so whichever encoding would have matched first
+        // in a scan of the whole table is still the one that matches first here.
+        u8 FirstByte = *AccessMemory(At, 0);
+        u8 Reg = (*AccessMemory(At, 1) >> 3) & 0x7;
+        instruction_dispatch_slot Slot = Dispatch->Slots[FirstByte][Reg];
+        for(u32 SlotIndex = 0; SlotIndex < Slot.EncodingCount; ++SlotIndex)
         {
-            instruction_encoding Inst = Table.Encodings[Index];
-            Result = TryDecode(&Context, &Inst, At);
+            u32 EncodingIndex = Slot.EncodingIndex[SlotIndex];
+            encoding_decoder *Decoder = Dispatch->Decoders[EncodingIndex];
+            if(Decoder)
+            {
+                Result = Decoder(&Context, At);
+            }
+            else
+            {
+                instruction_encoding Inst = Table.Encodings[EncodingIndex];
+                Result = TryDecode(&Context, &Inst, At);
+            }
             if(Result.Op)
             {
                 At.SegmentOffset += Result.Size;
@@ -318,3 +692,37 @@ static instruction DecodeInstruction(instruction_table Table, segmented_access A
     
     return Result;
 }
+
+/* NOTE(chuck): Returns the same Size DecodeInstruction would, or 0 wherever DecodeInstruction would
+   come back without an Op, but only ever looks at the first two bytes of each prefix and of the
+   instruction itself. Bytes must be readable for MaxInstructionByteCount + 2 bytes. */
+static u32 GetInstructionLength(instruction_length_table *Table, u8 *Bytes)
+{
+    u32 TotalSize = 0;
+    while(TotalSize < Table->MaxInstructionByteCount)
+    {
+        u8 FirstByte = Bytes[TotalSize];
+        u8 SecondByte = Bytes[TotalSize + 1];
+        instruction_length_slot Slot = Table->Slots[FirstByte][(SecondByte >> 3) & 0x7];
+        if(!(Slot.Flags & Length_Valid) ||
+           ((SecondByte & Slot.SecondByteMask) != Slot.SecondByteValue))
+        {
+            TotalSize = 0;
+            break;
+        }
+        
+        TotalSize += Slot.BaseSize;
+        if(Slot.Flags & Length_ModRM)
+        {
+            TotalSize += Table->ModRMDisplacementSize[Slot.DisplacementRow][SecondByte];
+        }
+        
+        if(!(Slot.Flags & Length_Prefix))
+        {
+            break;
+        }
+    }
+    
+    u32 Result = (TotalSize <= Table->MaxInstructionByteCount) ? TotalSize : 0;
+    return Result;
+}
@@ -10,4 +10,88 @@
    
    ======================================================================== */
 
-static instruction DecodeInstruction(instruction_table Table, segmented_access At);
+struct decode_context;
+typedef instruction encoding_decoder(decode_context *Context, segmented_access At);
+
+struct encoding_field_piece
+{
+    u8 ByteIndex;
+    u8 Shift;
+    u8 Mask;
+    u8 DestShift;
+};
+
+struct encoding_field
+{
+    b32 Has;
+    u32 ImplicitValue;
+    
+    // NOTE(chuck): Only ESC splits a field across two places in the instruction bytes (XXX and YYY).
+    u32 PieceCount;
+    encoding_field_piece Pieces[2];
+};
+
+struct encoding_layout
+{
+    operation_type Op;
+    u32 ByteCount;
+    u8 LiteralMask[2];
+    u8 LiteralValue[2];
+    encoding_field Fields[Bits_Count];
+};
+
+struct instruction_dispatch_slot
+{
+    u8 EncodingCount;
+    u8 EncodingIndex[2];
+};
+
+struct instruction_dispatch
+{
+    instruction_table Table;
+    
+    // NOTE(chuck): Indexed by the first instruction byte, then by the REG field of the second byte,
+    // so that group opcodes (the ones that use REG as an opcode extension) split into separate slots.
+    instruction_dispatch_slot Slots[256][8];
+    
+    // NOTE(chuck): Compiled decoders, indexed like Table.Encodings. Null entries fall back to TryDecode.
+    encoding_decoder *Decoders[256];
+};
+
+enum instruction_length_flag : u8
+{
+    Length_Valid = 0x1,
+    Length_Prefix = 0x2,
+    Length_ModRM = 0x4, // NOTE(chuck): Add ModRMDisplacementSize[DisplacementRow][second byte]
+};
+
+struct instruction_length_slot
+{
+    u8 Flags;
+    u8 BaseSize;
+    u8 DisplacementRow;
+    u8 SecondByteMask;
+    u8 SecondByteValue;
+};
+
+struct instruction_length_table
+{
+    u32 MaxInstructionByteCount;
+    
+    // NOTE(chuck): Indexed the same way as instruction_dispatch::Slots. BaseSize already includes
+    // the immediate data, since whether it is 8 or 16 bits only ever depends on the first byte.
+    instruction_length_slot Slots[256][8];
+    
+    // NOTE(chuck): Displacement bytes for each ModRM byte. Row bit 0 means the encoding always has a
+    // displacement, row bit 1 means the displacement is always 16 bits.
+    u8 ModRMDisplacementSize[4][256];
+};
+
+static instruction_dispatch BuildInstructionDispatch(instruction_table Table);
+static instruction_dispatch *Get8086InstructionDispatch();
+
+static instruction_length_table BuildInstructionLengthTable(instruction_dispatch *Dispatch);
+static instruction_length_table *Get8086InstructionLengthTable();
+
+static instruction DecodeInstruction(instruction_dispatch *Dispatch, segmented_access At);
+static u32 GetInstructionLength(instruction_length_table *Table, u8 *Bytes);
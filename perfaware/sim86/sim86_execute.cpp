@@ -0,0 +1,1022 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+static void InitializeMachine(machine *Machine, u8 *Memory, u32 MemorySizePow2)
+{
+    *Machine = {};
+    Machine->Memory = FixedMemoryPow2(MemorySizePow2, Memory);
+    Machine->Dispatch = Get8086InstructionDispatch();
+}
+
+static operand_location GetMemoryLocation(machine *Machine, u32 Address)
+{
+    operand_location Result = {};
+    Result.Low = Machine->Memory.Memory + (Address & Machine->Memory.Mask);
+    Result.High = Machine->Memory.Memory + ((Address + 1) & Machine->Memory.Mask);
+    return Result;
+}
+
+static operand_location GetRegisterLocation(machine *Machine, register_access Register)
+{
+    operand_location Result = {};
+    Result.Low = (u8 *)&Machine->Registers[Register.Index] + Register.Offset;
+    Result.High = Result.Low + 1;
+    return Result;
+}
+
+static u32 ReadLocation(operand_location Location, b32 Wide)
+{
+    u32 Result = *Location.Low;
+    if(Wide)
+    {
+        Result |= (*Location.High << 8);
+    }
+    return Result;
+}
+
+static void WriteLocation(machine *Machine, operand_location Location, b32 Wide, u32 Value)
+{
+    *Location.Low = (u8)Value;
+    if(Wide)
+    {
+        *Location.High = (u8)(Value >> 8);
+    }
+
+    // NOTE(chuck): Only the block engine cares about writes, and it only exists once it has been run.
+    if(Machine->Blocks)
+    {
+        NoteMemoryWrite(Machine, Location.Low);
+        if(Wide)
+        {
+            NoteMemoryWrite(Machine, Location.High);
+        }
+    }
+}
+
+static u16 GetEffectiveAddressOffset(machine *Machine, effective_address_expression Address)
+{
+    u16 Result = (u16)(Machine->Registers[Address.Terms[0].Register.Index] +
+                       Machine->Registers[Address.Terms[1].Register.Index] +
+                       Address.Displacement);
+    return Result;
+}
+
+// NOTE(chuck): Anything based off of bp defaults to the stack segment, everything else to the data
+// segment, unless the instruction had a segment prefix.
+static u32 GetDataSegment(instruction *Instruction, u32 DefaultSegment)
+{
+    u32 Result = (Instruction->Flags & Inst_Segment) ? Instruction->SegmentOverride : DefaultSegment;
+    return Result;
+}
+
+static u32 GetEffectiveAddress(machine *Machine, instruction *Instruction, effective_address_expression Address)
+{
+    u32 DefaultSegment = (Address.Terms[0].Register.Index == Register_bp) ? Register_ss : Register_ds;
+    u32 Segment = GetDataSegment(Instruction, DefaultSegment);
+    u32 Result = GetAbsoluteAddressOf(Machine->Memory.Mask, Machine->Registers[Segment],
+                                      GetEffectiveAddressOffset(Machine, Address), 0);
+    return Result;
+}
+
+static operand_location GetOperandLocation(machine *Machine, instruction *Instruction, instruction_operand *Operand)
+{
+    operand_location Result = {};
+    if(Operand->Type == Operand_Register)
+    {
+        Result = GetRegisterLocation(Machine, Operand->Register);
+    }
+    else
+    {
+        assert(Operand->Type == Operand_Memory);
+        Result = GetMemoryLocation(Machine, GetEffectiveAddress(Machine, Instruction, Operand->Address));
+    }
+    return Result;
+}
+
+static u32 ReadOperand(machine *Machine, instruction *Instruction, instruction_operand *Operand, b32 Wide)
+{
+    u32 Result = 0;
+    if(Operand->Type == Operand_Immediate)
+    {
+        Result = (u32)Operand->Immediate.Value & (Wide ? 0xffff : 0xff);
+    }
+    else
+    {
+        Result = ReadLocation(GetOperandLocation(Machine, Instruction, Operand), Wide);
+    }
+    return Result;
+}
+
+// NOTE(chuck): Register destinations know their own width. Memory destinations go by the W bit.
+static b32 IsWide(instruction *Instruction)
+{
+    instruction_operand *Dest = &Instruction->Operands[0];
+    b32 Result = (Dest->Type == Operand_Register) ? (Dest->Register.Count == 2) : ((Instruction->Flags & Inst_Wide) != 0);
+    return Result;
+}
+
+static u16 *GetRegister(machine *Machine, register_mapping_8086 Register)
+{
+    u16 *Result = &Machine->Registers[Register];
+    return Result;
+}
+
+static b32 IsSet(machine *Machine, u32 Flag)
+{
+    b32 Result = ((Machine->Registers[Register_flags] & Flag) != 0);
+    return Result;
+}
+
+static void SetFlag(machine *Machine, u32 Flag, b32 Value)
+{
+    u16 *Flags = GetRegister(Machine, Register_flags);
+    *Flags = (u16)((*Flags & ~Flag) | (Value ? Flag : 0));
+}
+
+static b32 HasEvenParity(u32 Value)
+{
+    u32 Bits = Value & 0xff;
+    Bits ^= (Bits >> 4);
+    Bits ^= (Bits >> 2);
+    Bits ^= (Bits >> 1);
+    b32 Result = ((Bits & 1) == 0);
+    return Result;
+}
+
+static void SetResultFlags(machine *Machine, u32 Value, b32 Wide)
+{
+    u32 SignBit = Wide ? 0x8000 : 0x80;
+    u32 Mask = Wide ? 0xffff : 0xff;
+    SetFlag(Machine, Flag_Zero, (Value & Mask) == 0);
+    SetFlag(Machine, Flag_Sign, (Value & SignBit) != 0);
+    SetFlag(Machine, Flag_Parity, HasEvenParity(Value));
+}
+
+/* NOTE(chuck): Both operands are already masked to the operation width, so the sum or difference
+   lands in a u32 with the carry (or borrow, which wraps all the upper bits) sitting right above the
+   result. */
+static u32 AddWithFlags(machine *Machine, u32 A, u32 B, u32 CarryIn, b32 Wide)
+{
+    u32 SignBit = Wide ? 0x8000 : 0x80;
+    u32 Result = A + B + CarryIn;
+    SetFlag(Machine, Flag_Carry, (Result & (SignBit << 1)) != 0);
+    SetFlag(Machine, Flag_AuxiliaryCarry, ((A ^ B ^ Result) & 0x10) != 0);
+    SetFlag(Machine, Flag_Overflow, ((A ^ Result) & (B ^ Result) & SignBit) != 0);
+    SetResultFlags(Machine, Result, Wide);
+    return Result;
+}
+
+static u32 SubtractWithFlags(machine *Machine, u32 A, u32 B, u32 BorrowIn, b32 Wide)
+{
+    u32 SignBit = Wide ? 0x8000 : 0x80;
+    u32 Result = A - B - BorrowIn;
+    SetFlag(Machine, Flag_Carry, (Result & (SignBit << 1)) != 0);
+    SetFlag(Machine, Flag_AuxiliaryCarry, ((A ^ B ^ Result) & 0x10) != 0);
+    SetFlag(Machine, Flag_Overflow, ((A ^ B) & (A ^ Result) & SignBit) != 0);
+    SetResultFlags(Machine, Result, Wide);
+    return Result;
+}
+
+static void SetLogicFlags(machine *Machine, u32 Value, b32 Wide)
+{
+    SetFlag(Machine, Flag_Carry, false);
+    SetFlag(Machine, Flag_Overflow, false);
+    SetFlag(Machine, Flag_AuxiliaryCarry, false);
+    SetResultFlags(Machine, Value, Wide);
+}
+
+// NOTE(chuck): The one-byte register forms of inc, dec, push and pop decode their register as the
+// second operand.
+static instruction_operand *GetSingleOperand(instruction *Instruction)
+{
+    instruction_operand *Result = &Instruction->Operands[0];
+    if(Result->Type == Operand_None)
+    {
+        Result = &Instruction->Operands[1];
+    }
+    return Result;
+}
+
+static u32 GetStackAddress(machine *Machine)
+{
+    u32 Result = GetAbsoluteAddressOf(Machine->Memory.Mask, Machine->Registers[Register_ss], Machine->Registers[Register_sp], 0);
+    return Result;
+}
+
+static void Push(machine *Machine, u16 Value)
+{
+    *GetRegister(Machine, Register_sp) -= 2;
+    WriteLocation(Machine, GetMemoryLocation(Machine, GetStackAddress(Machine)), true, Value);
+}
+
+static u16 Pop(machine *Machine)
+{
+    u16 Result = (u16)ReadLocation(GetMemoryLocation(Machine, GetStackAddress(Machine)), true);
+    *GetRegister(Machine, Register_sp) += 2;
+    return Result;
+}
+
+// NOTE(chuck): Interrupts go through the vector table at the bottom of memory, same as the real thing.
+static void Interrupt(machine *Machine, u32 Type)
+{
+    Push(Machine, Machine->Registers[Register_flags]);
+    SetFlag(Machine, Flag_Interrupt, false);
+    SetFlag(Machine, Flag_Trap, false);
+    Push(Machine, Machine->Registers[Register_cs]);
+    Push(Machine, Machine->Registers[Register_ip]);
+
+    u32 Vector = (Type & 0xff)*4;
+    Machine->Registers[Register_ip] = (u16)ReadLocation(GetMemoryLocation(Machine, Vector), true);
+    Machine->Registers[Register_cs] = (u16)ReadLocation(GetMemoryLocation(Machine, Vector + 2), true);
+}
+
+static b32 ShouldJump(machine *Machine, operation_type Op)
+{
+    b32 CF = IsSet(Machine, Flag_Carry);
+    b32 PF = IsSet(Machine, Flag_Parity);
+    b32 ZF = IsSet(Machine, Flag_Zero);
+    b32 SF = IsSet(Machine, Flag_Sign);
+    b32 OF = IsSet(Machine, Flag_Overflow);
+    u16 *CX = GetRegister(Machine, Register_c);
+
+    b32 Result = false;
+    switch(Op)
+    {
+        case Op_je: {Result = ZF;} break;
+        case Op_jl: {Result = (SF != OF);} break;
+        case Op_jle: {Result = ZF || (SF != OF);} break;
+        case Op_jb: {Result = CF;} break;
+        case Op_jbe: {Result = CF || ZF;} break;
+        case Op_jp: {Result = PF;} break;
+        case Op_jo: {Result = OF;} break;
+        case Op_js: {Result = SF;} break;
+        case Op_jne: {Result = !ZF;} break;
+        case Op_jnl: {Result = (SF == OF);} break;
+        case Op_jg: {Result = !ZF && (SF == OF);} break;
+        case Op_jnb: {Result = !CF;} break;
+        case Op_ja: {Result = !CF && !ZF;} break;
+        case Op_jnp: {Result = !PF;} break;
+        case Op_jno: {Result = !OF;} break;
+        case Op_jns: {Result = !SF;} break;
+        case Op_loop: {Result = (--*CX != 0);} break;
+        case Op_loopz: {Result = (--*CX != 0) && ZF;} break;
+        case Op_loopnz: {Result = (--*CX != 0) && !ZF;} break;
+        case Op_jcxz: {Result = (*CX == 0);} break;
+
+        default: {} break;
+    }
+
+    return Result;
+}
+
+// NOTE(chuck): The decoder folds rep and repne into Inst_Rep, so cmps and scas look back at the
+// prefix bytes to see which one it was.
+static b32 RepeatsWhileZero(machine *Machine, instruction *Instruction)
+{
+    b32 Result = true;
+    for(u32 ByteIndex = 0; ByteIndex < Instruction->Size; ++ByteIndex)
+    {
+        u8 Byte = *GetMemoryLocation(Machine, Instruction->Address + ByteIndex).Low;
+        if((Byte & 0xfe) == 0xf2)
+        {
+            Result = (Byte & 1);
+        }
+    }
+    return Result;
+}
+
+static void ExecuteString(machine *Machine, instruction *Instruction)
+{
+    b32 Wide = ((Instruction->Flags & Inst_Wide) != 0);
+    u16 Step = IsSet(Machine, Flag_Direction) ? (u16)(Wide ? -2 : -1) : (u16)(Wide ? 2 : 1);
+    u16 *AX = GetRegister(Machine, Register_a);
+    u16 *CX = GetRegister(Machine, Register_c);
+    u16 *SI = GetRegister(Machine, Register_si);
+    u16 *DI = GetRegister(Machine, Register_di);
+    u32 Mask = Machine->Memory.Mask;
+    u32 SourceSegment = GetDataSegment(Instruction, Register_ds);
+
+    b32 Repeat = ((Instruction->Flags & Inst_Rep) != 0);
+    b32 WhileZero = Repeat && ((Instruction->Op == Op_cmps) || (Instruction->Op == Op_scas)) && RepeatsWhileZero(Machine, Instruction);
+    b32 CheckZero = Repeat && ((Instruction->Op == Op_cmps) || (Instruction->Op == Op_scas));
+
+    while(!Repeat || *CX)
+    {
+        operand_location Source = GetMemoryLocation(Machine, GetAbsoluteAddressOf(Mask, Machine->Registers[SourceSegment], *SI, 0));
+        operand_location Dest = GetMemoryLocation(Machine, GetAbsoluteAddressOf(Mask, Machine->Registers[Register_es], *DI, 0));
+        operand_location Accumulator = GetRegisterLocation(Machine, RegisterAccess(Register_a, 0, Wide ? 2 : 1));
+
+        switch(Instruction->Op)
+        {
+            case Op_movs:
+            {
+                WriteLocation(Machine, Dest, Wide, ReadLocation(Source, Wide));
+                *SI += Step;
+                *DI += Step;
+            } break;
+
+            case Op_cmps:
+            {
+                SubtractWithFlags(Machine, ReadLocation(Source, Wide), ReadLocation(Dest, Wide), 0, Wide);
+                *SI += Step;
+                *DI += Step;
+            } break;
+
+            case Op_scas:
+            {
+                SubtractWithFlags(Machine, ReadLocation(Accumulator, Wide), ReadLocation(Dest, Wide), 0, Wide);
+                *DI += Step;
+            } break;
+
+            case Op_lods:
+            {
+                WriteLocation(Machine, Accumulator, Wide, ReadLocation(Source, Wide));
+                *SI += Step;
+            } break;
+
+            case Op_stos:
+            {
+                WriteLocation(Machine, Dest, Wide, *AX);
+                *DI += Step;
+            } break;
+
+            default: {} break;
+        }
+
+        if(!Repeat)
+        {
+            break;
+        }
+
+        --*CX;
+        if(CheckZero && (IsSet(Machine, Flag_Zero) != WhileZero))
+        {
+            break;
+        }
+    }
+}
+
+static void ExecuteShift(machine *Machine, instruction *Instruction, b32 Wide)
+{
+    u32 SignBit = Wide ? 0x8000 : 0x80;
+    u32 Mask = Wide ? 0xffff : 0xff;
+    operand_location Dest = GetOperandLocation(Machine, Instruction, &Instruction->Operands[0]);
+    u32 Count = ReadOperand(Machine, Instruction, &Instruction->Operands[1], false);
+    u32 Value = ReadLocation(Dest, Wide);
+
+    if(Count)
+    {
+        u32 Original = Value;
+        b32 Carry = IsSet(Machine, Flag_Carry);
+        for(u32 Iteration = 0; Iteration < Count; ++Iteration)
+        {
+            switch(Instruction->Op)
+            {
+                case Op_shl: {Carry = ((Value & SignBit) != 0); Value = (Value << 1) & Mask;} break;
+                case Op_shr: {Carry = (Value & 1); Value = (Value >> 1);} break;
+                case Op_sar: {Carry = (Value & 1); Value = (Value >> 1) | (Value & SignBit);} break;
+                case Op_rol: {Carry = ((Value & SignBit) != 0); Value = ((Value << 1) & Mask) | Carry;} break;
+                case Op_ror: {Carry = (Value & 1); Value = (Value >> 1) | (Carry ? SignBit : 0);} break;
+                case Op_rcl: {b32 Out = ((Value & SignBit) != 0); Value = ((Value << 1) & Mask) | Carry; Carry = Out;} break;
+                case Op_rcr: {b32 Out = (Value & 1); Value = (Value >> 1) | (Carry ? SignBit : 0); Carry = Out;} break;
+                default: {} break;
+            }
+        }
+
+        SetFlag(Machine, Flag_Carry, Carry);
+        switch(Instruction->Op)
+        {
+            case Op_shl:
+            case Op_rol:
+            case Op_rcl:
+            {
+                SetFlag(Machine, Flag_Overflow, ((Value & SignBit) != 0) != Carry);
+            } break;
+
+            case Op_shr:
+            {
+                SetFlag(Machine, Flag_Overflow, (Original & SignBit) != 0);
+            } break;
+
+            case Op_sar:
+            {
+                SetFlag(Machine, Flag_Overflow, false);
+            } break;
+
+            default:
+            {
+                SetFlag(Machine, Flag_Overflow, ((Value ^ (Value << 1)) & SignBit) != 0);
+            } break;
+        }
+
+        if((Instruction->Op == Op_shl) || (Instruction->Op == Op_shr) || (Instruction->Op == Op_sar))
+        {
+            SetResultFlags(Machine, Value, Wide);
+        }
+
+        WriteLocation(Machine, Dest, Wide, Value);
+    }
+}
+
+static void ExecuteMultiply(machine *Machine, instruction *Instruction, b32 Wide)
+{
+    u16 *AX = GetRegister(Machine, Register_a);
+    u16 *DX = GetRegister(Machine, Register_d);
+    u32 Source = ReadOperand(Machine, Instruction, &Instruction->Operands[0], Wide);
+
+    b32 Overflow = false;
+    if(Instruction->Op == Op_mul)
+    {
+        if(Wide)
+        {
+            u32 Product = *AX*Source;
+            *AX = (u16)Product;
+            *DX = (u16)(Product >> 16);
+            Overflow = (*DX != 0);
+        }
+        else
+        {
+            *AX = (u16)((*AX & 0xff)*Source);
+            Overflow = ((*AX >> 8) != 0);
+        }
+    }
+    else
+    {
+        if(Wide)
+        {
+            s32 Product = (s32)(s16)*AX*(s32)(s16)Source;
+            *AX = (u16)Product;
+            *DX = (u16)(Product >> 16);
+            Overflow = (Product != (s16)Product);
+        }
+        else
+        {
+            s32 Product = (s32)(s8)*AX*(s32)(s8)Source;
+            *AX = (u16)Product;
+            Overflow = (Product != (s8)Product);
+        }
+    }
+
+    SetFlag(Machine, Flag_Carry, Overflow);
+    SetFlag(Machine, Flag_Overflow, Overflow);
+}
+
+// NOTE(chuck): Returns false for a divide error, which the caller turns into interrupt 0.
+static b32 ExecuteDivide(machine *Machine, instruction *Instruction, b32 Wide)
+{
+    u16 *AX = GetRegister(Machine, Register_a);
+    u16 *DX = GetRegister(Machine, Register_d);
+    u32 Divisor = ReadOperand(Machine, Instruction, &Instruction->Operands[0], Wide);
+
+    b32 Result = (Divisor != 0);
+    if(Result)
+    {
+        if(Instruction->Op == Op_div)
+        {
+            u32 Dividend = Wide ? (((u32)*DX << 16) | *AX) : *AX;
+            u32 Quotient = Dividend / Divisor;
+            u32 Remainder = Dividend % Divisor;
+            Result = (Quotient <= (Wide ? 0xffffu : 0xffu));
+            if(Result)
+            {
+                if(Wide)
+                {
+                    *AX = (u16)Quotient;
+                    *DX = (u16)Remainder;
+                }
+                else
+                {
+                    *AX = (u16)((Remainder << 8) | Quotient);
+                }
+            }
+        }
+        else
+        {
+            s32 Dividend = Wide ? (s32)(((u32)*DX << 16) | *AX) : (s32)(s16)*AX;
+            s32 SignedDivisor = Wide ? (s32)(s16)Divisor : (s32)(s8)Divisor;
+            s32 Quotient = Dividend / SignedDivisor;
+            s32 Remainder = Dividend % SignedDivisor;
+            s32 Limit = Wide ? 0x7fff : 0x7f;
+            Result = (Quotient <= Limit) && (Quotient >= -Limit);
+            if(Result)
+            {
+                if(Wide)
+                {
+                    *AX = (u16)Quotient;
+                    *DX = (u16)Remainder;
+                }
+                else
+                {
+                    *AX = (u16)(((Remainder & 0xff) << 8) | (Quotient & 0xff));
+                }
+            }
+        }
+    }
+
+    return Result;
+}
+
+static void ExecuteDecimalAdjust(machine *Machine, operation_type Op)
+{
+    u16 *AX = GetRegister(Machine, Register_a);
+    u32 AL = *AX & 0xff;
+    b32 AuxiliaryCarry = IsSet(Machine, Flag_AuxiliaryCarry);
+    b32 Carry = IsSet(Machine, Flag_Carry);
+
+    switch(Op)
+    {
+        case Op_aaa:
+        case Op_aas:
+        {
+            AuxiliaryCarry = ((AL & 0xf) > 9) || AuxiliaryCarry;
+            if(AuxiliaryCarry)
+            {
+                u32 AH = (*AX >> 8);
+                AL = (Op == Op_aaa) ? (AL + 6) : (AL - 6);
+                AH = (Op == Op_aaa) ? (AH + 1) : (AH - 1);
+                *AX = (u16)(((AH & 0xff) << 8) | (AL & 0xf));
+            }
+            else
+            {
+                *AX = (u16)(*AX & 0xff0f);
+            }
+            Carry = AuxiliaryCarry;
+        } break;
+
+        case Op_daa:
+        case Op_das:
+        {
+            u32 Original = AL;
+            if(((AL & 0xf) > 9) || AuxiliaryCarry)
+            {
+                AL = (Op == Op_daa) ? (AL + 6) : (AL - 6);
+                AuxiliaryCarry = true;
+            }
+            if((Original > 0x99) || Carry)
+            {
+                AL = (Op == Op_daa) ? (AL + 0x60) : (AL - 0x60);
+                Carry = true;
+            }
+            *AX = (u16)((*AX & 0xff00) | (AL & 0xff));
+            SetResultFlags(Machine, AL, false);
+        } break;
+
+        case Op_aam:
+        {
+            *AX = (u16)(((AL / 10) << 8) | (AL % 10));
+            SetResultFlags(Machine, *AX, false);
+        } break;
+
+        case Op_aad:
+        {
+            *AX = (u16)(((*AX >> 8)*10 + AL) & 0xff);
+            SetResultFlags(Machine, *AX, false);
+        } break;
+
+        default: {} break;
+    }
+
+    SetFlag(Machine, Flag_AuxiliaryCarry, AuxiliaryCarry);
+    SetFlag(Machine, Flag_Carry, Carry);
+}
+
+/* NOTE(chuck): IP has already been moved past the instruction when this is called, so relative
+   jumps can just add their displacement to it. Anything that returns Machine_Unimplemented must do
+   so before it changes any state. */
+static machine_status ExecuteInstruction(machine *Machine, instruction *Instruction)
+{
+    machine_status Result = Machine_Running;
+
+    instruction_operand *Dest = &Instruction->Operands[0];
+    instruction_operand *Source = &Instruction->Operands[1];
+    b32 Wide = IsWide(Instruction);
+    u16 *IP = GetRegister(Machine, Register_ip);
+    u16 *CS = GetRegister(Machine, Register_cs);
+    u16 *SP = GetRegister(Machine, Register_sp);
+    u16 *AX = GetRegister(Machine, Register_a);
+    u16 *DX = GetRegister(Machine, Register_d);
+    u16 *Flags = GetRegister(Machine, Register_flags);
+
+    switch(Instruction->Op)
+    {
+        case Op_mov:
+        {
+            u32 Value = ReadOperand(Machine, Instruction, Source, Wide);
+            WriteLocation(Machine, GetOperandLocation(Machine, Instruction, Dest), Wide, Value);
+        } break;
+
+        case Op_push:
+        {
+            // NOTE(chuck): The 8086 pushes the value sp has after it was decremented.
+            *SP -= 2;
+            u16 Value = (u16)ReadOperand(Machine, Instruction, GetSingleOperand(Instruction), true);
+            WriteLocation(Machine, GetMemoryLocation(Machine, GetStackAddress(Machine)), true, Value);
+        } break;
+
+        case Op_pop:
+        {
+            u16 Value = Pop(Machine);
+            WriteLocation(Machine, GetOperandLocation(Machine, Instruction, GetSingleOperand(Instruction)), true, Value);
+        } break;
+
+        case Op_xchg:
+        {
+            operand_location A = GetOperandLocation(Machine, Instruction, Dest);
+            operand_location B = GetOperandLocation(Machine, Instruction, Source);
+            u32 Value = ReadLocation(A, Wide);
+            WriteLocation(Machine, A, Wide, ReadLocation(B, Wide));
+            WriteLocation(Machine, B, Wide, Value);
+        } break;
+
+        case Op_xlat:
+        {
+            u16 Offset = (u16)(Machine->Registers[Register_b] + (*AX & 0xff));
+            u32 Address = GetAbsoluteAddressOf(Machine->Memory.Mask, Machine->Registers[GetDataSegment(Instruction, Register_ds)], Offset, 0);
+            *AX = (u16)((*AX & 0xff00) | *GetMemoryLocation(Machine, Address).Low);
+        } break;
+
+        case Op_lea:
+        {
+            WriteLocation(Machine, GetOperandLocation(Machine, Instruction, Dest), true, GetEffectiveAddressOffset(Machine, Source->Address));
+        } break;
+
+        case Op_lds:
+        case Op_les:
+        {
+            u32 Address = GetEffectiveAddress(Machine, Instruction, Source->Address);
+            u32 Offset = ReadLocation(GetMemoryLocation(Machine, Address), true);
+            u32 Segment = ReadLocation(GetMemoryLocation(Machine, Address + 2), true);
+            WriteLocation(Machine, GetOperandLocation(Machine, Instruction, Dest), true, Offset);
+            *GetRegister(Machine, (Instruction->Op == Op_lds) ? Register_ds : Register_es) = (u16)Segment;
+        } break;
+
+        case Op_lahf:
+        {
+            *AX = (u16)((*AX & 0x00ff) | ((*Flags & 0xff) << 8));
+        } break;
+
+        case Op_sahf:
+        {
+            u32 Mask = Flag_Sign | Flag_Zero | Flag_AuxiliaryCarry | Flag_Parity | Flag_Carry;
+            *Flags = (u16)((*Flags & ~Mask) | ((*AX >> 8) & Mask));
+        } break;
+
+        case Op_pushf:
+        {
+            Push(Machine, *Flags);
+        } break;
+
+        case Op_popf:
+        {
+            *Flags = (u16)(Pop(Machine) & 0x0fd5);
+        } break;
+
+        case Op_add:
+        case Op_adc:
+        case Op_sub:
+        case Op_sbb:
+        case Op_cmp:
+        {
+            operand_location Location = GetOperandLocation(Machine, Instruction, Dest);
+            u32 A = ReadLocation(Location, Wide);
+            u32 B = ReadOperand(Machine, Instruction, Source, Wide);
+            u32 Carry = ((Instruction->Op == Op_adc) || (Instruction->Op == Op_sbb)) ? IsSet(Machine, Flag_Carry) : 0;
+
+            u32 Value = 0;
+            if((Instruction->Op == Op_add) || (Instruction->Op == Op_adc))
+            {
+                Value = AddWithFlags(Machine, A, B, Carry, Wide);
+            }
+            else
+            {
+                Value = SubtractWithFlags(Machine, A, B, Carry, Wide);
+            }
+
+            if(Instruction->Op != Op_cmp)
+            {
+                WriteLocation(Machine, Location, Wide, Value);
+            }
+        } break;
+
+        case Op_inc:
+        case Op_dec:
+        {
+            operand_location Location = GetOperandLocation(Machine, Instruction, GetSingleOperand(Instruction));
+            b32 Carry = IsSet(Machine, Flag_Carry);
+            u32 A = ReadLocation(Location, Wide);
+            u32 Value = (Instruction->Op == Op_inc) ? AddWithFlags(Machine, A, 1, 0, Wide) : SubtractWithFlags(Machine, A, 1, 0, Wide);
+            SetFlag(Machine, Flag_Carry, Carry);
+            WriteLocation(Machine, Location, Wide, Value);
+        } break;
+
+        case Op_neg:
+        {
+            operand_location Location = GetOperandLocation(Machine, Instruction, Dest);
+            WriteLocation(Machine, Location, Wide, SubtractWithFlags(Machine, 0, ReadLocation(Location, Wide), 0, Wide));
+        } break;
+
+        case Op_not:
+        {
+            operand_location Location = GetOperandLocation(Machine, Instruction, Dest);
+            WriteLocation(Machine, Location, Wide, ~ReadLocation(Location, Wide));
+        } break;
+
+        case Op_and:
+        case Op_test:
+        case Op_or:
+        case Op_xor:
+        {
+            operand_location Location = GetOperandLocation(Machine, Instruction, Dest);
+            u32 A = ReadLocation(Location, Wide);
+            u32 B = ReadOperand(Machine, Instruction, Source, Wide);
+
+            u32 Value = 0;
+            switch(Instruction->Op)
+            {
+                case Op_and:
+                case Op_test: {Value = A & B;} break;
+                case Op_or: {Value = A | B;} break;
+                default: {Value = A ^ B;} break;
+            }
+
+            SetLogicFlags(Machine, Value, Wide);
+            if(Instruction->Op != Op_test)
+            {
+                WriteLocation(Machine, Location, Wide, Value);
+            }
+        } break;
+
+        case Op_shl:
+        case Op_shr:
+        case Op_sar:
+        case Op_rol:
+        case Op_ror:
+        case Op_rcl:
+        case Op_rcr:
+        {
+            ExecuteShift(Machine, Instruction, Wide);
+        } break;
+
+        case Op_mul:
+        case Op_imul:
+        {
+            ExecuteMultiply(Machine, Instruction, Wide);
+        } break;
+
+        case Op_div:
+        case Op_idiv:
+        {
+            if(!ExecuteDivide(Machine, Instruction, Wide))
+            {
+                Interrupt(Machine, 0);
+            }
+        } break;
+
+        case Op_aaa:
+        case Op_aas:
+        case Op_daa:
+        case Op_das:
+        case Op_aad:
+        {
+            ExecuteDecimalAdjust(Machine, Instruction->Op);
+        } break;
+
+        case Op_aam:
+        {
+            // NOTE(chuck): The decoder only accepts the base-10 form, so aam can't divide by zero.
+            ExecuteDecimalAdjust(Machine, Instruction->Op);
+        } break;
+
+        case Op_cbw:
+        {
+            *AX = (u16)(s16)(s8)*AX;
+        } break;
+
+        case Op_cwd:
+        {
+            *DX = (*AX & 0x8000) ? 0xffff : 0;
+        } break;
+
+        case Op_movs:
+        case Op_cmps:
+        case Op_scas:
+        case Op_lods:
+        case Op_stos:
+        {
+            ExecuteString(Machine, Instruction);
+        } break;
+
+        case Op_call:
+        case Op_jmp:
+        {
+            u16 NewIP = 0;
+            u16 NewCS = *CS;
+            if((Dest->Type == Operand_Memory) && (Dest->Address.Flags & Address_ExplicitSegment))
+            {
+                NewIP = (u16)Dest->Address.Displacement;
+                NewCS = (u16)Dest->Address.ExplicitSegment;
+            }
+            else if(Instruction->Flags & Inst_Far)
+            {
+                u32 Address = GetEffectiveAddress(Machine, Instruction, Dest->Address);
+                NewIP = (u16)ReadLocation(GetMemoryLocation(Machine, Address), true);
+                NewCS = (u16)ReadLocation(GetMemoryLocation(Machine, Address + 2), true);
+            }
+            else if(Dest->Type == Operand_Immediate)
+            {
+                NewIP = (u16)(*IP + Dest->Immediate.Value);
+            }
+            else
+            {
+                NewIP = (u16)ReadOperand(Machine, Instruction, Dest, true);
+            }
+
+            if(Instruction->Op == Op_call)
+            {
+                if(NewCS != *CS)
+                {
+                    Push(Machine, *CS);
+                }
+                Push(Machine, *IP);
+            }
+
+            *IP = NewIP;
+            *CS = NewCS;
+        } break;
+
+        case Op_ret:
+        case Op_retf:
+        {
+            *IP = Pop(Machine);
+            if(Instruction->Op == Op_retf)
+            {
+                *CS = Pop(Machine);
+            }
+            if(Dest->Type == Operand_Immediate)
+            {
+                *SP += (u16)Dest->Immediate.Value;
+            }
+        } break;
+
+        case Op_je:
+        case Op_jl:
+        case Op_jle:
+        case Op_jb:
+        case Op_jbe:
+        case Op_jp:
+        case Op_jo:
+        case Op_js:
+        case Op_jne:
+        case Op_jnl:
+        case Op_jg:
+        case Op_jnb:
+        case Op_ja:
+        case Op_jnp:
+        case Op_jno:
+        case Op_jns:
+        case Op_loop:
+        case Op_loopz:
+        case Op_loopnz:
+        case Op_jcxz:
+        {
+            if(ShouldJump(Machine, Instruction->Op))
+            {
+                *IP = (u16)(*IP + Dest->Immediate.Value);
+            }
+        } break;
+
+        case Op_int:
+        {
+            Interrupt(Machine, Dest->Immediate.Value);
+        } break;
+
+        case Op_int3:
+        {
+            Interrupt(Machine, 3);
+        } break;
+
+        case Op_into:
+        {
+            if(IsSet(Machine, Flag_Overflow))
+            {
+                Interrupt(Machine, 4);
+            }
+        } break;
+
+        case Op_iret:
+        {
+            *IP = Pop(Machine);
+            *CS = Pop(Machine);
+            *Flags = (u16)(Pop(Machine) & 0x0fd5);
+        } break;
+
+        case Op_clc: {SetFlag(Machine, Flag_Carry, false);} break;
+        case Op_cmc: {SetFlag(Machine, Flag_Carry, !IsSet(Machine, Flag_Carry));} break;
+        case Op_stc: {SetFlag(Machine, Flag_Carry, true);} break;
+        case Op_cld: {SetFlag(Machine, Flag_Direction, false);} break;
+        case Op_std: {SetFlag(Machine, Flag_Direction, true);} break;
+        case Op_cli: {SetFlag(Machine, Flag_Interrupt, false);} break;
+        case Op_sti: {SetFlag(Machine, Flag_Interrupt, true);} break;
+
+        case Op_hlt:
+        {
+            Result = Machine_Halted;
+        } break;
+
+        case Op_wait:
+        case Op_esc:
+        case Op_lock:
+        {
+            // NOTE(chuck): There is no coprocessor or bus to lock, so these do nothing.
+        } break;
+
+        default:
+        {
+            Result = Machine_Unimplemented;
+        } break;
+    }
+
+    return Result;
+}
+
+static machine_status StepMachine(machine *Machine, instruction *Executed)
+{
+    segmented_access At = Machine->Memory;
+    At.SegmentBase = Machine->Registers[Register_cs];
+    At.SegmentOffset = Machine->Registers[Register_ip];
+
+    instruction Instruction = DecodeInstruction(Machine->Dispatch, At);
+    machine_status Result = Machine_Unrecognized;
+    if(Instruction.Op)
+    {
+        Machine->Registers[Register_ip] += (u16)Instruction.Size;
+        Result = ExecuteInstruction(Machine, &Instruction);
+        if(Result == Machine_Unimplemented)
+        {
+            Machine->Registers[Register_ip] = At.SegmentOffset;
+        }
+    }
+
+    *Executed = Instruction;
+    return Result;
+}
+
+/* NOTE(chuck): The loop is written out twice so that a run without a callback pays nothing for it.
+   A hlt counts as executed, an instruction that is unrecognized or unimplemented does not. */
+static u64 RunMachine(machine *Machine, u64 MaxInstructionCount, machine_step_callback *Callback, void *CallbackContext, machine_status *Status)
+{
+    machine_status Stop = Machine_Running;
+    u64 Count = 0;
+    instruction Executed;
+    if(Callback)
+    {
+        while(Count < MaxInstructionCount)
+        {
+            Stop = StepMachine(Machine, &Executed);
+            if((Stop == Machine_Unrecognized) || (Stop == Machine_Unimplemented))
+            {
+                break;
+            }
+
+            ++Count;
+            if(!Callback(CallbackContext, Machine, &Executed) && (Stop == Machine_Running))
+            {
+                Stop = Machine_Stopped;
+            }
+
+            if(Stop != Machine_Running)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        while(Count < MaxInstructionCount)
+        {
+            Stop = StepMachine(Machine, &Executed);
+            if(Stop != Machine_Running)
+            {
+                Count += (Stop == Machine_Halted);
+                break;
+            }
+            ++Count;
+        }
+    }
+
+    if(Status)
+    {
+        *Status = Stop;
+    }
+
+    return Count;
+}
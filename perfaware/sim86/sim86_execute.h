@@ -0,0 +1,40 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+struct block_cache;
+
+struct machine
+{
+    // NOTE(chuck): Indexed by register_mapping_8086. Register_none is never written, so an effective
+    // address term that isn't there reads as zero without a branch.
+    u16 Registers[Register_count];
+
+    segmented_access Memory;
+    instruction_dispatch *Dispatch;
+
+    // NOTE(chuck): Null until the machine is first run through the block engine.
+    block_cache *Blocks;
+};
+
+/* NOTE(chuck): Where an operand lives, so that read-modify-write instructions only work out its
+   address once. For a word, High is where the upper byte goes: right after Low for registers, and
+   wrapped around to the bottom of memory for a word that straddles the top. */
+struct operand_location
+{
+    u8 *Low;
+    u8 *High;
+};
+
+static void InitializeMachine(machine *Machine, u8 *Memory, u32 MemorySizePow2);
+static machine_status ExecuteInstruction(machine *Machine, instruction *Instruction);
+static machine_status StepMachine(machine *Machine, instruction *Executed);
+static u64 RunMachine(machine *Machine, u64 MaxInstructionCount, machine_step_callback *Callback, void *CallbackContext, machine_status *Status);
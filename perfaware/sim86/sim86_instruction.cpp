@@ -69,3 +69,214 @@ static instruction_operand ImmediateOperand(u32 Value, u32 Flags = 0)
     
     return Result;
 }
+
+static u16 PackValue(s32 Value, u8 *Flags)
+{
+    assert((Value >= -0x10000) && (Value <= 0xffff));
+    if(Value < 0)
+    {
+        *Flags |= PackedOperand_Negative;
+    }
+    
+    u16 Result = (u16)Value;
+    return Result;
+}
+
+static s32 UnpackValue(u16 Value, u8 Flags)
+{
+    s32 Result = Value;
+    if(Flags & PackedOperand_Negative)
+    {
+        Result -= 0x10000;
+    }
+    
+    return Result;
+}
+
+static packed_operand PackOperand(instruction_operand Operand)
+{
+    packed_operand Result = {};
+    
+    Result.Flags = (u8)Operand.Type;
+    switch(Operand.Type)
+    {
+        case Operand_None: {} break;
+        
+        case Operand_Register:
+        {
+            register_access Reg = Operand.Register;
+            assert((Reg.Index < 16) && (Reg.Offset <= 1) && ((Reg.Count == 1) || (Reg.Count == 2)));
+            
+            Result.Registers = (u8)Reg.Index;
+            if(Reg.Offset)
+            {
+                Result.Flags |= PackedOperand_HighByte;
+            }
+            if(Reg.Count == 2)
+            {
+                Result.Flags |= PackedOperand_Wide;
+            }
+        } break;
+        
+        case Operand_Memory:
+        {
+            effective_address_expression Address = Operand.Address;
+            if(Address.Flags & Address_ExplicitSegment)
+            {
+                // NOTE(chuck): The segment itself is stored by PackInstruction.
+                Result.Flags |= PackedOperand_ExplicitSegment;
+            }
+            else
+            {
+                for(u32 TermIndex = 0; TermIndex < ArrayCount(Address.Terms); ++TermIndex)
+                {
+                    effective_address_term Term = Address.Terms[TermIndex];
+                    assert((Term.Register.Index < 16) && (Term.Register.Offset == 0) &&
+                           (Term.Register.Count == 2) && (Term.Scale == 1));
+                    Result.Registers |= (u8)(Term.Register.Index << (4*TermIndex));
+                }
+            }
+            
+            Result.Value = PackValue(Address.Displacement, &Result.Flags);
+        } break;
+        
+        case Operand_Immediate:
+        {
+            immediate Immediate = Operand.Immediate;
+            if(Immediate.Flags & Immediate_RelativeJumpDisplacement)
+            {
+                Result.Flags |= PackedOperand_RelativeJumpDisplacement;
+            }
+            
+            Result.Value = PackValue(Immediate.Value, &Result.Flags);
+        } break;
+    }
+    
+    return Result;
+}
+
+static instruction_operand UnpackOperand(packed_operand Packed)
+{
+    instruction_operand Result = {};
+    
+    Result.Type = (operand_type)(Packed.Flags & PackedOperand_TypeMask);
+    switch(Result.Type)
+    {
+        case Operand_None: {} break;
+        
+        case Operand_Register:
+        {
+            Result.Register.Index = Packed.Registers;
+            Result.Register.Offset = (Packed.Flags & PackedOperand_HighByte) ? 1 : 0;
+            Result.Register.Count = (Packed.Flags & PackedOperand_Wide) ? 2 : 1;
+        } break;
+        
+        case Operand_Memory:
+        {
+            if(Packed.Flags & PackedOperand_ExplicitSegment)
+            {
+                Result.Address.Flags = Address_ExplicitSegment;
+            }
+            else
+            {
+                for(u32 TermIndex = 0; TermIndex < ArrayCount(Result.Address.Terms); ++TermIndex)
+                {
+                    u32 Index = (Packed.Registers >> (4*TermIndex)) & 0xf;
+                    Result.Address.Terms[TermIndex].Register = RegisterAccess(Index, 0, 2);
+                    Result.Address.Terms[TermIndex].Scale = 1;
+                }
+            }
+            
+            Result.Address.Displacement = UnpackValue(Packed.Value, Packed.Flags);
+        } break;
+        
+        case Operand_Immediate:
+        {
+            Result.Immediate.Value = UnpackValue(Packed.Value, Packed.Flags);
+            if(Packed.Flags & PackedOperand_RelativeJumpDisplacement)
+            {
+                Result.Immediate.Flags = Immediate_RelativeJumpDisplacement;
+            }
+        } break;
+    }
+    
+    return Result;
+}
+
+static packed_instruction PackInstruction(instruction Instruction)
+{
+    packed_instruction Result = {};
+    
+    assert((Instruction.Op <= 0xff) && (Instruction.Size <= 0xff) &&
+           (Instruction.Flags <= 0xff) && (Instruction.SegmentOverride <= 0xff));
+    
+    Result.Address = Instruction.Address;
+    Result.Op = (u8)Instruction.Op;
+    Result.Size = (u8)Instruction.Size;
+    Result.Flags = (u8)Instruction.Flags;
+    Result.SegmentOverride = (u8)Instruction.SegmentOverride;
+    
+    for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Instruction.Operands); ++OperandIndex)
+    {
+        Result.Operands[OperandIndex] = PackOperand(Instruction.Operands[OperandIndex]);
+    }
+    
+    instruction_operand First = Instruction.Operands[0];
+    if((First.Type == Operand_Memory) && (First.Address.Flags & Address_ExplicitSegment))
+    {
+        assert((Instruction.Operands[1].Type == Operand_None) && (First.Address.ExplicitSegment <= 0xffff));
+        Result.Operands[1].Value = (u16)First.Address.ExplicitSegment;
+    }
+    else
+    {
+        assert(!((Instruction.Operands[1].Type == Operand_Memory) &&
+                 (Instruction.Operands[1].Address.Flags & Address_ExplicitSegment)));
+    }
+    
+    return Result;
+}
+
+static instruction UnpackInstruction(packed_instruction Packed)
+{
+    instruction Result = {};
+    
+    Result.Address = Packed.Address;
+    Result.Size = Packed.Size;
+    Result.Op = (operation_type)Packed.Op;
+    Result.Flags = Packed.Flags;
+    Result.SegmentOverride = Packed.SegmentOverride;
+    
+    if(Packed.Operands[0].Flags & PackedOperand_ExplicitSegment)
+    {
+        Result.Operands[0] = UnpackOperand(Packed.Operands[0]);
+        Result.Operands[0].Address.ExplicitSegment = Packed.Operands[1].Value;
+    }
+    else
+    {
+        for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Result.Operands); ++OperandIndex)
+        {
+            Result.Operands[OperandIndex] = UnpackOperand(Packed.Operands[OperandIndex]);
+        }
+    }
+    
+    return Result;
+}
+
+// NOTE(chuck): Jumps, calls and loops with a relative displacement always keep it in their last
+// operand, and it is relative to the end of the instruction.
+static b32 GetRelativeJumpTarget(instruction Instruction, u32 *Target)
+{
+    b32 Result = false;
+    
+    for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Instruction.Operands); ++OperandIndex)
+    {
+        instruction_operand Operand = Instruction.Operands[OperandIndex];
+        if((Operand.Type == Operand_Immediate) && (Operand.Immediate.Flags & Immediate_RelativeJumpDisplacement))
+        {
+            *Target = Instruction.Address + Instruction.Size + Operand.Immediate.Value;
+            Result = true;
+        }
+    }
+    
+    return Result;
+}
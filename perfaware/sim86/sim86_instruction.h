@@ -30,6 +30,28 @@ enum instruction_flag : u32
     Inst_Far = 0x10,
 };
 
+enum register_mapping_8086
+{
+    Register_none,
+    
+    Register_a,
+    Register_b,
+    Register_c,
+    Register_d,
+    Register_sp,
+    Register_bp,
+    Register_si,
+    Register_di,
+    Register_es,
+    Register_cs,
+    Register_ss,
+    Register_ds,
+    Register_ip,
+    Register_flags,
+    
+    Register_count,
+};
+
 struct register_access
 {
     u32 Index;
@@ -95,3 +117,40 @@ struct instruction
     
     u32 SegmentOverride;
 };
+
+/* NOTE(chuck): packed_instruction is a 16-byte form of instruction, for holding large decoded
+   programs in arrays. It only covers what the 8086 decoder produces: register operands are 8 or
+   16-bit accesses, effective addresses have at most two unscaled register terms, and immediates and
+   displacements fit in 16 bits plus a sign. PackInstruction asserts if it is handed anything else,
+   and UnpackInstruction gives back exactly what was packed.
+   
+   The explicit segment of a far address is kept in the Value of the second operand, because far
+   jumps and calls never have a second operand.
+*/
+
+enum packed_operand_flag : u8
+{
+    PackedOperand_TypeMask = 0x3, // NOTE(chuck): The low bits hold the operand_type
+    PackedOperand_Negative = 0x4, // NOTE(chuck): Value holds the low 16 bits of a negative number
+    PackedOperand_RelativeJumpDisplacement = 0x8,
+    PackedOperand_ExplicitSegment = 0x10,
+    PackedOperand_HighByte = 0x20, // NOTE(chuck): register_access Offset of 1
+    PackedOperand_Wide = 0x40, // NOTE(chuck): register_access Count of 2
+};
+struct packed_operand
+{
+    u8 Flags;
+    u8 Registers; // NOTE(chuck): Register index, or both effective address terms (term 0 in the low 4 bits)
+    u16 Value;
+};
+
+struct packed_instruction
+{
+    u32 Address;
+    u8 Op;
+    u8 Size;
+    u8 Flags;
+    u8 SegmentOverride;
+    
+    packed_operand Operands[2];
+};
@@ -15,6 +15,13 @@ static instruction_encoding InstructionTable8086[] =
 #include "sim86_instruction_table.inl"
 };
 
+// NOTE(chuck): The same table again, but usable in constant expressions, so the decoder can build
+// a specialized decode function for each entry at compile time.
+static constexpr instruction_encoding InstructionTable8086Constant[] =
+{
+#include "sim86_instruction_table.inl"
+};
+
 static instruction_table Get8086InstructionTable()
 {
     instruction_table Result = {};
@@ -0,0 +1,967 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+#if SIM86_JIT
+
+#if _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+/* NOTE(chuck): How compiled blocks use the host registers:
+
+   rax, rcx, rdx, rbx  - guest ax, cx, dx, bx, so that ah, ch, dh and bh are there too
+   r8, r9, r10, r11    - guest sp, bp, si, di
+   r12                 - the base of guest memory
+   r13                 - the linear address of the current memory operand
+   r14                 - host flags from the last instruction whose flags are still needed
+   r15                 - the machine
+   rsi, rdi, rbp       - scratch
+
+   Only the low 16 bits of a guest register mean anything. The upper bits are whatever the host
+   left there, which is fine because nothing reads them: addresses get truncated to 16 bits before
+   they are used, and guest registers only ever get stored back as words.
+
+   Memory is always read and written a byte at a time, so that a word at the very top of memory
+   wraps around to the bottom the same way it does in the interpreter. And since ah, ch, dh and bh
+   can't be encoded in anything with a REX prefix, byte operations on memory go through rsi, which
+   doesn't need one. */
+
+enum host_register
+{
+    Host_rax,
+    Host_rcx,
+    Host_rdx,
+    Host_rbx,
+    Host_rsp,
+    Host_rbp,
+    Host_rsi,
+    Host_rdi,
+    Host_r8,
+    Host_r9,
+    Host_r10,
+    Host_r11,
+    Host_r12,
+    Host_r13,
+    Host_r14,
+    Host_r15,
+};
+
+enum host_operand_size
+{
+    Host_Byte,
+    Host_Word,
+    Host_Dword,
+    Host_Qword,
+};
+
+// NOTE(chuck): Memory operands are always encoded as base + index + disp32. An Index of Host_rsp means there is none.
+struct host_operand
+{
+    b32 IsMemory;
+    u32 Register;
+    u32 Index;
+    s32 Displacement;
+};
+
+struct jit_emitter
+{
+    u8 *Base;
+    u32 Used;
+    u32 Capacity;
+    b32 Overflowed;
+
+    machine *Machine;
+    u32 PendingFlags; // NOTE(chuck): Which guest flags r14 holds that haven't been written to the machine yet
+};
+
+static u32 const ARITHMETIC_FLAGS = (Flag_Carry | Flag_Parity | Flag_AuxiliaryCarry | Flag_Zero | Flag_Sign | Flag_Overflow);
+
+static u32 const GuestToHost[] =
+{
+    0,
+    Host_rax, // NOTE(chuck): Register_a
+    Host_rbx, // NOTE(chuck): Register_b
+    Host_rcx, // NOTE(chuck): Register_c
+    Host_rdx, // NOTE(chuck): Register_d
+    Host_r8, // NOTE(chuck): Register_sp
+    Host_r9, // NOTE(chuck): Register_bp
+    Host_r10, // NOTE(chuck): Register_si
+    Host_r11, // NOTE(chuck): Register_di
+};
+
+static u8 *AllocateExecutableMemory(u32 Size)
+{
+#if _WIN32
+    u8 *Result = (u8 *)VirtualAlloc(0, Size, MEM_RESERVE|MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+#else
+    u8 *Result = (u8 *)mmap(0, Size, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(Result == MAP_FAILED)
+    {
+        Result = 0;
+    }
+#endif
+
+    return Result;
+}
+
+static void FreeExecutableMemory(u8 *Memory, u32 Size)
+{
+    if(Memory)
+    {
+#if _WIN32
+        VirtualFree(Memory, 0, MEM_RELEASE);
+#else
+        munmap(Memory, Size);
+#endif
+    }
+}
+
+static void EmitByte(jit_emitter *Emitter, u32 Byte)
+{
+    if(Emitter->Used < Emitter->Capacity)
+    {
+        Emitter->Base[Emitter->Used++] = (u8)Byte;
+    }
+    else
+    {
+        Emitter->Overflowed = true;
+    }
+}
+
+static void EmitWord(jit_emitter *Emitter, u32 Value)
+{
+    EmitByte(Emitter, Value);
+    EmitByte(Emitter, Value >> 8);
+}
+
+static void EmitDword(jit_emitter *Emitter, u32 Value)
+{
+    EmitWord(Emitter, Value);
+    EmitWord(Emitter, Value >> 16);
+}
+
+static host_operand HostRegister(u32 Register)
+{
+    host_operand Result = {};
+    Result.Register = Register;
+    return Result;
+}
+
+static host_operand HostMemory(u32 Base, u32 Index, s32 Displacement)
+{
+    host_operand Result = {};
+    Result.IsMemory = true;
+    Result.Register = Base;
+    Result.Index = Index;
+    Result.Displacement = Displacement;
+    return Result;
+}
+
+static host_operand MachineField(u32 Offset)
+{
+    host_operand Result = HostMemory(Host_r15, Host_rsp, (s32)Offset);
+    return Result;
+}
+
+static u32 RegisterOffset(u32 Register)
+{
+    u32 Result = (u32)(offsetof(machine, Registers) + Register*sizeof(u16));
+    return Result;
+}
+
+/* NOTE(chuck): Opcodes above 0xff are two bytes, high byte first. ForceRex is for the low bytes of
+   rsi and rdi, which share their encodings with dh and bh when there is no REX prefix. */
+static void EmitInstruction(jit_emitter *Emitter, host_operand_size Size, u32 Opcode, u32 Reg, host_operand Operand, b32 ForceRex = false)
+{
+    if(Size == Host_Word)
+    {
+        EmitByte(Emitter, 0x66);
+    }
+
+    u32 Rex = 0;
+    if(Size == Host_Qword)
+    {
+        Rex |= 0x8;
+    }
+    if(Reg & 8)
+    {
+        Rex |= 0x4;
+    }
+    if(Operand.IsMemory && (Operand.Index & 8))
+    {
+        Rex |= 0x2;
+    }
+    if(Operand.Register & 8)
+    {
+        Rex |= 0x1;
+    }
+    if(Rex || ForceRex)
+    {
+        EmitByte(Emitter, 0x40 | Rex);
+    }
+
+    if(Opcode > 0xff)
+    {
+        EmitByte(Emitter, Opcode >> 8);
+    }
+    EmitByte(Emitter, Opcode);
+
+    if(Operand.IsMemory)
+    {
+        EmitByte(Emitter, 0x84 | ((Reg & 7) << 3));
+        EmitByte(Emitter, ((Operand.Index & 7) << 3) | (Operand.Register & 7));
+        EmitDword(Emitter, (u32)Operand.Displacement);
+    }
+    else
+    {
+        EmitByte(Emitter, 0xc0 | ((Reg & 7) << 3) | (Operand.Register & 7));
+    }
+}
+
+static void EmitImmediate(jit_emitter *Emitter, host_operand_size Size, u32 Value)
+{
+    switch(Size)
+    {
+        case Host_Byte: {EmitByte(Emitter, Value);} break;
+        case Host_Word: {EmitWord(Emitter, Value);} break;
+        default: {EmitDword(Emitter, Value);} break;
+    }
+}
+
+// NOTE(chuck): and, or, shl, shr and friends on a dword register with a 32-bit immediate.
+static void EmitDwordImmediate(jit_emitter *Emitter, u32 Opcode, u32 Digit, u32 Register, u32 Value)
+{
+    EmitInstruction(Emitter, Host_Dword, Opcode, Digit, HostRegister(Register));
+    if(Opcode == 0xc1)
+    {
+        EmitByte(Emitter, Value);
+    }
+    else
+    {
+        EmitDword(Emitter, Value);
+    }
+}
+
+// NOTE(chuck): Emits a jcc or jmp with a 32-bit displacement to be filled in later by PatchJump.
+static u32 EmitJump(jit_emitter *Emitter, u32 Opcode)
+{
+    if(Opcode > 0xff)
+    {
+        EmitByte(Emitter, Opcode >> 8);
+    }
+    EmitByte(Emitter, Opcode);
+    u32 Result = Emitter->Used;
+    EmitDword(Emitter, 0);
+    return Result;
+}
+
+static void PatchJump(jit_emitter *Emitter, u32 At)
+{
+    if(!Emitter->Overflowed)
+    {
+        u32 Displacement = Emitter->Used - (At + 4);
+        memcpy(Emitter->Base + At, &Displacement, 4);
+    }
+}
+
+static void EmitCaptureFlags(jit_emitter *Emitter)
+{
+    EmitByte(Emitter, 0x9c); // NOTE(chuck): pushfq
+    EmitByte(Emitter, 0x41); // NOTE(chuck): pop r14
+    EmitByte(Emitter, 0x5e);
+}
+
+static void EmitMergeFlags(jit_emitter *Emitter, u32 Mask)
+{
+    if(Mask)
+    {
+        host_operand Flags = MachineField(RegisterOffset(Register_flags));
+        EmitInstruction(Emitter, Host_Dword, 0x0fb7, Host_rsi, Flags);
+        EmitDwordImmediate(Emitter, 0x81, 4, Host_rsi, ~Mask);
+        EmitInstruction(Emitter, Host_Dword, 0x89, Host_r14, HostRegister(Host_rdi));
+        EmitDwordImmediate(Emitter, 0x81, 4, Host_rdi, Mask);
+        EmitInstruction(Emitter, Host_Dword, 0x09, Host_rdi, HostRegister(Host_rsi));
+        EmitInstruction(Emitter, Host_Word, 0x89, Host_rsi, Flags);
+    }
+}
+
+static void EmitPrologue(jit_emitter *Emitter)
+{
+    // NOTE(chuck): Everything either ABI says to preserve, since the block uses all of it.
+    u8 Pushes[] = {0x53, 0x55, 0x56, 0x57, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57};
+    for(u32 Index = 0; Index < ArrayCount(Pushes); ++Index)
+    {
+        EmitByte(Emitter, Pushes[Index]);
+    }
+
+#if _WIN32
+    EmitInstruction(Emitter, Host_Qword, 0x89, Host_rcx, HostRegister(Host_r15));
+#else
+    EmitInstruction(Emitter, Host_Qword, 0x89, Host_rdi, HostRegister(Host_r15));
+#endif
+
+    u32 MemoryOffset = (u32)(offsetof(machine, Memory) + offsetof(segmented_access, Memory));
+    EmitInstruction(Emitter, Host_Qword, 0x8b, Host_r12, MachineField(MemoryOffset));
+    for(u32 Register = Register_a; Register <= Register_di; ++Register)
+    {
+        EmitInstruction(Emitter, Host_Dword, 0x0fb7, GuestToHost[Register], MachineField(RegisterOffset(Register)));
+    }
+}
+
+// NOTE(chuck): Leaves the block with IP moved IPAdvance bytes past where the block started.
+static void EmitExit(jit_emitter *Emitter, u32 IPAdvance, u32 Executed)
+{
+    if(IPAdvance & 0xffff)
+    {
+        EmitInstruction(Emitter, Host_Word, 0x81, 0, MachineField(RegisterOffset(Register_ip)));
+        EmitWord(Emitter, IPAdvance);
+    }
+
+    for(u32 Register = Register_a; Register <= Register_di; ++Register)
+    {
+        EmitInstruction(Emitter, Host_Word, 0x89, GuestToHost[Register], MachineField(RegisterOffset(Register)));
+    }
+
+    EmitByte(Emitter, 0xb8); // NOTE(chuck): mov eax, Executed
+    EmitDword(Emitter, Executed);
+
+    u8 Pops[] = {0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5f, 0x5e, 0x5d, 0x5b};
+    for(u32 Index = 0; Index < ArrayCount(Pops); ++Index)
+    {
+        EmitByte(Emitter, Pops[Index]);
+    }
+    EmitByte(Emitter, 0xc3);
+}
+
+// NOTE(chuck): Puts the linear address of a memory operand in r13, the same way GetEffectiveAddress works it out.
+static void EmitEffectiveAddress(jit_emitter *Emitter, instruction *Instruction, effective_address_expression Address)
+{
+    u32 First = Address.Terms[0].Register.Index;
+    u32 Second = Address.Terms[1].Register.Index;
+    if(First || Second)
+    {
+        u32 Base = First ? GuestToHost[First] : GuestToHost[Second];
+        u32 Index = (First && Second) ? GuestToHost[Second] : (u32)Host_rsp;
+        EmitInstruction(Emitter, Host_Dword, 0x8d, Host_r13, HostMemory(Base, Index, Address.Displacement));
+        EmitInstruction(Emitter, Host_Dword, 0x0fb7, Host_r13, HostRegister(Host_r13));
+    }
+    else
+    {
+        EmitInstruction(Emitter, Host_Dword, 0xc7, 0, HostRegister(Host_r13));
+        EmitDword(Emitter, (u32)Address.Displacement & 0xffff);
+    }
+
+    u32 DefaultSegment = (First == Register_bp) ? Register_ss : Register_ds;
+    u32 Segment = GetDataSegment(Instruction, DefaultSegment);
+    EmitInstruction(Emitter, Host_Dword, 0x0fb7, Host_rsi, MachineField(RegisterOffset(Segment)));
+    EmitDwordImmediate(Emitter, 0xc1, 4, Host_rsi, 4);
+    EmitInstruction(Emitter, Host_Dword, 0x01, Host_rsi, HostRegister(Host_r13));
+    EmitDwordImmediate(Emitter, 0x81, 4, Host_r13, Emitter->Machine->Memory.Mask);
+}
+
+// NOTE(chuck): Puts the linear address Offset bytes past r13 in Register, wrapped to the size of memory.
+static void EmitNextAddress(jit_emitter *Emitter, u32 Register, s32 Offset)
+{
+    EmitInstruction(Emitter, Host_Dword, 0x8d, Register, HostMemory(Host_r13, Host_rsp, Offset));
+    EmitDwordImmediate(Emitter, 0x81, 4, Register, Emitter->Machine->Memory.Mask);
+}
+
+/* NOTE(chuck): A store into bytes that some cached block was decoded from has to go through the
+   interpreter, so that the cache gets dropped. The compiled code checks before the instruction
+   does anything, and if it would hit one, leaves with everything as it was after the previous
+   instruction so that RunBlocks can step it. */
+static void EmitCodeWriteCheck(jit_emitter *Emitter, b32 Wide, u32 IPAdvance, u32 Executed)
+{
+    u32 CodeMapOffset = (u32)offsetof(block_cache, CodeMap);
+    EmitInstruction(Emitter, Host_Qword, 0x8b, Host_rsi, MachineField((u32)offsetof(machine, Blocks)));
+
+    u32 Skips[2] = {};
+    u32 ByteCount = Wide ? 2 : 1;
+    for(u32 ByteIndex = 0; ByteIndex < ByteCount; ++ByteIndex)
+    {
+        EmitNextAddress(Emitter, Host_rdi, ByteIndex);
+        EmitInstruction(Emitter, Host_Dword, 0x89, Host_rdi, HostRegister(Host_rbp));
+        EmitDwordImmediate(Emitter, 0xc1, 5, Host_rdi, 3);
+        EmitInstruction(Emitter, Host_Dword, 0x0fb6, Host_rdi, HostMemory(Host_rsi, Host_rdi, (s32)CodeMapOffset));
+        EmitDwordImmediate(Emitter, 0x81, 4, Host_rbp, 7);
+        EmitInstruction(Emitter, Host_Dword, 0x0fa3, Host_rbp, HostRegister(Host_rdi));
+        Skips[ByteIndex] = EmitJump(Emitter, 0x0f82);
+    }
+
+    u32 OverExit = EmitJump(Emitter, 0xe9);
+    for(u32 ByteIndex = 0; ByteIndex < ByteCount; ++ByteIndex)
+    {
+        PatchJump(Emitter, Skips[ByteIndex]);
+    }
+    EmitMergeFlags(Emitter, Emitter->PendingFlags);
+    EmitExit(Emitter, IPAdvance, Executed);
+    PatchJump(Emitter, OverExit);
+}
+
+// NOTE(chuck): Loads the word at r13 into edi.
+static void EmitLoadWord(jit_emitter *Emitter)
+{
+    EmitInstruction(Emitter, Host_Dword, 0x0fb6, Host_rdi, HostMemory(Host_r12, Host_r13, 0));
+    EmitNextAddress(Emitter, Host_rbp, 1);
+    EmitInstruction(Emitter, Host_Dword, 0x0fb6, Host_rbp, HostMemory(Host_r12, Host_rbp, 0));
+    EmitDwordImmediate(Emitter, 0xc1, 4, Host_rbp, 8);
+    EmitInstruction(Emitter, Host_Dword, 0x09, Host_rbp, HostRegister(Host_rdi));
+}
+
+// NOTE(chuck): Stores di to the word at r13.
+static void EmitStoreWord(jit_emitter *Emitter)
+{
+    EmitInstruction(Emitter, Host_Byte, 0x88, Host_rdi, HostMemory(Host_r12, Host_r13, 0), true);
+    EmitNextAddress(Emitter, Host_rbp, 1);
+    EmitDwordImmediate(Emitter, 0xc1, 5, Host_rdi, 8);
+    EmitInstruction(Emitter, Host_Byte, 0x88, Host_rdi, HostMemory(Host_r12, Host_rbp, 0), true);
+}
+
+// NOTE(chuck): Byte operations on memory go through rsi (see the note at the top).
+static void EmitBytePointer(jit_emitter *Emitter)
+{
+    EmitInstruction(Emitter, Host_Qword, 0x8d, Host_rsi, HostMemory(Host_r12, Host_r13, 0));
+}
+
+static b32 IsGeneralRegister(instruction_operand *Operand, b32 Wide)
+{
+    register_access Register = Operand->Register;
+    b32 Result = ((Register.Index >= Register_a) && (Register.Index <= Register_di) &&
+                  (Register.Count == (Wide ? 2u : 1u)) &&
+                  (Wide || (Register.Index <= Register_d)));
+    return Result;
+}
+
+// NOTE(chuck): Host register number for a guest register operand. For bytes, 4-7 are ah, ch, dh and bh.
+static u32 GetHostRegister(register_access Register)
+{
+    u32 Result = GuestToHost[Register.Index] + 4*Register.Offset;
+    return Result;
+}
+
+static b32 IsCompilableOperand(instruction_operand *Operand, b32 Wide)
+{
+    b32 Result = false;
+    switch(Operand->Type)
+    {
+        case Operand_Register: {Result = IsGeneralRegister(Operand, Wide);} break;
+        case Operand_Memory: {Result = !(Operand->Address.Flags & Address_ExplicitSegment);} break;
+        case Operand_Immediate: {Result = true;} break;
+        default: {} break;
+    }
+    return Result;
+}
+
+static b32 IsRelativeBranch(operation_type Op)
+{
+    b32 Result = false;
+    switch(Op)
+    {
+        case Op_jmp:
+        case Op_je:
+        case Op_jl:
+        case Op_jle:
+        case Op_jb:
+        case Op_jbe:
+        case Op_jp:
+        case Op_jo:
+        case Op_js:
+        case Op_jne:
+        case Op_jnl:
+        case Op_jg:
+        case Op_jnb:
+        case Op_ja:
+        case Op_jnp:
+        case Op_jno:
+        case Op_jns:
+        case Op_loop:
+        case Op_loopz:
+        case Op_loopnz:
+        case Op_jcxz:
+        {
+            Result = true;
+        } break;
+
+        default: {} break;
+    }
+    return Result;
+}
+
+/* NOTE(chuck): The JIT only takes on the instructions that loops are made of. A block with anything
+   else in it stays on the threaded interpreter. */
+static b32 CanCompile(instruction *Instruction)
+{
+    instruction_operand *Dest = &Instruction->Operands[0];
+    instruction_operand *Source = &Instruction->Operands[1];
+    b32 Wide = IsWide(Instruction);
+
+    b32 Result = false;
+    switch(Instruction->Op)
+    {
+        case Op_mov:
+        case Op_add:
+        case Op_sub:
+        case Op_cmp:
+        case Op_and:
+        case Op_test:
+        case Op_or:
+        case Op_xor:
+        {
+            Result = ((Dest->Type != Operand_Immediate) &&
+                      IsCompilableOperand(Dest, Wide) && IsCompilableOperand(Source, Wide) &&
+                      !((Dest->Type == Operand_Memory) && (Source->Type == Operand_Memory)));
+        } break;
+
+        case Op_inc:
+        case Op_dec:
+        {
+            instruction_operand *Operand = GetSingleOperand(Instruction);
+            Result = (Operand->Type != Operand_Immediate) && IsCompilableOperand(Operand, Wide);
+        } break;
+
+        default:
+        {
+            Result = (IsRelativeBranch(Instruction->Op) && (Dest->Type == Operand_Immediate) &&
+                      !(Instruction->Flags & Inst_Far));
+        } break;
+    }
+
+    return Result;
+}
+
+static u32 GetDefinedFlags(operation_type Op)
+{
+    u32 Result = 0;
+    switch(Op)
+    {
+        case Op_add:
+        case Op_sub:
+        case Op_cmp:
+        case Op_and:
+        case Op_test:
+        case Op_or:
+        case Op_xor:
+        {
+            Result = ARITHMETIC_FLAGS;
+        } break;
+
+        case Op_inc:
+        case Op_dec:
+        {
+            Result = ARITHMETIC_FLAGS & ~Flag_Carry;
+        } break;
+
+        default: {} break;
+    }
+    return Result;
+}
+
+static b32 WritesMemory(instruction *Instruction)
+{
+    b32 Result = ((GetSingleOperand(Instruction)->Type == Operand_Memory) &&
+                  (Instruction->Op != Op_cmp) && (Instruction->Op != Op_test));
+    return Result;
+}
+
+/* NOTE(chuck): r14 can only hold one instruction's flags. Before an instruction whose flags are
+   needed overwrites it, whatever r14 still holds that this instruction won't replace gets written
+   out to the machine. This has to happen before the instruction, since writing them out changes the
+   host's flags. */
+static void EmitFlagsBefore(jit_emitter *Emitter, operation_type Op, u32 Needed)
+{
+    u32 Defined = GetDefinedFlags(Op);
+    if(Needed)
+    {
+        EmitMergeFlags(Emitter, Emitter->PendingFlags & ~Defined);
+        Emitter->PendingFlags &= Defined;
+    }
+}
+
+/* NOTE(chuck): Host flags come out of the same instruction the guest is running, and the 8086 lays
+   out its arithmetic flags exactly like x86-64 does, so they can be copied straight across. The
+   only difference is that the host leaves auxiliary carry undefined after a logic op, where the
+   interpreter clears it. */
+static void EmitFlagsAfter(jit_emitter *Emitter, operation_type Op, u32 Needed)
+{
+    if(Needed)
+    {
+        EmitCaptureFlags(Emitter);
+        if((Op == Op_and) || (Op == Op_test) || (Op == Op_or) || (Op == Op_xor))
+        {
+            EmitDwordImmediate(Emitter, 0x81, 4, Host_r14, ~(u32)Flag_AuxiliaryCarry);
+        }
+        Emitter->PendingFlags = Needed;
+    }
+    else
+    {
+        Emitter->PendingFlags &= ~GetDefinedFlags(Op);
+    }
+}
+
+struct host_opcodes
+{
+    u32 RegisterToDest; // NOTE(chuck): op r/m, r
+    u32 DestFromRegister; // NOTE(chuck): op r, r/m
+    u32 Immediate;
+    u32 ImmediateDigit;
+};
+
+static host_opcodes GetHostOpcodes(operation_type Op, b32 Wide)
+{
+    host_opcodes Result = {};
+    u32 Digit = 0;
+    switch(Op)
+    {
+        case Op_add: {Digit = 0;} break;
+        case Op_or: {Digit = 1;} break;
+        case Op_and: {Digit = 4;} break;
+        case Op_sub: {Digit = 5;} break;
+        case Op_xor: {Digit = 6;} break;
+        case Op_cmp: {Digit = 7;} break;
+        default: {} break;
+    }
+
+    if(Op == Op_mov)
+    {
+        Result.RegisterToDest = 0x88;
+        Result.DestFromRegister = 0x8a;
+        Result.Immediate = 0xc6;
+    }
+    else if(Op == Op_test)
+    {
+        // NOTE(chuck): test doesn't write anything, so it doesn't matter which way around it goes.
+        Result.RegisterToDest = 0x84;
+        Result.DestFromRegister = 0x84;
+        Result.Immediate = 0xf6;
+    }
+    else
+    {
+        Result.RegisterToDest = 8*Digit;
+        Result.DestFromRegister = 8*Digit + 2;
+        Result.Immediate = 0x80;
+        Result.ImmediateDigit = Digit;
+    }
+
+    if(Wide)
+    {
+        Result.RegisterToDest += 1;
+        Result.DestFromRegister += 1;
+        Result.Immediate += 1;
+    }
+
+    return Result;
+}
+
+static void EmitTwoOperand(jit_emitter *Emitter, instruction *Instruction, u32 Needed)
+{
+    instruction_operand *Dest = &Instruction->Operands[0];
+    instruction_operand *Source = &Instruction->Operands[1];
+    b32 Wide = IsWide(Instruction);
+    host_operand_size Size = Wide ? Host_Word : Host_Byte;
+    host_opcodes Opcodes = GetHostOpcodes(Instruction->Op, Wide);
+    u32 Immediate = (u32)Source->Immediate.Value & (Wide ? 0xffff : 0xff);
+
+    if(Dest->Type == Operand_Register)
+    {
+        host_operand Target = HostRegister(GetHostRegister(Dest->Register));
+        if(Source->Type == Operand_Register)
+        {
+            EmitInstruction(Emitter, Size, Opcodes.RegisterToDest, GetHostRegister(Source->Register), Target);
+        }
+        else if(Source->Type == Operand_Immediate)
+        {
+            EmitInstruction(Emitter, Size, Opcodes.Immediate, Opcodes.ImmediateDigit, Target);
+            EmitImmediate(Emitter, Size, Immediate);
+        }
+        else if(Wide)
+        {
+            EmitLoadWord(Emitter);
+            EmitInstruction(Emitter, Size, Opcodes.RegisterToDest, Host_rdi, Target);
+        }
+        else
+        {
+            EmitBytePointer(Emitter);
+            EmitInstruction(Emitter, Size, Opcodes.DestFromRegister, Target.Register, HostMemory(Host_rsi, Host_rsp, 0));
+        }
+    }
+    else if(Wide)
+    {
+        // NOTE(chuck): Word memory destinations get done in di and stored back.
+        if(Instruction->Op != Op_mov)
+        {
+            EmitLoadWord(Emitter);
+        }
+
+        if(Source->Type == Operand_Register)
+        {
+            EmitInstruction(Emitter, Size, Opcodes.RegisterToDest, GetHostRegister(Source->Register), HostRegister(Host_rdi));
+        }
+        else
+        {
+            EmitInstruction(Emitter, Size, Opcodes.Immediate, Opcodes.ImmediateDigit, HostRegister(Host_rdi));
+            EmitImmediate(Emitter, Size, Immediate);
+        }
+    }
+    else
+    {
+        EmitBytePointer(Emitter);
+        host_operand Target = HostMemory(Host_rsi, Host_rsp, 0);
+        if(Source->Type == Operand_Register)
+        {
+            EmitInstruction(Emitter, Size, Opcodes.RegisterToDest, GetHostRegister(Source->Register), Target);
+        }
+        else
+        {
+            EmitInstruction(Emitter, Size, Opcodes.Immediate, Opcodes.ImmediateDigit, Target);
+            EmitImmediate(Emitter, Size, Immediate);
+        }
+    }
+
+    EmitFlagsAfter(Emitter, Instruction->Op, Needed);
+
+    if(Wide && (Dest->Type == Operand_Memory) && WritesMemory(Instruction))
+    {
+        EmitStoreWord(Emitter);
+    }
+}
+
+static void EmitIncDec(jit_emitter *Emitter, instruction *Instruction, u32 Needed)
+{
+    instruction_operand *Operand = GetSingleOperand(Instruction);
+    b32 Wide = IsWide(Instruction);
+    host_operand_size Size = Wide ? Host_Word : Host_Byte;
+    u32 Opcode = Wide ? 0xff : 0xfe;
+    u32 Digit = (Instruction->Op == Op_inc) ? 0 : 1;
+
+    if(Operand->Type == Operand_Register)
+    {
+        EmitInstruction(Emitter, Size, Opcode, Digit, HostRegister(GetHostRegister(Operand->Register)));
+        EmitFlagsAfter(Emitter, Instruction->Op, Needed);
+    }
+    else if(Wide)
+    {
+        EmitLoadWord(Emitter);
+        EmitInstruction(Emitter, Size, Opcode, Digit, HostRegister(Host_rdi));
+        EmitFlagsAfter(Emitter, Instruction->Op, Needed);
+        EmitStoreWord(Emitter);
+    }
+    else
+    {
+        EmitBytePointer(Emitter);
+        EmitInstruction(Emitter, Size, Opcode, Digit, HostMemory(Host_rsi, Host_rsp, 0));
+        EmitFlagsAfter(Emitter, Instruction->Op, Needed);
+    }
+}
+
+// NOTE(chuck): The 8086 condition codes are the same as the host's, so the condition can be tested with the guest's own flags loaded.
+static u32 GetHostConditionCode(operation_type Op)
+{
+    u32 Result = 0;
+    switch(Op)
+    {
+        case Op_jo: {Result = 0x0;} break;
+        case Op_jno: {Result = 0x1;} break;
+        case Op_jb: {Result = 0x2;} break;
+        case Op_jnb: {Result = 0x3;} break;
+        case Op_je: {Result = 0x4;} break;
+        case Op_jne: {Result = 0x5;} break;
+        case Op_jbe: {Result = 0x6;} break;
+        case Op_ja: {Result = 0x7;} break;
+        case Op_js: {Result = 0x8;} break;
+        case Op_jns: {Result = 0x9;} break;
+        case Op_jp: {Result = 0xa;} break;
+        case Op_jnp: {Result = 0xb;} break;
+        case Op_jl: {Result = 0xc;} break;
+        case Op_jnl: {Result = 0xd;} break;
+        case Op_jle: {Result = 0xe;} break;
+        case Op_jg: {Result = 0xf;} break;
+        default: {} break;
+    }
+    return Result;
+}
+
+// NOTE(chuck): Offset is where the branch starts, relative to the start of the block.
+static void EmitBranch(jit_emitter *Emitter, instruction *Instruction, u32 Offset, u32 Executed)
+{
+    EmitMergeFlags(Emitter, Emitter->PendingFlags);
+    Emitter->PendingFlags = 0;
+
+    u32 NotTaken = Offset + Instruction->Size;
+    u32 Taken = NotTaken + (u32)Instruction->Operands[0].Immediate.Value;
+    host_operand Flags = MachineField(RegisterOffset(Register_flags));
+    host_operand CX = HostRegister(Host_rcx);
+
+    u32 SkipTaken[2] = {};
+    u32 SkipCount = 0;
+    switch(Instruction->Op)
+    {
+        case Op_jmp: {} break;
+
+        case Op_loop:
+        case Op_loopz:
+        case Op_loopnz:
+        {
+            // NOTE(chuck): lea, so that the decrement doesn't touch the flags.
+            EmitInstruction(Emitter, Host_Dword, 0x8d, Host_rcx, HostMemory(Host_rcx, Host_rsp, -1));
+            EmitInstruction(Emitter, Host_Word, 0x85, Host_rcx, CX);
+            SkipTaken[SkipCount++] = EmitJump(Emitter, 0x0f84);
+            if(Instruction->Op != Op_loop)
+            {
+                EmitInstruction(Emitter, Host_Word, 0xf7, 0, Flags);
+                EmitWord(Emitter, Flag_Zero);
+                SkipTaken[SkipCount++] = EmitJump(Emitter, (Instruction->Op == Op_loopz) ? 0x0f84 : 0x0f85);
+            }
+        } break;
+
+        case Op_jcxz:
+        {
+            EmitInstruction(Emitter, Host_Word, 0x85, Host_rcx, CX);
+            SkipTaken[SkipCount++] = EmitJump(Emitter, 0x0f85);
+        } break;
+
+        default:
+        {
+            // NOTE(chuck): Only the arithmetic flags go into the host's flags. Trap and direction would change how the host runs.
+            EmitInstruction(Emitter, Host_Dword, 0x0fb7, Host_rsi, Flags);
+            EmitDwordImmediate(Emitter, 0x81, 4, Host_rsi, ARITHMETIC_FLAGS);
+            EmitByte(Emitter, 0x56); // NOTE(chuck): push rsi
+            EmitByte(Emitter, 0x9d); // NOTE(chuck): popfq
+            u32 ToTaken = EmitJump(Emitter, 0x0f80 | GetHostConditionCode(Instruction->Op));
+            EmitExit(Emitter, NotTaken, Executed);
+            PatchJump(Emitter, ToTaken);
+        } break;
+    }
+
+    EmitExit(Emitter, Taken, Executed);
+    if(SkipCount)
+    {
+        for(u32 SkipIndex = 0; SkipIndex < SkipCount; ++SkipIndex)
+        {
+            PatchJump(Emitter, SkipTaken[SkipIndex]);
+        }
+        EmitExit(Emitter, NotTaken, Executed);
+    }
+}
+
+/* NOTE(chuck): Flags only get computed where something can see them. Going backwards through the
+   block, an instruction's flags are needed if nothing after it sets them again before the block
+   ends. Every flag counts as needed at the end of the block, and before any store, since the block
+   can leave there too. */
+static compiled_block *CompileBlock(machine *Machine, block_cache *Cache, code_block *Block)
+{
+    compiled_block *Result = 0;
+
+    b32 Compilable = (Cache->JitCode != 0);
+    for(u32 OpIndex = 0; Compilable && (OpIndex < Block->OpCount); ++OpIndex)
+    {
+        Compilable = CanCompile(&Block->Ops[OpIndex].Instruction);
+    }
+
+    if(Compilable)
+    {
+        u32 Needed[MAX_BLOCK_OPS];
+        u32 Live = ARITHMETIC_FLAGS;
+        for(u32 OpIndex = Block->OpCount; OpIndex-- > 0;)
+        {
+            instruction *Instruction = &Block->Ops[OpIndex].Instruction;
+            u32 Defined = GetDefinedFlags(Instruction->Op);
+            Needed[OpIndex] = Defined & Live;
+            Live &= ~Defined;
+            if(WritesMemory(Instruction))
+            {
+                Live = ARITHMETIC_FLAGS;
+            }
+        }
+
+        jit_emitter Emitter = {};
+        Emitter.Base = Cache->JitCode + Cache->JitUsed;
+        Emitter.Capacity = JIT_CODE_SIZE - Cache->JitUsed;
+        Emitter.Machine = Machine;
+
+        EmitPrologue(&Emitter);
+
+        u32 Offset = 0;
+        b32 EndedWithBranch = false;
+        for(u32 OpIndex = 0; OpIndex < Block->OpCount; ++OpIndex)
+        {
+            instruction *Instruction = &Block->Ops[OpIndex].Instruction;
+            instruction_operand *Memory = 0;
+            for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Instruction->Operands); ++OperandIndex)
+            {
+                if(Instruction->Operands[OperandIndex].Type == Operand_Memory)
+                {
+                    Memory = &Instruction->Operands[OperandIndex];
+                }
+            }
+
+            EmitFlagsBefore(&Emitter, Instruction->Op, Needed[OpIndex]);
+            if(Memory)
+            {
+                EmitEffectiveAddress(&Emitter, Instruction, Memory->Address);
+                if(WritesMemory(Instruction))
+                {
+                    EmitCodeWriteCheck(&Emitter, IsWide(Instruction), Offset, OpIndex);
+                }
+            }
+
+            if(IsRelativeBranch(Instruction->Op))
+            {
+                EmitBranch(&Emitter, Instruction, Offset, OpIndex + 1);
+                EndedWithBranch = true;
+            }
+            else if((Instruction->Op == Op_inc) || (Instruction->Op == Op_dec))
+            {
+                EmitIncDec(&Emitter, Instruction, Needed[OpIndex]);
+            }
+            else
+            {
+                EmitTwoOperand(&Emitter, Instruction, Needed[OpIndex]);
+            }
+
+            Offset += Instruction->Size;
+        }
+
+        if(!EndedWithBranch)
+        {
+            EmitMergeFlags(&Emitter, Emitter.PendingFlags);
+            EmitExit(&Emitter, Offset, Block->OpCount);
+        }
+
+        if(!Emitter.Overflowed)
+        {
+            Result = (compiled_block *)Emitter.Base;
+            Cache->JitUsed += Emitter.Used;
+        }
+    }
+
+    return Result;
+}
+
+#else
+
+static u8 *AllocateExecutableMemory(u32 Size)
+{
+    return 0;
+}
+
+static void FreeExecutableMemory(u8 *Memory, u32 Size)
+{
+}
+
+static compiled_block *CompileBlock(machine *Machine, block_cache *Cache, code_block *Block)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,27 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+/* NOTE(chuck): The JIT only knows how to write x86-64 code. Anywhere else, or when it is compiled
+   with SIM86_JIT set to 0, every block stays on the threaded interpreter. */
+#ifndef SIM86_JIT
+#if defined(_M_X64) || defined(__x86_64__)
+#define SIM86_JIT 1
+#else
+#define SIM86_JIT 0
+#endif
+#endif
+
+static u32 const JIT_CODE_SIZE = 4*1024*1024;
+
+static u8 *AllocateExecutableMemory(u32 Size);
+static void FreeExecutableMemory(u8 *Memory, u32 Size);
+static compiled_block *CompileBlock(machine *Machine, block_cache *Cache, code_block *Block);
@@ -12,21 +12,28 @@
 
 #include <assert.h>
 #include <memory.h>
+#include <stddef.h>
+#include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
-#include "sim86.h"
+#include "sim86_lib.h"
 
-#include "sim86_instruction.h"
-#include "sim86_instruction_table.h"
 #include "sim86_memory.h"
 #include "sim86_decode.h"
 #include "sim86_text.h"
+#include "sim86_execute.h"
+#include "sim86_block.h"
+#include "sim86_jit.h"
 
 #include "sim86_instruction.cpp"
 #include "sim86_instruction_table.cpp"
 #include "sim86_memory.cpp"
 #include "sim86_decode.cpp"
 #include "sim86_text.cpp"
+#include "sim86_execute.cpp"
+#include "sim86_block.cpp"
+#include "sim86_jit.cpp"
 
 extern "C" u32 Sim86_GetVersion(void)
 {
@@ -36,7 +43,8 @@ extern "C" u32 Sim86_GetVersion(void)
 
 extern "C" void Sim86_Decode8086Instruction(u32 SourceSize, u8 *Source, instruction *Dest)
 {
-    instruction_table Table = Get8086InstructionTable();
+    instruction_dispatch *Dispatch = Get8086InstructionDispatch();
+    instruction_table Table = Dispatch->Table;
     
     // NOTE(casey): The 8086 decoder requires the ability to read up to 15 bytes (the maximum
     // allowable instruction size)
@@ -49,7 +57,13 @@ extern "C" void Sim86_Decode8086Instruction(u32 SourceSize, u8 *Source, instruct
     }
     
     segmented_access At = FixedMemoryPow2(4, Source);
-    *Dest = DecodeInstruction(Table, At);
+    *Dest = DecodeInstruction(Dispatch, At);
+}
+
+static char const *GetRegName(register_access Reg)
+{
+    char const *Result = GetRegNameString(Reg).Data;
+    return Result;
 }
 
 extern "C" char const *Sim86_RegisterNameFromOperand(register_access *RegAccess)
@@ -58,6 +72,12 @@ extern "C" char const *Sim86_RegisterNameFromOperand(register_access *RegAccess)
     return Result;
 }
 
+static char const *GetMnemonic(operation_type Op)
+{
+    char const *Result = GetMnemonicString(Op).Data;
+    return Result;
+}
+
 extern "C" char const *Sim86_MnemonicFromOperationType(operation_type Type)
 {
     char const *Result = GetMnemonic(Type);
@@ -67,4 +87,259 @@ extern "C" char const *Sim86_MnemonicFromOperationType(operation_type Type)
 extern "C" void Sim86_Get8086InstructionTable(instruction_table *Dest)
 {
     *Dest = Get8086InstructionTable();
-}
\ No newline at end of file
+}
+
+static u32 DecodeBlock(u8 *Source, u32 SourceSize, instruction *Dest, packed_instruction *PackedDest,
+                       u32 DestCapacity, decode_block_result *Consumed)
+{
+    instruction_dispatch *Dispatch = Get8086InstructionDispatch();
+    
+    /* NOTE(chuck): DecodeInstruction can look a few bytes past the 15-byte maximum when it
+       rejects a long run of prefixes (up to 20 bytes from where it started). Anything that starts
+       at least GuardSize bytes before the end of the source is decoded in place. Only the last
+       GuardSize bytes get copied, once per block, into a zero-padded buffer.
+    */
+    u32 const GuardSize = 32;
+    u8 TailBuffer[2*GuardSize] = {};
+    u32 TailStart = (SourceSize > GuardSize) ? (SourceSize - GuardSize) : 0;
+    memcpy(TailBuffer, Source + TailStart, SourceSize - TailStart);
+    
+    decode_block_stop Stop = DecodeBlock_EndOfSource;
+    u32 Offset = 0;
+    u32 Count = 0;
+    while(Offset < SourceSize)
+    {
+        if(Count >= DestCapacity)
+        {
+            Stop = DecodeBlock_DestFull;
+            break;
+        }
+        
+        u8 *Memory = (Offset < TailStart) ? (Source + Offset) : (TailBuffer + (Offset - TailStart));
+        instruction Instruction = DecodeInstruction(Dispatch, FixedMemoryPow2(6, Memory));
+        if(!Instruction.Op)
+        {
+            Stop = DecodeBlock_Unrecognized;
+            break;
+        }
+        
+        if(Instruction.Size > (SourceSize - Offset))
+        {
+            Stop = DecodeBlock_Truncated;
+            break;
+        }
+        
+        // NOTE(chuck): Addresses are relative to the start of the block.
+        Instruction.Address = Offset;
+        if(Dest)
+        {
+            Dest[Count] = Instruction;
+        }
+        else
+        {
+            PackedDest[Count] = PackInstruction(Instruction);
+        }
+        
+        ++Count;
+        Offset += Instruction.Size;
+    }
+    
+    if(Consumed)
+    {
+        Consumed->ByteCount = Offset;
+        Consumed->InstructionCount = Count;
+        Consumed->Stop = Stop;
+    }
+    
+    return Count;
+}
+
+extern "C" u32 Sim86_DecodeBlock(u8 *Source, u32 SourceSize, instruction *Dest, u32 DestCapacity, decode_block_result *Consumed)
+{
+    u32 Result = DecodeBlock(Source, SourceSize, Dest, 0, DestCapacity, Consumed);
+    return Result;
+}
+
+extern "C" u32 Sim86_DecodeBlockPacked(u8 *Source, u32 SourceSize, packed_instruction *Dest, u32 DestCapacity, decode_block_result *Consumed)
+{
+    u32 Result = DecodeBlock(Source, SourceSize, 0, Dest, DestCapacity, Consumed);
+    return Result;
+}
+
+extern "C" void Sim86_PackInstruction(instruction *Source, packed_instruction *Dest)
+{
+    *Dest = PackInstruction(*Source);
+}
+
+extern "C" void Sim86_UnpackInstruction(packed_instruction *Source, instruction *Dest)
+{
+    *Dest = UnpackInstruction(*Source);
+}
+
+extern "C" u32 Sim86_DecodeLengths(u8 *Source, u32 SourceSize, u8 *Dest, u32 DestCapacity, decode_block_result *Consumed)
+{
+    instruction_length_table *Table = Get8086InstructionLengthTable();
+    
+    // NOTE(chuck): Same tail handling as DecodeBlock. GetInstructionLength never reads more than
+    // 17 bytes past where it starts.
+    u32 const GuardSize = 32;
+    u8 TailBuffer[2*GuardSize] = {};
+    u32 TailStart = (SourceSize > GuardSize) ? (SourceSize - GuardSize) : 0;
+    memcpy(TailBuffer, Source + TailStart, SourceSize - TailStart);
+    
+    decode_block_stop Stop = DecodeBlock_EndOfSource;
+    u32 Offset = 0;
+    u32 Count = 0;
+    while(Offset < SourceSize)
+    {
+        if(Count >= DestCapacity)
+        {
+            Stop = DecodeBlock_DestFull;
+            break;
+        }
+        
+        u8 *Bytes = (Offset < TailStart) ? (Source + Offset) : (TailBuffer + (Offset - TailStart));
+        u32 Length = GetInstructionLength(Table, Bytes);
+        if(!Length)
+        {
+            Stop = DecodeBlock_Unrecognized;
+            break;
+        }
+        
+        if(Length > (SourceSize - Offset))
+        {
+            Stop = DecodeBlock_Truncated;
+            break;
+        }
+        
+        Dest[Count++] = (u8)Length;
+        Offset += Length;
+    }
+    
+    if(Consumed)
+    {
+        Consumed->ByteCount = Offset;
+        Consumed->InstructionCount = Count;
+        Consumed->Stop = Stop;
+    }
+    
+    return Count;
+}
+
+extern "C" machine *Sim86_CreateMachine(void)
+{
+    // NOTE(chuck): calloc, so the machine starts with every register and every byte of memory zeroed.
+    machine *Result = (machine *)calloc(1, sizeof(machine));
+    u8 *Memory = (u8 *)calloc(1, 1 << 20);
+    if(Result && Memory)
+    {
+        InitializeMachine(Result, Memory, 20);
+    }
+    else
+    {
+        free(Memory);
+        free(Result);
+        Result = 0;
+    }
+    
+    return Result;
+}
+
+extern "C" void Sim86_DestroyMachine(machine *Machine)
+{
+    if(Machine)
+    {
+        if(Machine->Blocks)
+        {
+            FreeExecutableMemory(Machine->Blocks->JitCode, JIT_CODE_SIZE);
+        }
+        free(Machine->Blocks);
+        free(Machine->Memory.Memory);
+        free(Machine);
+    }
+}
+
+static b32 IsValidRegister(register_access *Register)
+{
+    b32 Result = ((Register->Index > Register_none) && (Register->Index < Register_count) &&
+                  (Register->Offset + Register->Count <= 2));
+    return Result;
+}
+
+extern "C" u16 Sim86_GetRegister(machine *Machine, register_access *Register)
+{
+    u16 Result = 0;
+    if(IsValidRegister(Register))
+    {
+        Result = (u16)ReadLocation(GetRegisterLocation(Machine, *Register), (Register->Count == 2));
+    }
+    
+    return Result;
+}
+
+extern "C" void Sim86_SetRegister(machine *Machine, register_access *Register, u16 Value)
+{
+    if(IsValidRegister(Register))
+    {
+        WriteLocation(Machine, GetRegisterLocation(Machine, *Register), (Register->Count == 2), Value);
+    }
+}
+
+// NOTE(chuck): Addresses wrap at 1MB the same way they do for the running program.
+extern "C" u32 Sim86_ReadMemory(machine *Machine, u32 Address, u8 *Dest, u32 Count)
+{
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        Dest[Index] = *GetMemoryLocation(Machine, Address + Index).Low;
+    }
+    
+    return Count;
+}
+
+extern "C" u32 Sim86_WriteMemory(machine *Machine, u32 Address, u8 *Source, u32 Count)
+{
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        WriteLocation(Machine, GetMemoryLocation(Machine, Address + Index), false, Source[Index]);
+    }
+    
+    return Count;
+}
+
+extern "C" machine_status Sim86_Step(machine *Machine, instruction *Executed)
+{
+    instruction Ignored;
+    machine_status Result = StepMachine(Machine, Executed ? Executed : &Ignored);
+    return Result;
+}
+
+extern "C" u64 Sim86_Run(machine *Machine, u64 MaxInstructionCount, machine_step_callback *Callback, void *CallbackContext, machine_status *Status)
+{
+    u64 Result = RunMachine(Machine, MaxInstructionCount, Callback, CallbackContext, Status);
+    return Result;
+}
+
+extern "C" u64 Sim86_RunBlocks(machine *Machine, u64 MaxInstructionCount, machine_status *Status)
+{
+    // NOTE(chuck): The block cache is big, so machines that never run this don't pay for it.
+    if(!Machine->Blocks)
+    {
+        Machine->Blocks = (block_cache *)calloc(1, sizeof(block_cache));
+        if(Machine->Blocks)
+        {
+            Machine->Blocks->JitCode = AllocateExecutableMemory(JIT_CODE_SIZE);
+        }
+    }
+    
+    u64 Result = 0;
+    if(Machine->Blocks)
+    {
+        Result = RunBlocks(Machine, MaxInstructionCount, Status);
+    }
+    else
+    {
+        Result = RunMachine(Machine, MaxInstructionCount, 0, 0, Status);
+    }
+    
+    return Result;
+}
@@ -14,8 +14,67 @@
 #include "sim86_instruction.h"
 #include "sim86_instruction_table.h"
 
+enum decode_block_stop : u32
+{
+    DecodeBlock_EndOfSource, // NOTE(chuck): Every byte of the source was decoded
+    DecodeBlock_DestFull, // NOTE(chuck): The destination array filled up before the source ran out
+    DecodeBlock_Unrecognized, // NOTE(chuck): The bytes at ByteCount are not a valid instruction
+    DecodeBlock_Truncated, // NOTE(chuck): The instruction at ByteCount runs past the end of the source
+};
+
+struct decode_block_result
+{
+    u32 ByteCount;
+    u32 InstructionCount;
+    decode_block_stop Stop;
+};
+
+enum machine_flag : u32
+{
+    Flag_Carry = 0x1,
+    Flag_Parity = 0x4,
+    Flag_AuxiliaryCarry = 0x10,
+    Flag_Zero = 0x40,
+    Flag_Sign = 0x80,
+    Flag_Trap = 0x100,
+    Flag_Interrupt = 0x200,
+    Flag_Direction = 0x400,
+    Flag_Overflow = 0x800,
+};
+
+enum machine_status : u32
+{
+    Machine_Running, // NOTE(chuck): Nothing stopped it (for Sim86_Run, it used up its instruction count)
+    Machine_Halted, // NOTE(chuck): It executed a hlt
+    Machine_Unrecognized, // NOTE(chuck): The bytes at CS:IP are not a valid instruction
+    Machine_Unimplemented, // NOTE(chuck): The instruction at CS:IP decodes, but can't be executed (port I/O)
+    Machine_Stopped, // NOTE(chuck): The step callback asked to stop
+};
+
+/* NOTE(chuck): A machine is an 8086 with 1mb of memory. Everything (registers, flags and memory)
+   starts out zeroed, so a program written to address 0 runs from CS:IP = 0:0. Register indices are
+   register_mapping_8086 values, and include ip and flags. */
+struct machine;
+
+// NOTE(chuck): Called after each instruction Sim86_Run executes. Return false to stop the run.
+typedef b32 machine_step_callback(void *Context, machine *Machine, instruction *Executed);
+
 extern "C" u32 Sim86_GetVersion(void);
 extern "C" void Sim86_Decode8086Instruction(u32 SourceSize, u8 *Source, instruction *Dest);
 extern "C" char const *Sim86_RegisterNameFromOperand(register_access *RegAccess);
 extern "C" char const *Sim86_MnemonicFromOperationType(operation_type Type);
-extern "C" void Sim86_Get8086InstructionTable(instruction_table *Dest);
\ No newline at end of file
+extern "C" void Sim86_Get8086InstructionTable(instruction_table *Dest);
+extern "C" u32 Sim86_DecodeBlock(u8 *Source, u32 SourceSize, instruction *Dest, u32 DestCapacity, decode_block_result *Consumed);
+extern "C" u32 Sim86_DecodeBlockPacked(u8 *Source, u32 SourceSize, packed_instruction *Dest, u32 DestCapacity, decode_block_result *Consumed);
+extern "C" void Sim86_PackInstruction(instruction *Source, packed_instruction *Dest);
+extern "C" void Sim86_UnpackInstruction(packed_instruction *Source, instruction *Dest);
+extern "C" u32 Sim86_DecodeLengths(u8 *Source, u32 SourceSize, u8 *Dest, u32 DestCapacity, decode_block_result *Consumed);
+extern "C" machine *Sim86_CreateMachine(void);
+extern "C" void Sim86_DestroyMachine(machine *Machine);
+extern "C" u16 Sim86_GetRegister(machine *Machine, register_access *Register);
+extern "C" void Sim86_SetRegister(machine *Machine, register_access *Register, u16 Value);
+extern "C" u32 Sim86_ReadMemory(machine *Machine, u32 Address, u8 *Dest, u32 Count);
+extern "C" u32 Sim86_WriteMemory(machine *Machine, u32 Address, u8 *Source, u32 Count);
+extern "C" machine_status Sim86_Step(machine *Machine, instruction *Executed);
+extern "C" u64 Sim86_Run(machine *Machine, u64 MaxInstructionCount, machine_step_callback *Callback, void *CallbackContext, machine_status *Status);
+extern "C" u64 Sim86_RunBlocks(machine *Machine, u64 MaxInstructionCount, machine_status *Status);
\ No newline at end of file
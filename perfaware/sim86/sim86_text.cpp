@@ -10,18 +10,20 @@
    
    ======================================================================== */
 
-char const *OpcodeMnemonics[] =
+#define TextString(Literal) text_string{Literal, sizeof(Literal) - 1}
+
+text_string OpcodeMnemonics[] =
 {
-    "",
+    TextString(""),
 
-#define INST(Mnemonic, ...) #Mnemonic,
+#define INST(Mnemonic, ...) TextString(#Mnemonic),
 #define INSTALT(...)
 #include "sim86_instruction_table.inl"
 };
 
-static char const *GetMnemonic(operation_type Op)
+static text_string GetMnemonicString(operation_type Op)
 {
-    char const *Result = "";
+    text_string Result = OpcodeMnemonics[0];
     if(Op < Op_Count)
     {
         Result = OpcodeMnemonics[Op];
@@ -30,34 +32,125 @@ static char const *GetMnemonic(operation_type Op)
     return Result;
 }
 
-static char const *GetRegName(register_access Reg)
-{
-    char const *Names[][3] =
-    {
-        {"", "", ""},
-        {"al", "ah", "ax"},
-        {"bl", "bh", "bx"},
-        {"cl", "ch", "cx"},
-        {"dl", "dh", "dx"},
-        {"sp", "sp", "sp"},
-        {"bp", "bp", "bp"},
-        {"si", "si", "si"},
-        {"di", "di", "di"},
-        {"es", "es", "es"},
-        {"cs", "cs", "cs"},
-        {"ss", "ss", "ss"},
-        {"ds", "ds", "ds"},
-        {"ip", "ip", "ip"},
-        {"flags", "flags", "flags"}
+static text_string GetRegNameString(register_access Reg)
+{
+    static text_string const Names[][3] =
+    {
+        {TextString(""), TextString(""), TextString("")},
+        {TextString("al"), TextString("ah"), TextString("ax")},
+        {TextString("bl"), TextString("bh"), TextString("bx")},
+        {TextString("cl"), TextString("ch"), TextString("cx")},
+        {TextString("dl"), TextString("dh"), TextString("dx")},
+        {TextString("sp"), TextString("sp"), TextString("sp")},
+        {TextString("bp"), TextString("bp"), TextString("bp")},
+        {TextString("si"), TextString("si"), TextString("si")},
+        {TextString("di"), TextString("di"), TextString("di")},
+        {TextString("es"), TextString("es"), TextString("es")},
+        {TextString("cs"), TextString("cs"), TextString("cs")},
+        {TextString("ss"), TextString("ss"), TextString("ss")},
+        {TextString("ds"), TextString("ds"), TextString("ds")},
+        {TextString("ip"), TextString("ip"), TextString("ip")},
+        {TextString("flags"), TextString("flags"), TextString("flags")}
     };
     
-    char const *Result = Names[Reg.Index % ArrayCount(Names)][(Reg.Count == 2) ? 2 : Reg.Offset&1];
+    text_string Result = Names[Reg.Index % ArrayCount(Names)][(Reg.Count == 2) ? 2 : Reg.Offset&1];
+    return Result;
+}
+
+static text_buffer TextBuffer(u8 *Base, u32 Capacity, FILE *FlushTo)
+{
+    text_buffer Result = {};
+    Result.Base = Base;
+    Result.Capacity = Base ? Capacity : 0;
+    Result.FlushTo = FlushTo;
+    return Result;
+}
+
+static void FlushText(text_buffer *Buffer)
+{
+    if(Buffer->FlushTo && Buffer->Used)
+    {
+        fwrite(Buffer->Base, 1, Buffer->Used, Buffer->FlushTo);
+        Buffer->Used = 0;
+    }
+}
+
+static b32 ReserveText(text_buffer *Buffer, u32 Length)
+{
+    if((Buffer->Capacity - Buffer->Used) < Length)
+    {
+        FlushText(Buffer);
+    }
+    
+    b32 Result = ((Buffer->Capacity - Buffer->Used) >= Length);
     return Result;
 }
 
-static void PrintEffectiveAddressExpression(effective_address_expression Address, FILE *Dest)
+static void AppendText(text_buffer *Buffer, char const *Text, u32 Length)
+{
+    if(ReserveText(Buffer, Length))
+    {
+        memcpy(Buffer->Base + Buffer->Used, Text, Length);
+        Buffer->Used += Length;
+    }
+    else if(Buffer->FlushTo)
+    {
+        // NOTE(chuck): Bigger than the whole buffer. ReserveText has already flushed, so the order
+        // is preserved by writing it straight through.
+        fwrite(Text, 1, Length, Buffer->FlushTo);
+    }
+    else
+    {
+        Buffer->Overflowed = true;
+    }
+}
+
+static void AppendText(text_buffer *Buffer, text_string Text)
+{
+    AppendText(Buffer, Text.Data, Text.Length);
+}
+
+static void AppendText(text_buffer *Buffer, char const *Text)
+{
+    AppendText(Buffer, Text, (u32)strlen(Text));
+}
+
+static void AppendU32(text_buffer *Buffer, u32 Value)
+{
+    // NOTE(chuck): Digits are generated backwards from the end of a scratch buffer that is big
+    // enough for any u32 and a sign.
+    char Digits[16];
+    char *At = Digits + sizeof(Digits);
+    do
+    {
+        *--At = (char)('0' + (Value % 10));
+        Value /= 10;
+    } while(Value);
+    
+    AppendText(Buffer, At, (u32)((Digits + sizeof(Digits)) - At));
+}
+
+static void AppendS32(text_buffer *Buffer, s32 Value, b32 ShowPlus)
+{
+    // NOTE(chuck): Matches printf's %d, or %+d with ShowPlus.
+    if(Value < 0)
+    {
+        AppendText(Buffer, "-", 1);
+        AppendU32(Buffer, 0u - (u32)Value);
+    }
+    else
+    {
+        if(ShowPlus)
+        {
+            AppendText(Buffer, "+", 1);
+        }
+        AppendU32(Buffer, (u32)Value);
+    }
+}
+
+static void FormatEffectiveAddressExpression(effective_address_expression Address, text_buffer *Dest)
 {
-    char const *Separator = "";
+    b32 NeedsSeparator = false;
     for(u32 Index = 0; Index < ArrayCount(Address.Terms); ++Index)
     {
         effective_address_term Term = Address.Terms[Index];
@@ -65,24 +158,51 @@ static void PrintEffectiveAddressExpression(effective_address_expression Address
         
         if(Reg.Index)
         {
-            fprintf(Dest, "%s", Separator);
+            if(NeedsSeparator)
+            {
+                AppendText(Dest, "+", 1);
+            }
             if(Term.Scale != 1)
             {
-                fprintf(Dest, "%d*", Term.Scale);
+                AppendS32(Dest, Term.Scale);
+                AppendText(Dest, "*", 1);
             }
-            fprintf(Dest, "%s", GetRegName(Reg));
-            Separator = "+";
+            AppendText(Dest, GetRegNameString(Reg));
+            NeedsSeparator = true;
         }
     }
     
     if(Address.Displacement != 0)
     {
-        fprintf(Dest, "%+d", Address.Displacement);
+        AppendS32(Dest, Address.Displacement, true);
+    }
+}
+
+static u32 GetLabel(label_table *Labels, u32 Address)
+{
+    u32 Result = 0;
+    
+    u32 Offset = Address - Labels->BaseAddress;
+    if(Offset < Labels->ByteCount)
+    {
+        Result = Labels->LabelAt[Offset];
     }
+    
+    return Result;
+}
+
+static void FormatLabel(u32 Label, text_buffer *Dest)
+{
+    AppendText(Dest, TextString("label"));
+    AppendU32(Dest, Label - 1);
 }
 
-static void PrintInstruction(instruction Instruction, FILE *Dest)
+static void FormatInstruction(instruction Instruction, text_buffer *Dest, label_table *Labels)
 {
+    // NOTE(chuck): Make room for the whole instruction up front, so that a buffer with FlushTo
+    // set only ever writes out whole instructions.
+    ReserveText(Dest, MaxInstructionTextLength);
+    
     u32 Flags = Instruction.Flags;
     u32 W = Flags & Inst_Wide;
     
@@ -95,26 +215,50 @@ static void PrintInstruction(instruction Instruction, FILE *Dest)
             Instruction.Operands[0] = Instruction.Operands[1];
             Instruction.Operands[1] = Temp;
         }
-        fprintf(Dest, "lock ");
+        AppendText(Dest, TextString("lock "));
     }
     
-    char const *MnemonicSuffix = "";
+    text_string MnemonicSuffix = TextString("");
     if(Flags & Inst_Rep)
     {
-        fprintf(Dest, "rep ");
-        MnemonicSuffix = W ? "w" : "b";
+        AppendText(Dest, TextString("rep "));
+        MnemonicSuffix = W ? TextString("w") : TextString("b");
     }
     
-    fprintf(Dest, "%s%s ", GetMnemonic(Instruction.Op), MnemonicSuffix);
+    AppendText(Dest, GetMnemonicString(Instruction.Op));
+    AppendText(Dest, MnemonicSuffix);
+    AppendText(Dest, " ", 1);
+    
+    u32 JumpLabel = 0;
+    u32 JumpTarget = 0;
+    if(GetRelativeJumpTarget(Instruction, &JumpTarget))
+    {
+        if(Labels)
+        {
+            JumpLabel = GetLabel(Labels, JumpTarget);
+        }
+        
+        // NOTE(chuck): The assembler picks the two-byte form of jmp whenever the target is close
+        // enough, so the three-byte form has to be asked for by name to reassemble to the same bytes.
+        s32 ShortDisplacement = (s32)(JumpTarget - (Instruction.Address + 2));
+        if((Instruction.Op == Op_jmp) && (Instruction.Size == 3) &&
+           (ShortDisplacement >= -128) && (ShortDisplacement <= 127))
+        {
+            AppendText(Dest, TextString("near "));
+        }
+    }
     
-    char const *Separator = "";
+    b32 NeedsSeparator = false;
     for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Instruction.Operands); ++OperandIndex)
     {
         instruction_operand Operand = Instruction.Operands[OperandIndex];
         if(Operand.Type != Operand_None)
         {
-            fprintf(Dest, "%s", Separator);
-            Separator = ", ";
+            if(NeedsSeparator)
+            {
+                AppendText(Dest, TextString(", "));
+            }
+            NeedsSeparator = true;
             
             switch(Operand.Type)
             {
@@ -122,7 +266,7 @@ static void PrintInstruction(instruction Instruction, FILE *Dest)
                 
                 case Operand_Register:
                 {
-                    fprintf(Dest, "%s", GetRegName(Operand.Register));
+                    AppendText(Dest, GetRegNameString(Operand.Register));
                 } break;
                 
                 case Operand_Memory:
@@ -131,44 +275,317 @@ static void PrintInstruction(instruction Instruction, FILE *Dest)
 
                     if(Flags & Inst_Far)
                     {
-                        fprintf(Dest, "far ");
+                        AppendText(Dest, TextString("far "));
                     }
                     
                     if(Address.Flags & Address_ExplicitSegment)
                     {
-                        fprintf(Dest, "%u:%u", Address.ExplicitSegment, Address.Displacement);
+                        AppendU32(Dest, Address.ExplicitSegment);
+                        AppendText(Dest, ":", 1);
+                        AppendU32(Dest, (u32)Address.Displacement);
                     }
                     else
                     {
                         if(Instruction.Operands[0].Type != Operand_Register)
                         {
-                            fprintf(Dest, "%s ", W ? "word" : "byte");
+                            AppendText(Dest, W ? TextString("word ") : TextString("byte "));
                         }
                         
                         if(Flags & Inst_Segment)
                         {
-                            fprintf(Dest, "%s:", GetRegName({Instruction.SegmentOverride, 0, 2}));
+                            AppendText(Dest, GetRegNameString({Instruction.SegmentOverride, 0, 2}));
+                            AppendText(Dest, ":", 1);
                         }
                         
-                        fprintf(Dest, "[");
-                        PrintEffectiveAddressExpression(Address, Dest);
-                        fprintf(Dest, "]");
+                        AppendText(Dest, "[", 1);
+                        FormatEffectiveAddressExpression(Address, Dest);
+                        AppendText(Dest, "]", 1);
                     }
                 } break;
                 
                 case Operand_Immediate:
                 {
                     immediate Immediate = Operand.Immediate;
-                    if(Immediate.Flags & Immediate_RelativeJumpDisplacement)
+                    if(JumpLabel && (Immediate.Flags & Immediate_RelativeJumpDisplacement))
                     {
-                        fprintf(Dest, "$%+d", Immediate.Value + Instruction.Size);
+                        FormatLabel(JumpLabel, Dest);
+                    }
+                    else if(Immediate.Flags & Immediate_RelativeJumpDisplacement)
+                    {
+                        AppendText(Dest, "$", 1);
+                        AppendS32(Dest, Immediate.Value + Instruction.Size, true);
                     }
                     else
                     {
-                        fprintf(Dest, "%d", Immediate.Value);
+                        AppendS32(Dest, Immediate.Value);
                     }
                 } break;
             }
         }
     }
 }
+
+static void AppendHexBytes(text_buffer *Buffer, u8 *Bytes, u32 Count)
+{
+    static char const Digits[] = "0123456789abcdef";
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        char Pair[2] = {Digits[Bytes[Index] >> 4], Digits[Bytes[Index] & 0xf]};
+        AppendText(Buffer, Pair, 2);
+    }
+}
+
+static char const *InstructionFlagNames[] = {"lock", "rep", "segment", "wide", "far"};
+
+static void FormatOperandJSON(instruction Instruction, instruction_operand Operand, text_buffer *Dest)
+{
+    switch(Operand.Type)
+    {
+        case Operand_None: {} break;
+        
+        case Operand_Register:
+        {
+            // NOTE(chuck): Just the name, so that sim8086's JSONL has exactly the same shape.
+            AppendText(Dest, TextString("{\"type\":\"register\",\"name\":\""));
+            AppendText(Dest, GetRegNameString(Operand.Register));
+            AppendText(Dest, TextString("\"}"));
+        } break;
+        
+        case Operand_Memory:
+        {
+            effective_address_expression Address = Operand.Address;
+            AppendText(Dest, TextString("{\"type\":\"memory\""));
+            if(Address.Flags & Address_ExplicitSegment)
+            {
+                AppendText(Dest, TextString(",\"explicit_segment\":"));
+                AppendU32(Dest, Address.ExplicitSegment);
+            }
+            else
+            {
+                AppendText(Dest, TextString(",\"terms\":["));
+                b32 NeedsSeparator = false;
+                for(u32 Index = 0; Index < ArrayCount(Address.Terms); ++Index)
+                {
+                    register_access Reg = Address.Terms[Index].Register;
+                    if(Reg.Index)
+                    {
+                        if(NeedsSeparator)
+                        {
+                            AppendText(Dest, ",", 1);
+                        }
+                        AppendText(Dest, "\"", 1);
+                        AppendText(Dest, GetRegNameString(Reg));
+                        AppendText(Dest, "\"", 1);
+                        NeedsSeparator = true;
+                    }
+                }
+                AppendText(Dest, "]", 1);
+            }
+            AppendText(Dest, TextString(",\"displacement\":"));
+            AppendS32(Dest, Address.Displacement);
+            AppendText(Dest, "}", 1);
+        } break;
+        
+        case Operand_Immediate:
+        {
+            immediate Immediate = Operand.Immediate;
+            if(Immediate.Flags & Immediate_RelativeJumpDisplacement)
+            {
+                AppendText(Dest, TextString("{\"type\":\"relative\",\"displacement\":"));
+                AppendS32(Dest, Immediate.Value);
+                AppendText(Dest, TextString(",\"target\":"));
+                AppendU32(Dest, Instruction.Address + Instruction.Size + Immediate.Value);
+            }
+            else
+            {
+                AppendText(Dest, TextString("{\"type\":\"immediate\",\"value\":"));
+                AppendS32(Dest, Immediate.Value);
+            }
+            AppendText(Dest, "}", 1);
+        } break;
+    }
+}
+
+static void FormatInstructionJSON(instruction Instruction, u8 *Bytes, text_buffer *Dest)
+{
+    ReserveText(Dest, MaxInstructionTextLength);
+    
+    AppendText(Dest, TextString("{\"address\":"));
+    AppendU32(Dest, Instruction.Address);
+    AppendText(Dest, TextString(",\"size\":"));
+    AppendU32(Dest, Instruction.Size);
+    AppendText(Dest, TextString(",\"bytes\":\""));
+    AppendHexBytes(Dest, Bytes, Instruction.Size);
+    AppendText(Dest, TextString("\",\"mnemonic\":\""));
+    AppendText(Dest, GetMnemonicString(Instruction.Op));
+    AppendText(Dest, TextString("\",\"flags\":["));
+    b32 NeedsSeparator = false;
+    for(u32 FlagIndex = 0; FlagIndex < ArrayCount(InstructionFlagNames); ++FlagIndex)
+    {
+        if(Instruction.Flags & (1 << FlagIndex))
+        {
+            if(NeedsSeparator)
+            {
+                AppendText(Dest, ",", 1);
+            }
+            AppendText(Dest, "\"", 1);
+            AppendText(Dest, InstructionFlagNames[FlagIndex]);
+            AppendText(Dest, "\"", 1);
+            NeedsSeparator = true;
+        }
+    }
+    AppendText(Dest, "]", 1);
+    
+    if(Instruction.Flags & Inst_Segment)
+    {
+        AppendText(Dest, TextString(",\"segment\":\""));
+        AppendText(Dest, GetRegNameString({Instruction.SegmentOverride, 0, 2}));
+        AppendText(Dest, "\"", 1);
+    }
+    
+    AppendText(Dest, TextString(",\"operands\":["));
+    NeedsSeparator = false;
+    for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Instruction.Operands); ++OperandIndex)
+    {
+        instruction_operand Operand = Instruction.Operands[OperandIndex];
+        if(Operand.Type != Operand_None)
+        {
+            if(NeedsSeparator)
+            {
+                AppendText(Dest, ",", 1);
+            }
+            FormatOperandJSON(Instruction, Operand, Dest);
+            NeedsSeparator = true;
+        }
+    }
+    AppendText(Dest, TextString("]}\n"));
+}
+
+/* NOTE(chuck): CSV rows are flat, so every operand gets the same six columns and only fills in the
+   ones that apply: the register name, the two effective address terms and the displacement, or the
+   value. For a relative jump the displacement is the raw one and the value is the target address,
+   and for a far address the value is the explicit segment. */
+static void FormatCSVHeader(text_buffer *Dest)
+{
+    AppendText(Dest, "address,size,bytes,mnemonic,");
+    for(u32 FlagIndex = 0; FlagIndex < ArrayCount(InstructionFlagNames); ++FlagIndex)
+    {
+        AppendText(Dest, InstructionFlagNames[FlagIndex]);
+        AppendText(Dest, ",", 1);
+    }
+    AppendText(Dest, "segment_override");
+    for(u32 OperandIndex = 0; OperandIndex < 2; ++OperandIndex)
+    {
+        char const *Columns[] = {"type", "register", "term0", "term1", "displacement", "value"};
+        for(u32 ColumnIndex = 0; ColumnIndex < ArrayCount(Columns); ++ColumnIndex)
+        {
+            AppendText(Dest, ",op", 3);
+            AppendU32(Dest, OperandIndex);
+            AppendText(Dest, "_", 1);
+            AppendText(Dest, Columns[ColumnIndex]);
+        }
+    }
+    AppendText(Dest, "\n", 1);
+}
+
+static void FormatOperandCSV(instruction Instruction, instruction_operand Operand, text_buffer *Dest)
+{
+    switch(Operand.Type)
+    {
+        case Operand_None:
+        {
+            AppendText(Dest, TextString(",none,,,,,"));
+        } break;
+        
+        case Operand_Register:
+        {
+            AppendText(Dest, TextString(",register,"));
+            AppendText(Dest, GetRegNameString(Operand.Register));
+            AppendText(Dest, TextString(",,,,"));
+        } break;
+        
+        case Operand_Memory:
+        {
+            effective_address_expression Address = Operand.Address;
+            AppendText(Dest, TextString(",memory,,"));
+            AppendText(Dest, GetRegNameString(Address.Terms[0].Register));
+            AppendText(Dest, ",", 1);
+            AppendText(Dest, GetRegNameString(Address.Terms[1].Register));
+            AppendText(Dest, ",", 1);
+            AppendS32(Dest, Address.Displacement);
+            AppendText(Dest, ",", 1);
+            if(Address.Flags & Address_ExplicitSegment)
+            {
+                AppendU32(Dest, Address.ExplicitSegment);
+            }
+        } break;
+        
+        case Operand_Immediate:
+        {
+            immediate Immediate = Operand.Immediate;
+            if(Immediate.Flags & Immediate_RelativeJumpDisplacement)
+            {
+                AppendText(Dest, TextString(",relative,,,,"));
+                AppendS32(Dest, Immediate.Value);
+                AppendText(Dest, ",", 1);
+                AppendU32(Dest, Instruction.Address + Instruction.Size + Immediate.Value);
+            }
+            else
+            {
+                AppendText(Dest, TextString(",immediate,,,,,"));
+                AppendS32(Dest, Immediate.Value);
+            }
+        } break;
+    }
+}
+
+static void FormatInstructionCSV(instruction Instruction, u8 *Bytes, text_buffer *Dest)
+{
+    ReserveText(Dest, MaxInstructionTextLength);
+    
+    AppendU32(Dest, Instruction.Address);
+    AppendText(Dest, ",", 1);
+    AppendU32(Dest, Instruction.Size);
+    AppendText(Dest, ",", 1);
+    AppendHexBytes(Dest, Bytes, Instruction.Size);
+    AppendText(Dest, ",", 1);
+    AppendText(Dest, GetMnemonicString(Instruction.Op));
+    for(u32 FlagIndex = 0; FlagIndex < ArrayCount(InstructionFlagNames); ++FlagIndex)
+    {
+        AppendText(Dest, (Instruction.Flags & (1 << FlagIndex)) ? ",1" : ",0", 2);
+    }
+    AppendText(Dest, ",", 1);
+    if(Instruction.Flags & Inst_Segment)
+    {
+        AppendText(Dest, GetRegNameString({Instruction.SegmentOverride, 0, 2}));
+    }
+    
+    for(u32 OperandIndex = 0; OperandIndex < ArrayCount(Instruction.Operands); ++OperandIndex)
+    {
+        FormatOperandCSV(Instruction, Instruction.Operands[OperandIndex], Dest);
+    }
+    AppendText(Dest, "\n", 1);
+}
+
+static void FormatDisAsmLine(disasm_format Format, instruction Instruction, u8 *Bytes, text_buffer *Dest,
+                             label_table *Labels)
+{
+    switch(Format)
+    {
+        case DisAsmFormat_ASM:
+        {
+            FormatInstruction(Instruction, Dest, Labels);
+            AppendText(Dest, "\n", 1);
+        } break;
+        
+        case DisAsmFormat_JSONL:
+        {
+            FormatInstructionJSON(Instruction, Bytes, Dest);
+        } break;
+        
+        case DisAsmFormat_CSV:
+        {
+            FormatInstructionCSV(Instruction, Bytes, Dest);
+        } break;
+    }
+}
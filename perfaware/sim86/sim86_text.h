@@ -10,4 +10,64 @@
    
    ======================================================================== */
 
-static void PrintInstruction(instruction Instruction, FILE *Dest);
+struct text_string
+{
+    char const *Data;
+    u32 Length;
+};
+
+/* NOTE(chuck): text_buffer is where disassembly text gets built. It appends into memory the caller
+   owns. If FlushTo is set, the buffer writes itself out there in one big block whenever it runs
+   out of room, otherwise text that doesn't fit is dropped and Overflowed is set. */
+struct text_buffer
+{
+    u8 *Base;
+    u32 Capacity;
+    u32 Used;
+    FILE *FlushTo;
+    b32 Overflowed;
+};
+
+/* NOTE(chuck): label_table names addresses in a disassembly region. LabelAt has an entry for every
+   byte of the region, holding the label number plus one, or zero where there is no label. When
+   FormatInstruction is given one, relative jumps into a labelled address print as "labelN" instead
+   of "$+N". */
+struct label_table
+{
+    u32 BaseAddress;
+    u32 ByteCount;
+    u32 *LabelAt;
+};
+
+/* NOTE(chuck): Besides NASM text, disassembly can come out as one JSON object per line or one CSV
+   row per instruction, built straight from the instruction fields, for tools that would otherwise
+   have to parse the assembly back apart. */
+enum disasm_format : u32
+{
+    DisAsmFormat_ASM,
+    DisAsmFormat_JSONL,
+    DisAsmFormat_CSV,
+};
+
+// NOTE(chuck): No single instruction can format to more than this many characters, in any format.
+static u32 const MaxInstructionTextLength = 512;
+
+static text_buffer TextBuffer(u8 *Base, u32 Capacity, FILE *FlushTo = 0);
+static void FlushText(text_buffer *Buffer);
+static b32 ReserveText(text_buffer *Buffer, u32 Length);
+
+static void AppendText(text_buffer *Buffer, char const *Text, u32 Length);
+static void AppendText(text_buffer *Buffer, text_string Text);
+static void AppendText(text_buffer *Buffer, char const *Text);
+static void AppendU32(text_buffer *Buffer, u32 Value);
+static void AppendS32(text_buffer *Buffer, s32 Value, b32 ShowPlus = false);
+
+static u32 GetLabel(label_table *Labels, u32 Address);
+static void FormatLabel(u32 Label, text_buffer *Dest);
+
+static void FormatInstruction(instruction Instruction, text_buffer *Dest, label_table *Labels = 0);
+static void FormatInstructionJSON(instruction Instruction, u8 *Bytes, text_buffer *Dest);
+static void FormatInstructionCSV(instruction Instruction, u8 *Bytes, text_buffer *Dest);
+static void FormatCSVHeader(text_buffer *Dest);
+static void FormatDisAsmLine(disasm_format Format, instruction Instruction, u8 *Bytes, text_buffer *Dest,
+                             label_table *Labels = 0);
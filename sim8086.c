@@ -1,19 +1,165 @@
 #include <windows.h>
+#include <intrin.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include "sim8086.h"
 
-static u8 OpStream[1024*4];
-static op OpList[1024*4];
+static arena OpStreamArena;
+static arena OpListArena;
+static arena OpIndexArena;
+static arena OutputArena;
+static arena TraceRingArena;
+static arena TraceStoreArena;
+static arena TraceStoreIndexArena;
+static arena TraceWriteArena;
+static arena MemoryArena;
+static arena DecodedOpArena;
 static int OpCount;
 static char Temp[1024] = {0};
 
-typedef struct
+static void *PushSize(arena *Arena, size_t Size)
+{
+    if(!Arena->Base)
+    {
+        Arena->Reserved = ARENA_RESERVE_SIZE;
+        Arena->Base = VirtualAlloc(0, Arena->Reserved, MEM_RESERVE, PAGE_NOACCESS);
+    }
+
+    if(!Arena->Base || ((Arena->Used + Size) > Arena->Reserved))
+    {
+        fprintf(stderr, "ERROR: Out of address space (%lld bytes requested, %lld in use).\n", (__int64)Size, (__int64)Arena->Used);
+        exit(1);
+    }
+
+    size_t NewUsed = Arena->Used + Size;
+    if(NewUsed > Arena->Committed)
+    {
+        // NOTE(chuck): Commit in big steps so that the kernel isn't hit for every op. Freshly committed pages come back zeroed.
+        size_t NewCommitted = (NewUsed + ARENA_COMMIT_SIZE - 1) & ~(size_t)(ARENA_COMMIT_SIZE - 1);
+        if(NewCommitted > Arena->Reserved)
+        {
+            NewCommitted = Arena->Reserved;
+        }
+        if(!VirtualAlloc(Arena->Base + Arena->Committed, NewCommitted - Arena->Committed, MEM_COMMIT, PAGE_READWRITE))
+        {
+            fprintf(stderr, "ERROR: Unable to commit %lld bytes.\n", (__int64)(NewCommitted - Arena->Committed));
+            exit(1);
+        }
+        Arena->Committed = NewCommitted;
+    }
+
+    void *Result = Arena->Base + Arena->Used;
+    Arena->Used = NewUsed;
+    return(Result);
+}
+
+static void FlushOutput(output_buffer *Output)
+{
+    fwrite(Output->Base, 1, Output->Used, Output->File);
+    Output->Used = 0;
+}
+
+// NOTE(chuck): Guarantees room for Length more bytes without a flush, so that a line that is being assembled can be patched up in place (e.g. commented out) before it goes out.
+static void ReserveOutput(output_buffer *Output, size_t Length)
+{
+    if((Output->Used + Length) > Output->Capacity)
+    {
+        FlushOutput(Output);
+    }
+    Assert(Length <= Output->Capacity);
+}
+
+static void EmitBytes(output_buffer *Output, char *Data, size_t Length)
+{
+    if(Length > Output->Capacity)
+    {
+        // NOTE(chuck): This could never fit, so write it straight through after whatever is already buffered.
+        FlushOutput(Output);
+        fwrite(Data, 1, Length, Output->File);
+    }
+    else
+    {
+        ReserveOutput(Output, Length);
+        memcpy(Output->Base + Output->Used, Data, Length);
+        Output->Used += Length;
+    }
+}
+
+static void EmitString(output_buffer *Output, char *String)
+{
+    EmitBytes(Output, String, strlen(String));
+}
+
+static void EmitChar(output_buffer *Output, char Char)
+{
+    ReserveOutput(Output, 1);
+    Output->Base[Output->Used++] = Char;
+}
+
+static void EmitInt(output_buffer *Output, int Value)
+{
+    char Digits[16];
+    char *At = Digits + sizeof(Digits);
+    unsigned int Magnitude = (Value < 0) ? (0u - (unsigned int)Value) : (unsigned int)Value;
+    do
+    {
+        *--At = (char)('0' + (Magnitude % 10));
+        Magnitude /= 10;
+    } while(Magnitude);
+
+    if(Value < 0)
+    {
+        *--At = '-';
+    }
+
+    EmitBytes(Output, At, (size_t)((Digits + sizeof(Digits)) - At));
+}
+
+static char HexDigits[] = "0123456789ABCDEF";
+
+// NOTE(chuck): Same as "%0*X".
+static void EmitHex(output_buffer *Output, unsigned __int64 Value, int DigitCount)
+{
+    ReserveOutput(Output, DigitCount);
+    char *At = Output->Base + Output->Used + DigitCount;
+    for(int DigitIndex = 0;
+        DigitIndex < DigitCount;
+        ++DigitIndex)
+    {
+        *--At = HexDigits[Value & 0xF];
+        Value >>= 4;
+    }
+    Output->Used += DigitCount;
+}
+
+// NOTE(chuck): Same as "%-*s" for whatever was emitted since LineStart.
+static void EmitPadding(output_buffer *Output, size_t LineStart, size_t Width)
+{
+    size_t Length = Output->Used - LineStart;
+    if(Length < Width)
+    {
+        ReserveOutput(Output, Width - Length);
+        memset(Output->Base + Output->Used, ' ', Width - Length);
+        Output->Used += Width - Length;
+    }
+}
+
+// NOTE(chuck): For the cold paths that aren't worth hand-formatting.
+static void EmitFormat(output_buffer *Output, char *Format, ...)
 {
-    u16 Registers[8];
-    u16 SegmentRegisters[4];
-    u16 Flags;
-} cpu_state;
+    char Buffer[1024];
+    va_list Args;
+    va_start(Args, Format);
+    int Length = vsnprintf(Buffer, sizeof(Buffer), Format, Args);
+    va_end(Args);
+    if(Length > 0)
+    {
+        EmitBytes(Output, Buffer, (size_t)Length);
+    }
+}
+
 static cpu_state CPUState;
+static u8 *Memory;
 
 static int IsPrefix(op *Op)
 {
@@ -847,9 +993,9 @@ static op JmpDirectWithinSegment(parsing_context *Context, options DecodeOptions
     op Op = {DecodeOptions.NameIndex, IP, 1, 0};
     Op.Word = 1;
     Op.Param[DESTINATION].Type = Param_Immediate;
+    Op.Param[DESTINATION].ImmediateValue = *(s16 *)&IP[1];
     Op.ByteLength = 3;
-    int Offset = (int)(IP - Context->OpStream);
-    Op.Param[DESTINATION].ImmediateValue = Offset + *(s16 *)&IP[1] + Op.ByteLength;
+    Op.IsRelativeJump = 1;
     return(Op);
 }
 
@@ -936,7 +1082,7 @@ static op SegmentOverride(parsing_context *Context, options DecodeOptions)
 
 static op_definition OpTable[] =
 {
-    // TODO(chuck): There is order-dependence here! AddSubCmp_ImmediateWithRegisterOrMemory will fire first if XCHG is listed after it, which is no bueno. I assume this means that I have to order all these encodings by largest prefix and descending, then misc. splotchy masks. Hopefully that works for everything? There's probably a better way to handle this then the prefix masking, such that there is no ambiguity related to ordering.
+    // NOTE(chuck): Order doesn't matter here anymore. BuildOpDispatch compiles this into OpDispatch and refuses to start if two entries claim the same first byte and extension, so keep the masks tight.
     // TODO(chuck): Table 4-14. Machine Instruction Encoding Matrix looks interesting but I don't understand how to read it.
     {OP_NAME_XCHG,   0b11111110, 0b10000110, 0, 0, Xchg_RegisterOrMemoryWithRegister, {.NameIndex=OP_NAME_XCHG}},
 
@@ -949,39 +1095,39 @@ static op_definition OpTable[] =
     {OP_NAME_MOV,    0b11111111, 0b10001110, 0, 0, MovRegisterOrMemoryToSegmentRegister, {0}},
 
     {OP_NAME_ADD,    0b11111100, 0b00000000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_ADD, .ParamCount=2}},
-    {OP_NAME_ADD,    0b11111000, 0b10000000, 1, 0b000, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_ADD}},
+    {OP_NAME_ADD,    0b11111100, 0b10000000, 1, 0b000, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_ADD}},
     {OP_NAME_ADD,    0b11111110, 0b00000100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_ADD}},
 
     {OP_NAME_ADC,    0b11111100, 0b00010000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_ADC, .ParamCount=2}},
-    {OP_NAME_ADC,    0b11111000, 0b10000000, 1, 0b010, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_ADC}},
+    {OP_NAME_ADC,    0b11111100, 0b10000000, 1, 0b010, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_ADC}},
     {OP_NAME_ADC,    0b11111110, 0b00010100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_ADC}},
 
     {OP_NAME_SUB,    0b11111100, 0b00101000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_SUB, .ParamCount=2}},
-    {OP_NAME_SUB,    0b11111000, 0b10000000, 1, 0b101, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_SUB}},
+    {OP_NAME_SUB,    0b11111100, 0b10000000, 1, 0b101, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_SUB}},
     {OP_NAME_SUB,    0b11111110, 0b00101100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_SUB}},
 
     {OP_NAME_SBB,    0b11111100, 0b00011000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_SBB, .ParamCount=2}},
-    {OP_NAME_SBB,    0b11111000, 0b10000000, 1, 0b011, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_SBB}},
+    {OP_NAME_SBB,    0b11111100, 0b10000000, 1, 0b011, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_SBB}},
     {OP_NAME_SBB,    0b11111110, 0b00011100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_SBB}},
 
     {OP_NAME_CMP,    0b11111100, 0b00111000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_CMP, .ParamCount=2}},
-    {OP_NAME_CMP,    0b11111000, 0b10000000, 1, 0b111, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_CMP}},
+    {OP_NAME_CMP,    0b11111100, 0b10000000, 1, 0b111, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_CMP}},
     {OP_NAME_CMP,    0b11111110, 0b00111100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_CMP}},
 
     {OP_NAME_AND,    0b11111100, 0b00100000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_AND, .ParamCount=2}},
-    {OP_NAME_AND,    0b11111000, 0b10000000, 1, 0b100, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_AND, .NoSignExtension=1}},
+    {OP_NAME_AND,    0b11111100, 0b10000000, 1, 0b100, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_AND, .NoSignExtension=1}},
     {OP_NAME_AND,    0b11111110, 0b00100100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_AND}},
 
-    {OP_NAME_TEST,   0b11111100, 0b10000100, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_TEST, .ParamCount=2}},
+    {OP_NAME_TEST,   0b11111110, 0b10000100, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_TEST, .ParamCount=2}},
     {OP_NAME_TEST,   0b11111110, 0b11110110, 1, 0b000, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_TEST, .NoSignExtension=1}},
     {OP_NAME_TEST,   0b11111110, 0b10101000, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_TEST}},
 
     {OP_NAME_OR,     0b11111100, 0b00001000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_OR, .ParamCount=2}},
-    {OP_NAME_OR,     0b11111000, 0b10000000, 1, 0b001, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_OR, .NoSignExtension=1}},
+    {OP_NAME_OR,     0b11111100, 0b10000000, 1, 0b001, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_OR, .NoSignExtension=1}},
     {OP_NAME_OR,     0b11111110, 0b00001100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_OR}},
 
     {OP_NAME_XOR,    0b11111100, 0b00110000, 0, 0,     AddSubCmp_RegisterOrMemoryWithRegisterToEither, {.NameIndex=OP_NAME_XOR, .ParamCount=2}},
-    {OP_NAME_XOR,    0b11111000, 0b10000000, 1, 0b110, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_XOR, .NoSignExtension=1}},
+    {OP_NAME_XOR,    0b11111100, 0b10000000, 1, 0b110, AddSubCmp_ImmediateWithRegisterOrMemory,        {.NameIndex=OP_NAME_XOR, .NoSignExtension=1}},
     {OP_NAME_XOR,    0b11111110, 0b00110100, 0, 0,     AddSubCmp_ImmediateWithAccumulator,             {.NameIndex=OP_NAME_XOR}},
 
     {OP_NAME_LEA,    0b11111111, 0b10001101, 0, 0,     Lea, {.NameIndex=OP_NAME_LEA}},
@@ -1036,7 +1182,6 @@ static op_definition OpTable[] =
 
     {OP_NAME_CALL,   0b11111111, 0b11111111, 1, 0b010, CallJmp_IndirectIntraOrInterSegment, {.NameIndex=OP_NAME_CALL}},
     {OP_NAME_CALL,   0b11111111, 0b10011010, 0, 0, CallDirectIntersegment, {.NameIndex=OP_NAME_CALL}},
-    {OP_NAME_CALL,   0b11111111, 0b11111111, 1, 0b010, CallJmp_IndirectIntraOrInterSegment, {.NameIndex=OP_NAME_CALL}},
 
     {OP_NAME_JMP,    0b11111111, 0b11111111, 1, 0b100, CallJmp_IndirectIntraOrInterSegment, {.NameIndex=OP_NAME_JMP}},
     {OP_NAME_JMP,    0b11111111, 0b11111111, 1, 0b101, CallJmp_IndirectIntraOrInterSegment, {.NameIndex=OP_NAME_JMP, .IsFar=1}},
@@ -1103,6 +1248,104 @@ static op_definition OpTable[] =
     {SEGMENT_OVERRIDE, 0b11100111, 0b00100110, 0, 0, SegmentOverride, {0}},
 };
 
+// NOTE(chuck): OpTable gets compiled into this at startup. The first index is the first byte of the
+// instruction, the second is the REG field of the second byte, for entries that use it as an opcode
+// extension. Entries that don't care about the extension fill all 8 slots for their bytes.
+static op_definition *OpDispatch[256][8];
+
+static int BuildOpDispatch(void)
+{
+    int OverlapCount = 0;
+
+    for(int OpTableIndex = 0;
+        OpTableIndex < ArrayLength(OpTable);
+        ++OpTableIndex)
+    {
+        op_definition *OpDefinition = OpTable + OpTableIndex;
+        for(int FirstByte = 0;
+            FirstByte < 256;
+            ++FirstByte)
+        {
+            if((FirstByte & OpDefinition->PrefixMask) == OpDefinition->Prefix)
+            {
+                for(int Extension = 0;
+                    Extension < 8;
+                    ++Extension)
+                {
+                    int Claims = 1;
+                    if(OpDefinition->UseExtension == 1)
+                    {
+                        Claims = (Extension == OpDefinition->Extension);
+                    }
+                    else if(OpDefinition->UseExtension == 2)
+                    {
+                        // NOTE(chuck): The whole second byte is fixed (AAM/AAD). Slot it by its REG bits
+                        // and check the rest of the byte when decoding.
+                        Claims = (Extension == ((OpDefinition->Extension & 0b00111000) >> 3));
+                    }
+
+                    if(Claims)
+                    {
+                        op_definition **Slot = &OpDispatch[FirstByte][Extension];
+                        if(*Slot)
+                        {
+                            // NOTE(chuck): Refuse to pick a winner. Whichever one came first in the table
+                            // would win the old linear scan, and that is exactly the order-dependence
+                            // that used to cause silent misdecodes.
+                            fprintf(stderr, "ERROR: OpTable entries %d (%s) and %d (%s) overlap at first byte 0x%02X, extension %d\n",
+                                    (int)(*Slot - OpTable), OpNameLookup[(*Slot)->NameIndex],
+                                    OpTableIndex, OpNameLookup[OpDefinition->NameIndex],
+                                    FirstByte, Extension);
+                            ++OverlapCount;
+                        }
+                        else
+                        {
+                            *Slot = OpDefinition;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    int Result = (OverlapCount == 0);
+    return(Result);
+}
+
+// NOTE(chuck): Decodes the op at Context->IP. Bytes that don't start any op come back as a one-byte op with Error set.
+static op DecodeOp(parsing_context *Context)
+{
+    op Result = {0, Context->IP, 0};
+
+    int Found = 0;
+    op_definition *OpDefinition = OpDispatch[Context->IP[0]][(Context->IP[1] & 0b00111000) >> 3];
+    if(OpDefinition)
+    {
+        if((OpDefinition->UseExtension != 2) || (Context->IP[1] == OpDefinition->Extension))
+        {
+            Result = OpDefinition->Decode(Context, OpDefinition->DecodeOptions);
+            Found = 1;
+        }
+    }
+    if(!Found)
+    {
+        Result.Error = 1;
+        Result.ByteLength = 1;
+    }
+
+    return(Result);
+}
+
+// NOTE(chuck): Copy the segment override into the op it applies to so that EmitParam() knows what to do.
+static void ApplyPrefix(op *Prefix, op *Op)
+{
+    if(Prefix && (Prefix->NameIndex == SEGMENT_OVERRIDE) && (Op->NameIndex != SEGMENT_OVERRIDE))
+    {
+        Op->UseSegmentOverride = 1;
+        Op->SegmentOverride = Prefix->SegmentOverride;
+    }
+}
+
 static char *EffectiveAddressLookup[8] =
 {
     "bx + si",
@@ -1115,106 +1358,77 @@ static char *EffectiveAddressLookup[8] =
     "bx"
 };
 
-static int PrintParam(char *OutputInit, op *Op, op_param *Param)
+static void EmitParam(output_buffer *Output, op *Op, op_param *Param)
 {
-    char *Output = OutputInit;
-    int BytesWritten = 0;
-    int TotalBytesWritten = 0;
-
-#define EMIT(...) \
-    BytesWritten = sprintf(Output, __VA_ARGS__); \
-    Output += BytesWritten; \
-    TotalBytesWritten += BytesWritten;
-
     switch(Param->Type)
     {
         case Param_Immediate:
         {
-            EMIT("%d", Param->ImmediateValue);
+            EmitInt(Output, Param->ImmediateValue);
         } break;
 
         case Param_Register:
         {
-            EMIT("%s", RegisterLookup[Param->RegisterOrMemoryIndex]);
+            EmitString(Output, RegisterLookup[Param->RegisterOrMemoryIndex]);
         } break;
 
         case Param_SegmentRegister:
         {
-            EMIT("%s", SegmentRegisterLookup[Param->RegisterOrMemoryIndex]);
+            EmitString(Output, SegmentRegisterLookup[Param->RegisterOrMemoryIndex]);
         } break;
         
         case Param_Memory:
         {
             if(Op->UseSegmentOverride)
             {
-                EMIT("%s:", SegmentRegisterLookup[Op->SegmentOverride]);
+                EmitString(Output, SegmentRegisterLookup[Op->SegmentOverride]);
+                EmitChar(Output, ':');
             }
 
-            EMIT("[%s", EffectiveAddressLookup[Param->RegisterOrMemoryIndex]);
+            EmitChar(Output, '[');
+            EmitString(Output, EffectiveAddressLookup[Param->RegisterOrMemoryIndex]);
             int Offset = Param->Offset;
             if(Offset)
             {
                 if(Offset < 0)
                 {
-                    EMIT(" - ");
+                    EmitBytes(Output, " - ", 3);
                     Offset *= -1;
                 }
                 else
                 {
-                    EMIT(" + ");
+                    EmitBytes(Output, " + ", 3);
                 }
-                EMIT("%d", Offset);
+                EmitInt(Output, Offset);
             }
-            EMIT("]");
+            EmitChar(Output, ']');
         } break;
 
         case Param_MemoryDirectAddress:
         {
             if(Op->UseSegmentOverride)
             {
-                EMIT("%s:", SegmentRegisterLookup[Op->SegmentOverride]);
+                EmitString(Output, SegmentRegisterLookup[Op->SegmentOverride]);
+                EmitChar(Output, ':');
             }
 
-            EMIT("[%d]", Param->Offset);
+            EmitChar(Output, '[');
+            EmitInt(Output, Param->Offset);
+            EmitChar(Output, ']');
         } break;
 
         case Param_DirectIntersegment:
         {
-            EMIT("%d:%d", Param->CS, Param->IP);
+            EmitInt(Output, Param->CS);
+            EmitChar(Output, ':');
+            EmitInt(Output, Param->IP);
         } break;
 
         default:
         {
-            EMIT("<unknown parameter type: %d>", Param->Type);
-            if(Output != OutputInit)
-            {
-                EMIT(" <partial output: %s>", OutputInit);
-            }
+            EmitFormat(Output, "<unknown parameter type: %d>", Param->Type);
         } break;
     }
-
-#undef EMIT
-
-    return TotalBytesWritten;
-}
-
-static int CompareJumps(const void *A, const void *B)
-{
-    jump *AJump = (jump *)A;
-    jump *BJump = (jump *)B;
-
-    int Result = 0;
-
-    if(AJump->Offset < BJump->Offset)
-    {
-        Result = -1;
-    }
-    else if(AJump->Offset > BJump->Offset)
-    {
-        Result = 1;
-    }
-
-    return(Result);
 }
 
 static int PrintFlags(char *Buffer, int Flags)
@@ -1284,8 +1498,13 @@ static void PrintBinary(u16 Value)
     }
 }
 
-static u16 SetFlags(u16 Flags, u16 Value)
+// NOTE(chuck): A and B are already cut down to the size of the op, so the carry (or the borrow, which wraps every bit above it) lands in the bit just past the sign.
+static u16 SetArithmeticFlags(u16 Flags, u32 A, u32 B, int IsSub, int Word)
 {
+    u32 SignBit = Word ? 0x8000 : 0x80;
+    u32 Value = IsSub ? (A - B) : (A + B);
+    u32 Overflow = IsSub ? ((A ^ B) & (A ^ Value)) : ((A ^ Value) & (B ^ Value));
+
     int BitSetCount = 0;
     int V = Value & 0xff;
     while(V)
@@ -1297,553 +1516,3904 @@ static u16 SetFlags(u16 Flags, u16 Value)
         V >>= 1;
     }
 
-    if(Value == 0)
-    {
-        Flags |= FLAG_ZERO;
-    }
-    else
+    Flags &= ~(FLAG_CARRY | FLAG_PARITY | FLAG_AUX_CARRY | FLAG_ZERO | FLAG_SIGN | FLAG_OVERFLOW);
+    if(Value & (SignBit << 1))
     {
-        Flags &= ~FLAG_ZERO;
+        Flags |= FLAG_CARRY;
     }
-
     if((BitSetCount & 1) == 0)
     {
         Flags |= FLAG_PARITY;
     }
-    else
+    if((A ^ B ^ Value) & 0x10)
     {
-        Flags &= ~FLAG_PARITY;
+        Flags |= FLAG_AUX_CARRY;
     }
-
-    if(Value & 0x8000)
+    if((Value & ((SignBit << 1) - 1)) == 0)
+    {
+        Flags |= FLAG_ZERO;
+    }
+    if(Value & SignBit)
     {
         Flags |= FLAG_SIGN;
     }
-    else
+    if(Overflow & SignBit)
     {
-        Flags &= ~FLAG_SIGN;
+        Flags |= FLAG_OVERFLOW;
     }
 
     return(Flags);
 }
 
-int main(int ArgCount, char **Args)
+// NOTE(chuck): Effective address tables, in the same order as EffectiveAddressLookup plus one more slot for a direct address, so turning a memory operand into an address is three lookups instead of a branch on which registers it uses. The missing half of "si", "di", "bp" and "bx" (and both halves of a direct address) reads a register that is always zero.
+#define EFFECTIVE_ADDRESS_DIRECT 8
+static u16 ZeroRegister;
+static u16 *EffectiveAddressBase[9] =
 {
-    int Result = 0;
-    int HitError = 0;
+    &CPUState.Registers[3], // NOTE(chuck): bx
+    &CPUState.Registers[3],
+    &CPUState.Registers[5], // NOTE(chuck): bp
+    &CPUState.Registers[5],
+    &CPUState.Registers[6], // NOTE(chuck): si
+    &CPUState.Registers[7], // NOTE(chuck): di
+    &CPUState.Registers[5],
+    &CPUState.Registers[3],
+    &ZeroRegister,
+};
+static u16 *EffectiveAddressIndex[9] =
+{
+    &CPUState.Registers[6],
+    &CPUState.Registers[7],
+    &CPUState.Registers[6],
+    &CPUState.Registers[7],
+    &ZeroRegister,
+    &ZeroRegister,
+    &ZeroRegister,
+    &ZeroRegister,
+    &ZeroRegister,
+};
+// NOTE(chuck): Anything based off of bp defaults to the stack segment.
+static u8 EffectiveAddressSegment[9] =
+{
+    SEGMENT_REGISTER_NAME_DS,
+    SEGMENT_REGISTER_NAME_DS,
+    SEGMENT_REGISTER_NAME_SS,
+    SEGMENT_REGISTER_NAME_SS,
+    SEGMENT_REGISTER_NAME_DS,
+    SEGMENT_REGISTER_NAME_DS,
+    SEGMENT_REGISTER_NAME_SS,
+    SEGMENT_REGISTER_NAME_DS,
+    SEGMENT_REGISTER_NAME_DS,
+};
 
-    char *Filename = Args[1];
+static u32 GetMemoryAddress(op *SegmentPrefix, op_param *Param)
+{
+    int Index = (Param->Type == Param_Memory) ? Param->RegisterOrMemoryIndex : EFFECTIVE_ADDRESS_DIRECT;
+    int Segment = SegmentPrefix ? SegmentPrefix->SegmentOverride : EffectiveAddressSegment[Index];
+    u16 Offset = (u16)(*EffectiveAddressBase[Index] + *EffectiveAddressIndex[Index] + Param->Offset);
+    u32 Result = (((u32)CPUState.SegmentRegisters[Segment] << 4) + Offset) & MEMORY_ADDRESS_MASK;
+    return(Result);
+}
 
-    int Exec = 0;
-    if(!strcmp(Args[1], "-exec"))
+static u16 ReadMemory(u32 Address, int Word)
+{
+    u16 Result = Memory[Address];
+    if(Word)
     {
-        Exec = 1;
-        Filename = Args[2];
-        printf("--- %s ---\n", Filename);
+        Result |= (u16)(Memory[(Address + 1) & MEMORY_ADDRESS_MASK] << 8);
     }
+    return(Result);
+}
 
-    FILE *File = fopen(Filename, "rb");
-    size_t ByteLength = fread(OpStream, 1, ArrayLength(OpStream), File);
+// NOTE(chuck): Stores a byte or word and notes it in the op's trace record.
+static void WriteMemory(trace_record *Record, u32 Address, u16 Before, u16 After, int Word)
+{
+    Memory[Address] = (u8)After;
+    if(Word)
+    {
+        Memory[(Address + 1) & MEMORY_ADDRESS_MASK] = (u8)(After >> 8);
+    }
+
+    Record->Flags |= Trace_MemoryWrite;
+    Record->MemoryAddress = Address;
+    Record->MemoryBefore = Before;
+    Record->MemoryAfter = After;
+}
 
-    printf("bits 16\n");
+// NOTE(chuck): Runs a single op against CPUState and reports what it changed. NextIP is where execution goes after it.
+// SegmentPrefix is the segment override IP actually went through to get here, if there was one.
+static trace_record ExecuteOp(op *Op, op *SegmentPrefix, u32 IP, u32 *NextIP)
+{
+    *NextIP = IP + Op->ByteLength;
 
-    u8 *EndOfData = OpStream + ByteLength;
-    parsing_context Context = {OpStream, OpStream};
-    while(Context.IP < EndOfData)
+    trace_record Result = {0};
+    Result.IP = IP;
+    Result.NameIndex = (u16)Op->NameIndex;
+    Result.Register = TRACE_NO_REGISTER;
+    Result.FlagsBefore = CPUState.Flags;
+
+    op_param *Source = 0;
+    op_param *Dest = 0;
+    u16 FlagsBefore = Result.FlagsBefore;
+
+    u16 SourceValue = 0xcccc;
+    if(Op->ParamCount >= SOURCE)
     {
-        op Op = {0, Context.IP, 0};
+        Source = &Op->Param[SOURCE];
 
-        int OpTableLength = ArrayLength(OpTable);
-        int OpTableIndex;
-        int Found = 0;
-        for(OpTableIndex = 0;
-            OpTableIndex < OpTableLength;
-            ++OpTableIndex)
+        if(Source->Type == Param_Immediate)
+        {
+            SourceValue = (u16)Source->ImmediateValue;
+        }
+        else if(Source->Type == Param_Register)
         {
-            op_definition *OpDefinition = OpTable + OpTableIndex;
-            if((Context.IP[0] & OpDefinition->PrefixMask) == OpDefinition->Prefix)
+            if(Source->RegisterOrMemoryIndex < 8)
             {
-                if(OpDefinition->UseExtension)
+                if(Source->RegisterOrMemoryIndex < 4)
                 {
-                    if(OpDefinition->UseExtension == 1)
-                    {
-                        int OpCodeExtension = ((Context.IP[1] & 0b00111000) >> 3);
-                        if(OpCodeExtension == OpDefinition->Extension)
-                        {
-                            Op = OpDefinition->Decode(&Context, OpDefinition->DecodeOptions);
-                            Found = 1;
-                            break;
-                        }
-                    }
-                    else if(OpDefinition->UseExtension == 2)
-                    {
-                        if(Context.IP[1] == OpDefinition->Extension)
-                        {
-                            Op = OpDefinition->Decode(&Context, OpDefinition->DecodeOptions);
-                            Found = 1;
-                            break;
-                        }
-                    }
+                    SourceValue = CPUState.Registers[Source->RegisterOrMemoryIndex];
                 }
                 else
                 {
-                    Op = OpDefinition->Decode(&Context, OpDefinition->DecodeOptions);
-                    Found = 1;
-                    break;
+                    SourceValue = CPUState.Registers[Source->RegisterOrMemoryIndex - 4] >> 8;
                 }
             }
+            else
+            {
+                SourceValue = CPUState.Registers[Source->RegisterOrMemoryIndex - 8];
+            }
         }
-        if(!Found)
+        else if(Source->Type == Param_SegmentRegister)
         {
-            Op.Error = 1;
-            Op.ByteLength = 1;
+            SourceValue = CPUState.SegmentRegisters[Source->RegisterOrMemoryIndex];
+        }
+        else if((Source->Type == Param_Memory) || (Source->Type == Param_MemoryDirectAddress))
+        {
+            SourceValue = ReadMemory(GetMemoryAddress(SegmentPrefix, Source), Op->Word);
         }
-
-        OpList[OpCount++] = Op;
-
-        Assert(Op.ByteLength);
-        Context.IP += Op.ByteLength;
     }
 
-    // TODO(chuck): Rethink the jump targetting. This seems too complicated?
-    jump JumpTargets[100] = {0};
-    int JumpCount = 0;
-
-    for(int MaybeJumpIndex = 0;
-        MaybeJumpIndex < OpCount;
-        ++MaybeJumpIndex)
+    u16 DestValue = 0xcccc;
+    u32 DestAddress = 0;
+    int DestIsMemory = 0;
+    if(Op->ParamCount >= DESTINATION)
     {
-        op *MaybeJump = &OpList[MaybeJumpIndex];
-        if(MaybeJump->IsRelativeJump)
+        Dest = &Op->Param[DESTINATION];
+
+        int DestRegisterIndex = 0xcccc;
+        if(Dest->Type == Param_Register)
         {
-            __int64 InstructionOffset = (MaybeJump->IP - OpStream);
-            __int64 JumpBase = (InstructionOffset + MaybeJump->ByteLength);
-            __int64 JumpTo = JumpBase + MaybeJump->Param[0].ImmediateValue;
+            DestRegisterIndex = Dest->RegisterOrMemoryIndex;
 
-            for(int MaybeJumpTargetIndex = 0;
-                MaybeJumpTargetIndex < OpCount;
-                ++MaybeJumpTargetIndex)
+            if(DestRegisterIndex < 8)
             {
-                op *MaybeJumpTarget = &OpList[MaybeJumpTargetIndex];
-                __int64 CurrentOffset = MaybeJumpTarget->IP - OpStream;
-                if(JumpTo == CurrentOffset)
+                if(DestRegisterIndex < 4)
                 {
-                    // NOTE(chuck): Only add if this is a unique target. Don't assign the JumpTargetIndex yet because the target may not be the first label lexically.
-                    if(!MaybeJumpTarget->IsJumpTarget)
-                    {
-                        MaybeJumpTarget->IsJumpTarget = 1;
-                        JumpTargets[JumpCount++] = (jump){MaybeJumpTarget, CurrentOffset};
-                    }
-                    break;
+                    DestValue = CPUState.Registers[DestRegisterIndex];
+                }
+                else
+                {
+                    DestRegisterIndex -= 4;
+                    DestValue = CPUState.Registers[DestRegisterIndex];
                 }
             }
+            else
+            {
+                DestRegisterIndex -= 8;
+                DestValue = CPUState.Registers[DestRegisterIndex];
+            }
         }
-    }
-
-    qsort(JumpTargets, JumpCount, sizeof(jump), CompareJumps);
-
-    int LabelCount = 0;
-    for(int OpIndex = 0;
-        OpIndex < OpCount;
-        ++OpIndex)
-    {
-        op *Op = &OpList[OpIndex];
-        __int64 CurrentOffset = (Op->IP - OpStream);
-
-        if(Op->IsJumpTarget)
+        else if(Dest->Type == Param_SegmentRegister)
         {
-            printf("\nlabel%d:\n", LabelCount++);
+            DestValue = CPUState.SegmentRegisters[Dest->RegisterOrMemoryIndex];
         }
-        
-        if(Op->Error)
+        else if((Dest->Type == Param_Memory) || (Dest->Type == Param_MemoryDirectAddress))
         {
-            HitError = 1; // NOTE(chuck): Trip this so that all subsequent output is commented. I just want to see it continue attempting to decode the rest of the stream, even if most of it is garbage, in case it is useful for debugging.
-
-            char OpBytes[32] = {0};
-            sprintf(OpBytes, "%02X", Op->IP[0]);
-            printf("%-40s  0x%08llX: %s\n", "; ???", (Op->IP - OpStream), OpBytes);
-            Result = 1;
+            DestIsMemory = 1;
+            DestAddress = GetMemoryAddress(SegmentPrefix, Dest);
+            DestValue = ReadMemory(DestAddress, Op->Word);
         }
-        else
-        {
-            char Line[1024] = {0};
-            char *LinePointer = Line;
+    }
 
-            // NOTE(chuck): Copy the segment override into the next op so that PrintParam() knows what to do.
-            if(Op->NameIndex == SEGMENT_OVERRIDE)
-            {
-                OpList[OpIndex + 1].UseSegmentOverride = 1;
-                OpList[OpIndex + 1].SegmentOverride = Op->SegmentOverride;
-            }
+    if((Op->NameIndex == OP_NAME_MOV) && DestIsMemory)
+    {
+        u16 NewValue = Op->Word ? SourceValue : (SourceValue & 0xff);
+        WriteMemory(&Result, DestAddress, DestValue, NewValue, Op->Word);
+    }
+    else if((Op->NameIndex == OP_NAME_MOV) && Dest)
+    {
+        Result.Flags |= Trace_RegisterWrite;
+        u16 DestValueAfter  = 0xcccc;
+        u16 DestValueBefore = DestValue;
 
-            if(Op->NameIndex >= ArrayLength(OpNameLookup))
-            {
-                LinePointer += sprintf(LinePointer, "  <corrupted?> ");
-            }
-            else
+        if(Dest->Type == Param_Register)
+        {
+            int DestRegisterIndex = Dest->RegisterOrMemoryIndex;
+            if(DestRegisterIndex < 8)
             {
-                // TODO(chuck): This is fudgeville!
-                if((OpIndex == 0) || ((OpIndex > 0) && !IsPrefix(&OpList[OpIndex - 1])))
+                if(DestRegisterIndex < 4)
                 {
-                    LinePointer += sprintf(LinePointer, "  ");
+                    u16 NewValue  = (CPUState.Registers[DestRegisterIndex] & 0xff00);
+                        NewValue |= (SourceValue & 0xff);
+                    CPUState.Registers[DestRegisterIndex] = NewValue;
                 }
-
-                LinePointer += sprintf(LinePointer, "%s", OpNameLookup[Op->NameIndex]);
-                if(Op->Suffix)
+                else
                 {
-                    LinePointer += sprintf(LinePointer, "%c", Op->Suffix);
+                    DestRegisterIndex -= 4;
+                    u16 NewValue  = (CPUState.Registers[DestRegisterIndex] & 0x00ff);
+                        NewValue |= ((SourceValue & 0xff) << 8);
+                    CPUState.Registers[DestRegisterIndex] = NewValue;
                 }
+            }
+            else
+            {
+                DestRegisterIndex -= 8;
+                CPUState.Registers[DestRegisterIndex] = (SourceValue & 0xffff);
+            }
 
-                // TODO(chuck): This is fudgeville!
-                if((Op->NameIndex == OP_NAME_MOVS) ||
-                   (Op->NameIndex == OP_NAME_CMPS) ||
-                   (Op->NameIndex == OP_NAME_SCAS) ||
-                   (Op->NameIndex == OP_NAME_LODS) ||
-                   (Op->NameIndex == OP_NAME_STOS))
-                {
-                    LinePointer += sprintf(LinePointer, "%c", Op->Word ? 'w' : 'b');
-                }
+            DestValueAfter = CPUState.Registers[DestRegisterIndex];
+            Result.Register = (u8)DestRegisterIndex;
+        }
+        else if(Dest->Type == Param_SegmentRegister)
+        {
+            DestValueAfter = CPUState.SegmentRegisters[Dest->RegisterOrMemoryIndex] = (SourceValue & 0xffff);
+            Result.Register = (u8)(TRACE_SEGMENT_REGISTER + Dest->RegisterOrMemoryIndex);
+        }
 
-                if(Op->NameIndex != SEGMENT_OVERRIDE)
-                {
-                    LinePointer += sprintf(LinePointer, " ");
-                }
-            }
+        Result.RegisterBefore = DestValueBefore;
+        Result.RegisterAfter = DestValueAfter;
+    }
+    else if(((Op->NameIndex == OP_NAME_SUB) ||
+             (Op->NameIndex == OP_NAME_CMP) ||
+             (Op->NameIndex == OP_NAME_ADD)) && Dest)
+    {
+        int IsAdd = (Op->NameIndex == OP_NAME_ADD);
+        int IsCmp = (Op->NameIndex == OP_NAME_CMP);
+        u16 DestValueBefore = DestValue;
+        u16 ComputedValue = 0xcccc;
+        u16 *DestRegister = 0;
 
-            if(Op->ParamCount > 0)
+        if(Dest->Type == Param_Register)
+        {
+            int DestRegisterIndex = Dest->RegisterOrMemoryIndex;
+            if(DestRegisterIndex < 8)
             {
-                if(Op->IsRelativeJump)
+                if(DestRegisterIndex < 4)
                 {
-#if 0
-                    LinePointer += sprintf(LinePointer, "$+0");
-                    if(Op->Param[0].ImmediateValue >= 0)
+                    DestRegister = &CPUState.Registers[DestRegisterIndex];
+                    ComputedValue = *DestRegister;
+                    if(IsAdd)
                     {
-                        LinePointer += sprintf(LinePointer, "+");
+                        ComputedValue += (SourceValue & 0xff);
                     }
-                    LinePointer += sprintf(LinePointer, "%d", Op->Param[0].ImmediateValue + 2);
-#else
-                    __int64 InstructionOffset = (Op->IP - OpStream);
-                    __int64 JumpBase = (InstructionOffset + Op->ByteLength);
-                    __int64 JumpTo = JumpBase + Op->Param[0].ImmediateValue;
-
-                    int JumpTargetIndex;
-                    for(JumpTargetIndex = 0;
-                        JumpTargetIndex < JumpCount;
-                        ++JumpTargetIndex)
+                    else
                     {
-                        jump *JumpTarget = &JumpTargets[JumpTargetIndex];
-                        if(JumpTo == JumpTarget->Offset)
-                        {
-                            LinePointer += sprintf(LinePointer, "label%d", JumpTargetIndex);
-                            break;
-                        }
+                        ComputedValue -= (SourceValue & 0xff);
                     }
-                    if(JumpTargetIndex == JumpCount)
-                    {
-                        HitError = 1;
+                }
+                else
+                {
+                    DestRegisterIndex -= 4;
+                    DestRegister = &CPUState.Registers[DestRegisterIndex];
+                    ComputedValue = *DestRegister;
+                    if(IsAdd)
+                    {
+                        ComputedValue += ((SourceValue & 0xff) << 8);
                     }
-#endif
+                    else
+                    {
+                        ComputedValue -= ((SourceValue & 0xff) << 8);
+                    }
+                }
+            }
+            else
+            {
+                DestRegisterIndex -= 8;
+                DestRegister = &CPUState.Registers[DestRegisterIndex];
+                ComputedValue = *DestRegister;
+                if(IsAdd)
+                {
+                    ComputedValue += (SourceValue & 0xffff);
+                }
+                else
+                {
+                    ComputedValue -= (SourceValue & 0xffff);
+                }
+            }
+        }
+        else if(Dest->Type == Param_SegmentRegister)
+        {
+            DestRegister = &CPUState.SegmentRegisters[Dest->RegisterOrMemoryIndex];
+            ComputedValue = *DestRegister;
+            if(IsAdd)
+            {
+                ComputedValue += SourceValue;
+            }
+            else
+            {
+                ComputedValue -= SourceValue;
+            }
+        }
+        else if(DestIsMemory)
+        {
+            ComputedValue = (u16)(IsAdd ? (DestValue + SourceValue) : (DestValue - SourceValue));
+            if(!Op->Word)
+            {
+                ComputedValue &= 0xff;
+            }
+        }
+
+        if(!IsCmp && DestIsMemory)
+        {
+            WriteMemory(&Result, DestAddress, DestValueBefore, ComputedValue, Op->Word);
+        }
+        else if(!IsCmp)
+        {
+            Result.Flags |= Trace_RegisterWrite;
+            Result.RegisterBefore = DestValueBefore;
+            Result.RegisterAfter = ComputedValue;
+
+            // NOTE(chuck): Destinations that aren't simulated still show up in the trace but don't go anywhere.
+            if(DestRegister)
+            {
+                *DestRegister = ComputedValue;
+                if(Dest->Type == Param_SegmentRegister)
+                {
+                    Result.Register = (u8)(TRACE_SEGMENT_REGISTER + Dest->RegisterOrMemoryIndex);
+                }
+                else
+                {
+                    Result.Register = (u8)(DestRegister - CPUState.Registers);
+                }
+            }
+        }
+
+        // NOTE(chuck): The flags come from the op at its own size, so a byte op only looks at the byte it changed.
+        int Word = 1;
+        int Shift = 0;
+        if(Dest->Type == Param_Register)
+        {
+            Word = (Dest->RegisterOrMemoryIndex >= 8);
+            Shift = ((Dest->RegisterOrMemoryIndex >= 4) && !Word) ? 8 : 0;
+        }
+        else if(DestIsMemory)
+        {
+            Word = Op->Word;
+        }
+        u32 Mask = Word ? 0xffff : 0xff;
+        CPUState.Flags = SetArithmeticFlags(FlagsBefore, (DestValueBefore >> Shift) & Mask, SourceValue & Mask, !IsAdd, Word);
+    }
+    else if(Op->IsRelativeJump)
+    {
+        int CF = ((FlagsBefore & FLAG_CARRY) != 0);
+        int PF = ((FlagsBefore & FLAG_PARITY) != 0);
+        int ZF = ((FlagsBefore & FLAG_ZERO) != 0);
+        int SF = ((FlagsBefore & FLAG_SIGN) != 0);
+        int OF = ((FlagsBefore & FLAG_OVERFLOW) != 0);
+
+        int Jump = 0;
+        switch(Op->NameIndex)
+        {
+            case OP_NAME_JE:  { Jump = ZF; } break;
+            case OP_NAME_JL:  { Jump = (SF != OF); } break;
+            case OP_NAME_JLE: { Jump = ZF || (SF != OF); } break;
+            case OP_NAME_JB:  { Jump = CF; } break;
+            case OP_NAME_JBE: { Jump = CF || ZF; } break;
+            case OP_NAME_JP:  { Jump = PF; } break;
+            case OP_NAME_JO:  { Jump = OF; } break;
+            case OP_NAME_JS:  { Jump = SF; } break;
+            case OP_NAME_JNZ: { Jump = !ZF; } break;
+            case OP_NAME_JNL: { Jump = (SF == OF); } break;
+            case OP_NAME_JG:  { Jump = !ZF && (SF == OF); } break;
+            case OP_NAME_JNB: { Jump = !CF; } break;
+            case OP_NAME_JA:  { Jump = !CF && !ZF; } break;
+            case OP_NAME_JNP: { Jump = !PF; } break;
+            case OP_NAME_JNO: { Jump = !OF; } break;
+            case OP_NAME_JNS: { Jump = !SF; } break;
+            case OP_NAME_JCXZ: { Jump = (CPUState.Registers[REGISTER_NAME_CX - 8] == 0); } break;
+            case OP_NAME_JMP: { Jump = 1; } break;
+
+            case OP_NAME_LOOP:
+            case OP_NAME_LOOPZ:
+            case OP_NAME_LOOPNZ:
+            {
+                // NOTE(chuck): The loops count cx down before they look at it, and that shows up in the trace like any other register write.
+                u16 *CX = &CPUState.Registers[REGISTER_NAME_CX - 8];
+                Result.Flags |= Trace_RegisterWrite;
+                Result.Register = (u8)(REGISTER_NAME_CX - 8);
+                Result.RegisterBefore = *CX;
+                Result.RegisterAfter = --*CX;
+
+                Jump = (*CX != 0);
+                if(Op->NameIndex == OP_NAME_LOOPZ)
+                {
+                    Jump = Jump && ZF;
+                }
+                else if(Op->NameIndex == OP_NAME_LOOPNZ)
+                {
+                    Jump = Jump && !ZF;
+                }
+            } break;
+        }
+
+        if(Jump)
+        {
+            *NextIP = IP + Op->ByteLength + Op->Param[0].ImmediateValue;
+        }
+    }
+    else if((Op->NameIndex == OP_NAME_JMP) && !Op->IsFar && Dest)
+    {
+        // NOTE(chuck): A near jmp that isn't relative goes to an offset sitting in a register or memory.
+        if(Dest->Type != Param_DirectIntersegment)
+        {
+            *NextIP = DestValue;
+        }
+    }
+
+    Result.FlagsAfter = CPUState.Flags;
+
+    return(Result);
+}
+
+static void InitProgram(program *Program, u8 *OpStream, u32 ProgramLength, op **OpAtOffset)
+{
+    memset(Program, 0, sizeof(*Program));
+    Program->OpStream = OpStream;
+    Program->ProgramLength = ProgramLength;
+    Program->OpAtOffset = OpAtOffset;
+    Program->DecodedAtOffset = PushArray(&DecodedOpArena, op *, ProgramLength + 1);
+    memset(Program->DecodedAtOffset, 0, (ProgramLength + 1)*sizeof(op *));
+}
+
+// NOTE(chuck): The op that runs when IP is at Offset, which is the one after any prefixes there. Zero once IP is off the end of the program.
+// The same op can be reached with or without the prefixes in front of it, so the segment override comes back
+// in SegmentPrefix (from the prefixes walked this time) instead of off of the op.
+static op *GetExecutableOp(program *Program, u32 Offset, op **SegmentPrefix)
+{
+    op *Result = 0;
+    op *Prefix = 0;
+    while(Offset < Program->ProgramLength)
+    {
+        op *Op = Program->OpAtOffset[Offset];
+        if(!Op)
+        {
+            Op = Program->DecodedAtOffset[Offset];
+        }
+        if(!Op)
+        {
+            parsing_context Context = {Program->OpStream, Program->OpStream + Offset};
+            Op = PushStruct(&DecodedOpArena, op);
+            *Op = DecodeOp(&Context);
+            Program->DecodedAtOffset[Offset] = Op;
+        }
+
+        if(Op->Error || !IsPrefix(Op))
+        {
+            Result = Op;
+            break;
+        }
+
+        if(Op->NameIndex == SEGMENT_OVERRIDE)
+        {
+            Prefix = Op;
+        }
+        Offset += Op->ByteLength;
+    }
+
+    if(SegmentPrefix)
+    {
+        *SegmentPrefix = Prefix;
+    }
+
+    return(Result);
+}
+
+// NOTE(chuck): Runs the op at IP and moves IP to wherever that op sends it. Returns 0 once there is nothing left to run.
+static int StepProgram(program *Program, trace_record *Record)
+{
+    int Result = 0;
+    op *SegmentPrefix = 0;
+    op *Op = (Program->Stopped || !Program->StepsLeft) ? 0 : GetExecutableOp(Program, Program->IP, &SegmentPrefix);
+    if(Op)
+    {
+        --Program->StepsLeft;
+        u32 Offset = (u32)(Op->IP - Program->OpStream);
+        if(Op->Error)
+        {
+            // NOTE(chuck): Bytes that aren't an op still get a record (with nothing changed), so that anything reading the trace back knows where it stopped.
+            trace_record Stop = {0};
+            Stop.IP = Offset;
+            Stop.NameIndex = (u16)Op->NameIndex;
+            Stop.Register = TRACE_NO_REGISTER;
+            Stop.FlagsBefore = CPUState.Flags;
+            Stop.FlagsAfter = CPUState.Flags;
+            *Record = Stop;
+            Program->Stopped = 1;
+        }
+        else
+        {
+            *Record = ExecuteOp(Op, SegmentPrefix, Offset, &Program->IP);
+        }
+        Result = 1;
+    }
+
+    return(Result);
+}
+
+// NOTE(chuck): A program that never runs off its end would go forever, so it gets cut off after DEFAULT_MAX_STEPS, or whatever -max-steps says. Say so when that happens, since the output looks just like a program that finished.
+static void ReportStepLimit(program *Program, u64 MaxSteps)
+{
+    if(!Program->StepsLeft && !Program->Stopped && GetExecutableOp(Program, Program->IP, 0))
+    {
+        fprintf(stderr, "WARNING: Stopped after %llu steps, at 0x%08X.\n", MaxSteps, Program->IP);
+    }
+}
+
+static void EmitMnemonic(output_buffer *Output, op *Op)
+{
+    EmitString(Output, OpNameLookup[Op->NameIndex]);
+    if(Op->Suffix)
+    {
+        EmitChar(Output, Op->Suffix);
+    }
+
+    // TODO(chuck): This is fudgeville!
+    if((Op->NameIndex == OP_NAME_MOVS) ||
+       (Op->NameIndex == OP_NAME_CMPS) ||
+       (Op->NameIndex == OP_NAME_SCAS) ||
+       (Op->NameIndex == OP_NAME_LODS) ||
+       (Op->NameIndex == OP_NAME_STOS))
+    {
+        EmitChar(Output, Op->Word ? 'w' : 'b');
+    }
+}
+
+static void EmitHexBytes(output_buffer *Output, u8 *Bytes, int Count)
+{
+    static char LowerHexDigits[] = "0123456789abcdef";
+    ReserveOutput(Output, 2*Count);
+    for(int ByteIndex = 0;
+        ByteIndex < Count;
+        ++ByteIndex)
+    {
+        Output->Base[Output->Used++] = LowerHexDigits[Bytes[ByteIndex] >> 4];
+        Output->Base[Output->Used++] = LowerHexDigits[Bytes[ByteIndex] & 0xF];
+    }
+}
+
+static void EmitOperandJSON(output_buffer *Output, op *Op, op_param *Param, __int64 JumpTarget)
+{
+    if(Op->IsRelativeJump)
+    {
+        EmitString(Output, "{\"type\":\"relative\",\"displacement\":");
+        EmitInt(Output, Param->ImmediateValue);
+        EmitString(Output, ",\"target\":");
+        EmitInt(Output, (int)JumpTarget);
+        EmitChar(Output, '}');
+    }
+    else switch(Param->Type)
+    {
+        case Param_Immediate:
+        {
+            EmitString(Output, "{\"type\":\"immediate\",\"value\":");
+            EmitInt(Output, Param->ImmediateValue);
+            EmitChar(Output, '}');
+        } break;
+
+        case Param_Register:
+        case Param_SegmentRegister:
+        {
+            EmitString(Output, "{\"type\":\"register\",\"name\":\"");
+            EmitString(Output, (Param->Type == Param_Register) ?
+                       RegisterLookup[Param->RegisterOrMemoryIndex] :
+                       SegmentRegisterLookup[Param->RegisterOrMemoryIndex]);
+            EmitString(Output, "\"}");
+        } break;
+
+        case Param_Memory:
+        case Param_MemoryDirectAddress:
+        {
+            EmitString(Output, "{\"type\":\"memory\",\"terms\":[");
+            if(Param->Type == Param_Memory)
+            {
+                char **Terms = EffectiveAddressTerms[Param->RegisterOrMemoryIndex];
+                EmitChar(Output, '"');
+                EmitString(Output, Terms[0]);
+                EmitChar(Output, '"');
+                if(Terms[1][0])
+                {
+                    EmitString(Output, ",\"");
+                    EmitString(Output, Terms[1]);
+                    EmitChar(Output, '"');
+                }
+            }
+            EmitString(Output, "],\"displacement\":");
+            EmitInt(Output, Param->Offset);
+            EmitChar(Output, '}');
+        } break;
+
+        case Param_DirectIntersegment:
+        {
+            EmitString(Output, "{\"type\":\"memory\",\"explicit_segment\":");
+            EmitInt(Output, Param->CS);
+            EmitString(Output, ",\"displacement\":");
+            EmitInt(Output, Param->IP);
+            EmitChar(Output, '}');
+        } break;
+
+        default:
+        {
+            EmitString(Output, "{\"type\":\"unknown\"}");
+        } break;
+    }
+}
+
+// NOTE(chuck): Same columns as sim86's CSV: every operand gets type, register, term0, term1, displacement, value, and only fills in the ones that apply.
+static void EmitCSVHeader(output_buffer *Output)
+{
+    EmitString(Output, "address,size,bytes,mnemonic,lock,rep,segment,wide,far,segment_override");
+    for(int ParamIndex = 0;
+        ParamIndex < 2;
+        ++ParamIndex)
+    {
+        char *Columns[] = {"type", "register", "term0", "term1", "displacement", "value"};
+        for(int ColumnIndex = 0;
+            ColumnIndex < ArrayLength(Columns);
+            ++ColumnIndex)
+        {
+            EmitString(Output, ",op");
+            EmitInt(Output, ParamIndex);
+            EmitChar(Output, '_');
+            EmitString(Output, Columns[ColumnIndex]);
+        }
+    }
+    EmitChar(Output, '\n');
+}
+
+static void EmitOperandCSV(output_buffer *Output, op *Op, op_param *Param, __int64 JumpTarget)
+{
+    if(Op->IsRelativeJump)
+    {
+        EmitString(Output, ",relative,,,,");
+        EmitInt(Output, Param->ImmediateValue);
+        EmitChar(Output, ',');
+        EmitInt(Output, (int)JumpTarget);
+    }
+    else switch(Param->Type)
+    {
+        case Param_Immediate:
+        {
+            EmitString(Output, ",immediate,,,,,");
+            EmitInt(Output, Param->ImmediateValue);
+        } break;
+
+        case Param_Register:
+        case Param_SegmentRegister:
+        {
+            EmitString(Output, ",register,");
+            EmitString(Output, (Param->Type == Param_Register) ?
+                       RegisterLookup[Param->RegisterOrMemoryIndex] :
+                       SegmentRegisterLookup[Param->RegisterOrMemoryIndex]);
+            EmitString(Output, ",,,,");
+        } break;
+
+        case Param_Memory:
+        case Param_MemoryDirectAddress:
+        {
+            EmitString(Output, ",memory,,");
+            if(Param->Type == Param_Memory)
+            {
+                char **Terms = EffectiveAddressTerms[Param->RegisterOrMemoryIndex];
+                EmitString(Output, Terms[0]);
+                EmitChar(Output, ',');
+                EmitString(Output, Terms[1]);
+            }
+            else
+            {
+                EmitChar(Output, ',');
+            }
+            EmitChar(Output, ',');
+            EmitInt(Output, Param->Offset);
+            EmitChar(Output, ',');
+        } break;
+
+        case Param_DirectIntersegment:
+        {
+            EmitString(Output, ",memory,,,,");
+            EmitInt(Output, Param->IP);
+            EmitChar(Output, ',');
+            EmitInt(Output, Param->CS);
+        } break;
+
+        default:
+        {
+            EmitString(Output, ",unknown,,,,,");
+        } break;
+    }
+}
+
+/* NOTE(chuck): One instruction of structured output. Start is where its first prefix began (or the op itself if it had none), and Flags/SegmentOverride carry what those prefixes said. */
+static void EmitStructuredOp(output_buffer *Output, output_format Format, op *Op, u8 *OpStream, u8 *Start, int Flags, int SegmentOverride)
+{
+    ReserveOutput(Output, MAX_LINE_LENGTH);
+
+    if(Op->Word)
+    {
+        Flags |= INSTRUCTION_FLAG_WIDE;
+    }
+    if(Op->IsFar)
+    {
+        Flags |= INSTRUCTION_FLAG_FAR;
+    }
+
+    int Address = (int)(Start - OpStream);
+    int Size = (int)((Op->IP + Op->ByteLength) - Start);
+    __int64 JumpTarget = (Op->IP - OpStream) + Op->ByteLength + Op->Param[0].ImmediateValue;
+    int Known = !Op->Error && (Op->NameIndex < ArrayLength(OpNameLookup));
+    int ParamCount = Known ? Op->ParamCount : 0;
+
+    if(Format == Format_JSONL)
+    {
+        EmitString(Output, "{\"address\":");
+        EmitInt(Output, Address);
+        EmitString(Output, ",\"size\":");
+        EmitInt(Output, Size);
+        EmitString(Output, ",\"bytes\":\"");
+        EmitHexBytes(Output, Start, Size);
+        EmitString(Output, "\",\"mnemonic\":\"");
+        if(Known)
+        {
+            EmitMnemonic(Output, Op);
+        }
+        else
+        {
+            EmitString(Output, "???");
+        }
+        EmitString(Output, "\",\"flags\":[");
+        int NeedsSeparator = 0;
+        for(int FlagIndex = 0;
+            FlagIndex < ArrayLength(InstructionFlagNames);
+            ++FlagIndex)
+        {
+            if(Flags & (1 << FlagIndex))
+            {
+                if(NeedsSeparator)
+                {
+                    EmitChar(Output, ',');
+                }
+                EmitChar(Output, '"');
+                EmitString(Output, InstructionFlagNames[FlagIndex]);
+                EmitChar(Output, '"');
+                NeedsSeparator = 1;
+            }
+        }
+        EmitChar(Output, ']');
+
+        if(Flags & INSTRUCTION_FLAG_SEGMENT)
+        {
+            EmitString(Output, ",\"segment\":\"");
+            EmitString(Output, SegmentRegisterLookup[SegmentOverride]);
+            EmitChar(Output, '"');
+        }
+
+        EmitString(Output, ",\"operands\":[");
+        for(int ParamIndex = 0;
+            ParamIndex < ParamCount;
+            ++ParamIndex)
+        {
+            if(ParamIndex)
+            {
+                EmitChar(Output, ',');
+            }
+            EmitOperandJSON(Output, Op, &Op->Param[ParamIndex], JumpTarget);
+        }
+        EmitString(Output, "]}\n");
+    }
+    else
+    {
+        EmitInt(Output, Address);
+        EmitChar(Output, ',');
+        EmitInt(Output, Size);
+        EmitChar(Output, ',');
+        EmitHexBytes(Output, Start, Size);
+        EmitChar(Output, ',');
+        if(Known)
+        {
+            EmitMnemonic(Output, Op);
+        }
+        else
+        {
+            EmitString(Output, "???");
+        }
+        for(int FlagIndex = 0;
+            FlagIndex < ArrayLength(InstructionFlagNames);
+            ++FlagIndex)
+        {
+            EmitString(Output, (Flags & (1 << FlagIndex)) ? ",1" : ",0");
+        }
+        EmitChar(Output, ',');
+        if(Flags & INSTRUCTION_FLAG_SEGMENT)
+        {
+            EmitString(Output, SegmentRegisterLookup[SegmentOverride]);
+        }
+
+        for(int ParamIndex = 0;
+            ParamIndex < 2;
+            ++ParamIndex)
+        {
+            if(ParamIndex < ParamCount)
+            {
+                EmitOperandCSV(Output, Op, &Op->Param[ParamIndex], JumpTarget);
+            }
+            else
+            {
+                EmitString(Output, ",none,,,,,");
+            }
+        }
+        EmitChar(Output, '\n');
+    }
+}
+
+static char *GetTraceRegisterName(u8 Register)
+{
+    // NOTE(chuck): Destinations that aren't simulated have always printed this way, because their name was a null pointer handed to printf.
+    char *Result = "(null)";
+    if(Register < TRACE_SEGMENT_REGISTER)
+    {
+        Result = RegisterLookup[8 + Register];
+    }
+    else if(Register < (TRACE_SEGMENT_REGISTER + 4))
+    {
+        Result = SegmentRegisterLookup[Register - TRACE_SEGMENT_REGISTER];
+    }
+    return(Result);
+}
+
+static void EmitFlags(output_buffer *Output, u16 Flags)
+{
+    int Length = PrintFlags(Temp, Flags);
+    EmitBytes(Output, Temp, Length);
+}
+
+static void EmitTraceRecord(output_buffer *Output, trace_record *Record)
+{
+    EmitBytes(Output, "  [exec] ", 9);
+
+    if(Record->Flags & Trace_RegisterWrite)
+    {
+        EmitString(Output, GetTraceRegisterName(Record->Register));
+        EmitBytes(Output, ":0x", 3);
+        EmitHex(Output, Record->RegisterBefore, 4);
+        EmitBytes(Output, "->0x", 4);
+        EmitHex(Output, Record->RegisterAfter, 4);
+
+        // TODO(chuck): This is fudgeville! Only the arithmetic ops leave a space for the flags.
+        if(Record->NameIndex != OP_NAME_MOV)
+        {
+            EmitChar(Output, ' ');
+        }
+    }
+
+    if(Record->Flags & Trace_MemoryWrite)
+    {
+        EmitChar(Output, '[');
+        EmitInt(Output, (int)Record->MemoryAddress);
+        EmitBytes(Output, "]:0x", 4);
+        EmitHex(Output, Record->MemoryBefore, 4);
+        EmitBytes(Output, "->0x", 4);
+        EmitHex(Output, Record->MemoryAfter, 4);
+        EmitChar(Output, ' ');
+    }
+
+    if(Record->FlagsBefore != Record->FlagsAfter)
+    {
+        EmitBytes(Output, "flags: ", 7);
+        EmitFlags(Output, Record->FlagsBefore);
+        EmitBytes(Output, "->", 2);
+        EmitFlags(Output, Record->FlagsAfter);
+    }
+}
+
+// NOTE(chuck): Brings a CPU state up to date from a recorded op instead of running it.
+static void ApplyTraceRecord(cpu_state *State, trace_record *Record)
+{
+    if(Record->Flags & Trace_RegisterWrite)
+    {
+        if(Record->Register < TRACE_SEGMENT_REGISTER)
+        {
+            State->Registers[Record->Register] = Record->RegisterAfter;
+        }
+        else if(Record->Register < (TRACE_SEGMENT_REGISTER + 4))
+        {
+            State->SegmentRegisters[Record->Register - TRACE_SEGMENT_REGISTER] = Record->RegisterAfter;
+        }
+    }
+    State->Flags = Record->FlagsAfter;
+}
+
+static trace_ring_segment *PushTraceRingSegment(u32 Capacity)
+{
+    trace_ring_segment *Result = PushStruct(&TraceRingArena, trace_ring_segment);
+    memset(Result, 0, sizeof(*Result));
+    Result->Records = PushArray(&TraceRingArena, trace_record, Capacity);
+    Result->Capacity = Capacity;
+    return(Result);
+}
+
+static void InitTraceRing(trace_ring *Ring, u32 Capacity, trace_full_policy Policy)
+{
+    u32 PowerOfTwo = 1;
+    while(PowerOfTwo < Capacity)
+    {
+        PowerOfTwo <<= 1;
+    }
+
+    memset(Ring, 0, sizeof(*Ring));
+    Ring->Policy = Policy;
+    Ring->ProducerSegment = Ring->ConsumerSegment = PushTraceRingSegment(PowerOfTwo);
+}
+
+// NOTE(chuck): Producer side only.
+static void PushTraceRecord(trace_ring *Ring, trace_record *Record)
+{
+    trace_ring_segment *Segment = Ring->ProducerSegment;
+    u32 WriteIndex = Segment->WriteIndex;
+
+    int Dropped = 0;
+    int SpinCount = 0;
+    while((WriteIndex - Segment->ReadIndex) == Segment->Capacity)
+    {
+        if(Ring->Policy == TraceFull_Drop)
+        {
+            ++Ring->DroppedCount;
+            Dropped = 1;
+            break;
+        }
+        else if(Ring->Policy == TraceFull_Grow)
+        {
+            // NOTE(chuck): Nothing more goes into the old segment once Next is set, so the consumer can finish it off and move along.
+            trace_ring_segment *NewSegment = PushTraceRingSegment(2*Segment->Capacity);
+            _WriteBarrier();
+            Segment->Next = NewSegment;
+            Ring->ProducerSegment = Segment = NewSegment;
+            WriteIndex = 0;
+        }
+        else if(++SpinCount < 64)
+        {
+            YieldProcessor();
+        }
+        else
+        {
+            // NOTE(chuck): The consumer may be sharing this core, in which case spinning only keeps it from draining anything.
+            Sleep(0);
+        }
+    }
+
+    if(!Dropped)
+    {
+        Segment->Records[WriteIndex & (Segment->Capacity - 1)] = *Record;
+        _WriteBarrier(); // NOTE(chuck): The record has to land before the index that hands it over.
+        Segment->WriteIndex = WriteIndex + 1;
+    }
+}
+
+// NOTE(chuck): Producer side only. Nothing may be pushed after this.
+static void FinishTraceRing(trace_ring *Ring)
+{
+    _WriteBarrier();
+    Ring->Done = 1;
+}
+
+// NOTE(chuck): Consumer side only. Waits for the next record, and returns 0 once the producer is done and everything has been read.
+static int PopTraceRecord(trace_ring *Ring, trace_record *Record)
+{
+    int Result = 0;
+    int SpinCount = 0;
+    for(;;)
+    {
+        trace_ring_segment *Segment = Ring->ConsumerSegment;
+        u32 ReadIndex = Segment->ReadIndex;
+        int Done = Ring->Done;
+        trace_ring_segment *Next = Segment->Next;
+        _ReadBarrier(); // NOTE(chuck): Done and Next are only set after the last record they cover has been published, so read them first.
+
+        if(ReadIndex != Segment->WriteIndex)
+        {
+            _ReadBarrier();
+            *Record = Segment->Records[ReadIndex & (Segment->Capacity - 1)];
+            _ReadWriteBarrier(); // NOTE(chuck): The record has to be copied out before the slot is handed back.
+            Segment->ReadIndex = ReadIndex + 1;
+            Result = 1;
+            break;
+        }
+        else if(Next)
+        {
+            Ring->ConsumerSegment = Next;
+        }
+        else if(Done)
+        {
+            break;
+        }
+        else if(++SpinCount < 64)
+        {
+            YieldProcessor();
+        }
+        else
+        {
+            Sleep(0);
+        }
+    }
+
+    return(Result);
+}
+
+static void ReportDroppedTraceRecords(trace_ring *Ring)
+{
+    if(Ring->DroppedCount)
+    {
+        fprintf(stderr, "WARNING: %llu trace records were dropped because the ring was full.\n", Ring->DroppedCount);
+    }
+}
+
+typedef struct
+{
+    program *Program;
+    trace_ring *Ring;
+} simulation_work;
+
+// NOTE(chuck): Runs exactly the ops that -exec does, and feeds the records to whoever is writing them out.
+static DWORD WINAPI SimulationThread(LPVOID Parameter)
+{
+    simulation_work *Work = (simulation_work *)Parameter;
+    trace_record Record;
+    while(StepProgram(Work->Program, &Record))
+    {
+        PushTraceRecord(Work->Ring, &Record);
+    }
+    FinishTraceRing(Work->Ring);
+
+    return(0);
+}
+
+static op *GetJumpTarget(op *Jump, u8 *OpStream, op **OpAtOffset, size_t ByteLength)
+{
+    op *Result = 0;
+
+    __int64 InstructionOffset = (Jump->IP - OpStream);
+    __int64 JumpBase = (InstructionOffset + Jump->ByteLength);
+    __int64 JumpTo = JumpBase + Jump->Param[0].ImmediateValue;
+    if((JumpTo >= 0) && (JumpTo < (__int64)ByteLength))
+    {
+        Result = OpAtOffset[JumpTo];
+    }
+
+    return(Result);
+}
+
+// NOTE(chuck): The mnemonic and operands of an op, as the listing and -exec show them.
+static void EmitOpText(output_buffer *Output, op *Op, u8 *OpStream, op **OpAtOffset, size_t ByteLength, int *HitError)
+{
+    if(Op->NameIndex >= ArrayLength(OpNameLookup))
+    {
+        EmitString(Output, "<corrupted?> ");
+    }
+    else
+    {
+        EmitMnemonic(Output, Op);
+
+        if(Op->NameIndex != SEGMENT_OVERRIDE)
+        {
+            EmitChar(Output, ' ');
+        }
+    }
+
+    if(Op->ParamCount > 0)
+    {
+        if(Op->IsRelativeJump)
+        {
+            op *Target = GetJumpTarget(Op, OpStream, OpAtOffset, ByteLength);
+            if(Target)
+            {
+                EmitBytes(Output, "label", 5);
+                EmitInt(Output, Target->JumpTargetIndex);
+            }
+            else if(Op->Word)
+            {
+                // NOTE(chuck): A near jmp/call can reach anywhere in the segment, not just the
+                // program, so when there's nothing to label it goes out as the plain offset.
+                EmitInt(Output, (int)((Op->IP - OpStream) + Op->ByteLength + Op->Param[DESTINATION].ImmediateValue));
+            }
+            else
+            {
+                *HitError = 1;
+            }
+        }
+        else
+        {
+            if(Op->IsFar)
+            {
+                EmitBytes(Output, "far ", 4);
+            }
+
+            // NOTE(chuck): Don't bother with tracking which side. Just blast it on the left.
+            if(Op->EmitSize)
+            {
+                EmitString(Output, Op->Word ? "word " : "byte ");
+            }
+            EmitParam(Output, Op, &Op->Param[0]);
+        }
+    }
+
+    if(Op->ParamCount > 1)
+    {
+        EmitBytes(Output, ", ", 2);
+        EmitParam(Output, Op, &Op->Param[1]);
+    }
+}
+
+// NOTE(chuck): Everything the listing has for one op except the newline, which is left off so that -exec can put what the op did in front of it. A prefix only starts its line and the op after it finishes it. Returns whether the op left a line to finish.
+static int EmitListingOp(output_buffer *Output, op *Op, op *PreviousOp, u8 *OpStream, op **OpAtOffset, size_t ByteLength, int *HitError)
+{
+    int Result = 0;
+    int FollowsPrefix = (PreviousOp && IsPrefix(PreviousOp));
+
+    if(Op->IsJumpTarget)
+    {
+        EmitBytes(Output, "\nlabel", 6);
+        EmitInt(Output, Op->JumpTargetIndex);
+        EmitBytes(Output, ":\n", 2);
+    }
+
+    if(Op->Error)
+    {
+        *HitError = 1; // NOTE(chuck): Trip this so that all subsequent output is commented. I just want to see it continue attempting to decode the rest of the stream, even if most of it is garbage, in case it is useful for debugging.
+
+        size_t LineStart = Output->Used;
+        EmitBytes(Output, "; ???", 5);
+        EmitPadding(Output, LineStart, 40);
+        EmitBytes(Output, "  0x", 4);
+        EmitHex(Output, (Op->IP - OpStream), 8);
+        EmitBytes(Output, ": ", 2);
+        EmitHex(Output, Op->IP[0], 2);
+        EmitChar(Output, '\n');
+    }
+    else
+    {
+        // NOTE(chuck): Keep the whole line in the buffer until it is finished so that the first character can still be swapped for a comment.
+        ReserveOutput(Output, MAX_LINE_LENGTH);
+        size_t LineStart = Output->Used;
+
+        // TODO(chuck): This is fudgeville!
+        if(!FollowsPrefix || (Op->NameIndex >= ArrayLength(OpNameLookup)))
+        {
+            EmitBytes(Output, "  ", 2);
+        }
+        EmitOpText(Output, Op, OpStream, OpAtOffset, ByteLength, HitError);
+
+        Assert((Output->Used - LineStart) < MAX_LINE_LENGTH);
+        if(*HitError)
+        {
+            if(Output->Used == LineStart)
+            {
+                EmitChar(Output, ';');
+            }
+            else
+            {
+                Output->Base[LineStart] = ';';
+            }
+        }
+
+        if(!IsPrefix(Op))
+        {
+            // TODO(chuck): This is fudgeville!
+            EmitPadding(Output, LineStart, FollowsPrefix ? 34 : 40);
+
+            unsigned char *IP = Op->IP;
+            int OpByteLength = Op->ByteLength;
+
+            // TODO(chuck): This is fudgeville!
+            if(FollowsPrefix)
+            {
+                IP = PreviousOp->IP;
+                ++OpByteLength;
+            }
+
+            size_t BytesStart = Output->Used;
+            EmitBytes(Output, "; 0x", 4);
+            EmitHex(Output, (IP - OpStream), 8);
+            EmitChar(Output, ':');
+            for(int OpByteIndex = 0;
+                OpByteIndex < OpByteLength;
+                ++OpByteIndex)
+            {
+                EmitChar(Output, ' ');
+                EmitHex(Output, IP[OpByteIndex], 2);
+            }
+            EmitPadding(Output, BytesStart, 30);
+
+            Result = 1;
+        }
+    }
+
+    return(Result);
+}
+
+// NOTE(chuck): -exec shows each step as the op's line from the listing, prefix and all, followed by what the step did. An op that the listing doesn't have (because a jump landed in the middle of one) gets decoded on the spot just for showing, since only the thread doing the executing gets to add to the program. Returns 0 for the step that stopped on bytes that aren't an op.
+static int EmitExecutedStep(output_buffer *Output, program *Program, op *OpList, trace_record *Record, int *HitError)
+{
+    op Decoded;
+    op *Op = Program->OpAtOffset[Record->IP];
+    op *PreviousOp = 0;
+    if(Op)
+    {
+        PreviousOp = (Op > OpList) ? (Op - 1) : 0;
+        if(PreviousOp && !PreviousOp->Error && IsPrefix(PreviousOp))
+        {
+            EmitListingOp(Output, PreviousOp, (PreviousOp > OpList) ? (PreviousOp - 1) : 0, Program->OpStream, Program->OpAtOffset, Program->ProgramLength, HitError);
+        }
+    }
+    else
+    {
+        parsing_context Context = {Program->OpStream, Program->OpStream + Record->IP};
+        Decoded = DecodeOp(&Context);
+        Op = &Decoded;
+    }
+
+    if(EmitListingOp(Output, Op, PreviousOp, Program->OpStream, Program->OpAtOffset, Program->ProgramLength, HitError))
+    {
+        EmitTraceRecord(Output, Record);
+        EmitChar(Output, '\n');
+    }
+
+    int Result = !Op->Error;
+    return(Result);
+}
+
+static u8 *PutVarint(u8 *At, u64 Value)
+{
+    while(Value >= 0x80)
+    {
+        *At++ = (u8)(Value | 0x80);
+        Value >>= 7;
+    }
+    *At++ = (u8)Value;
+    return(At);
+}
+
+static u64 GetVarint(u8 **At)
+{
+    u64 Result = 0;
+    int Shift = 0;
+    u8 Byte;
+    do
+    {
+        Byte = *(*At)++;
+        Result |= (u64)(Byte & 0x7f) << Shift;
+        Shift += 7;
+    } while(Byte & 0x80);
+    return(Result);
+}
+
+// NOTE(chuck): Small negative deltas have to stay small too, so fold the sign into the low bit.
+static u64 ZigZag(__int64 Value)
+{
+    u64 Result = ((u64)Value << 1) ^ (u64)(Value >> 63);
+    return(Result);
+}
+
+static __int64 UnZigZag(u64 Value)
+{
+    __int64 Result = (__int64)(Value >> 1) ^ -(__int64)(Value & 1);
+    return(Result);
+}
+
+// NOTE(chuck): Where execution goes next if the op at Offset doesn't jump. Prefixes never get a record of their own, so step over them.
+static u32 GetFallThroughOffset(op **OpAtOffset, u32 ProgramLength, u32 Offset)
+{
+    u32 Result = Offset;
+    if((Offset < ProgramLength) && OpAtOffset[Offset])
+    {
+        Result += OpAtOffset[Offset]->ByteLength;
+        while((Result < ProgramLength) && OpAtOffset[Result] && !OpAtOffset[Result]->Error && IsPrefix(OpAtOffset[Result]))
+        {
+            Result += OpAtOffset[Result]->ByteLength;
+        }
+    }
+    return(Result);
+}
+
+static int GetTraceNameIndex(op **OpAtOffset, u32 ProgramLength, u32 Offset)
+{
+    int Result = -1;
+    if((Offset < ProgramLength) && OpAtOffset[Offset])
+    {
+        Result = OpAtOffset[Offset]->NameIndex;
+    }
+    return(Result);
+}
+
+// NOTE(chuck): What RegisterBefore has to be if nothing unusual happened, so that it never needs to be stored.
+static u16 PredictRegisterBefore(cpu_state *State, u8 Register, u8 Flags)
+{
+    u16 Result = 0;
+    if(Register < TRACE_SEGMENT_REGISTER)
+    {
+        Result = State->Registers[Register];
+    }
+    else if(Register < (TRACE_SEGMENT_REGISTER + 4))
+    {
+        Result = State->SegmentRegisters[Register - TRACE_SEGMENT_REGISTER];
+    }
+    else if(Flags & Trace_RegisterWrite)
+    {
+        Result = 0xcccc;
+    }
+    return(Result);
+}
+
+// NOTE(chuck): Forgets everything the last block taught it, without having to clear the whole history.
+static void ResetTraceStorePredictor(trace_store_predictor *Predictor)
+{
+    ++Predictor->Generation;
+    Predictor->HasLastIP = 0;
+}
+
+static trace_store_history *GetTraceStoreHistory(trace_store_predictor *Predictor, u32 ProgramLength, u32 IP)
+{
+    trace_store_history *Result = 0;
+    if((IP < ProgramLength) && (Predictor->History[IP].Generation == Predictor->Generation))
+    {
+        Result = &Predictor->History[IP];
+    }
+    return(Result);
+}
+
+// NOTE(chuck): Where the op after the last one will be. If the last op went somewhere before, it probably goes there again, otherwise it's the fall-through.
+static u32 PredictTraceStoreIP(trace_store_predictor *Predictor, u32 ProgramLength, u32 FallThroughIP)
+{
+    u32 Result = FallThroughIP;
+    trace_store_history *History = Predictor->HasLastIP ? GetTraceStoreHistory(Predictor, ProgramLength, Predictor->LastIP) : 0;
+    if(History && History->HasNextIP)
+    {
+        Result = History->NextIP;
+    }
+    return(Result);
+}
+
+// NOTE(chuck): The record the op at IP makes if it goes the way it went last time, except that FlagsAfter is left for the caller if the op sets flags. Returns 0 if it hasn't gone at all yet in this block.
+static trace_store_history *PredictTraceStoreRecord(trace_store_predictor *Predictor, cpu_state *State, op **OpAtOffset, u32 ProgramLength, u32 IP, trace_record *Record)
+{
+    trace_store_history *Result = GetTraceStoreHistory(Predictor, ProgramLength, IP);
+    memset(Record, 0, sizeof(*Record));
+    if(Result)
+    {
+        trace_store_history *History = Result;
+        Record->IP = IP;
+        Record->NameIndex = (u16)GetTraceNameIndex(OpAtOffset, ProgramLength, IP);
+        Record->Register = History->Register;
+        Record->Flags = History->Flags;
+        Record->RegisterBefore = PredictRegisterBefore(State, Record->Register, Record->Flags);
+        Record->RegisterAfter = (u16)(Record->RegisterBefore + History->RegisterDelta);
+        Record->FlagsBefore = State->Flags;
+        Record->FlagsAfter = State->Flags;
+        if(Record->Flags & Trace_MemoryWrite)
+        {
+            Record->MemoryAddress = History->MemoryAddress + History->MemoryAddressStride;
+            Record->MemoryBefore = History->MemoryBefore;
+            Record->MemoryAfter = (u16)(History->MemoryAfter + History->MemoryAfterStride);
+        }
+    }
+    return(Result);
+}
+
+// NOTE(chuck): The writer and the reader both call this after every record, so their predictions never drift apart.
+static void UpdateTraceStorePredictor(trace_store_predictor *Predictor, u32 ProgramLength, trace_record *Record)
+{
+    trace_store_history *Last = Predictor->HasLastIP ? GetTraceStoreHistory(Predictor, ProgramLength, Predictor->LastIP) : 0;
+    if(Last)
+    {
+        Last->HasNextIP = 1;
+        Last->NextIP = Record->IP;
+    }
+
+    if(Record->IP < ProgramLength)
+    {
+        trace_store_history *History = &Predictor->History[Record->IP];
+        int Seen = (History->Generation == Predictor->Generation);
+        if(Seen && (Record->Flags & Trace_MemoryWrite) && (History->Flags & Trace_MemoryWrite))
+        {
+            History->MemoryAddressStride = Record->MemoryAddress - History->MemoryAddress;
+            History->MemoryAfterStride = (u16)(Record->MemoryAfter - History->MemoryAfter);
+        }
+        else
+        {
+            History->MemoryAddressStride = 0;
+            History->MemoryAfterStride = 0;
+        }
+        if(!Seen)
+        {
+            History->Generation = Predictor->Generation;
+            History->HasNextIP = 0;
+            History->SetsFlags = 0;
+        }
+
+        History->Register = Record->Register;
+        History->Flags = Record->Flags;
+        History->RegisterDelta = (u16)(Record->RegisterAfter - Record->RegisterBefore);
+        if(Record->FlagsAfter != Record->FlagsBefore)
+        {
+            History->SetsFlags = 1;
+        }
+        History->MemoryAddress = Record->MemoryAddress;
+        History->MemoryBefore = Record->MemoryBefore;
+        History->MemoryAfter = Record->MemoryAfter;
+    }
+
+    Predictor->HasLastIP = 1;
+    Predictor->LastIP = Record->IP;
+}
+
+// NOTE(chuck): One step on its own line, for the modes that show steps out of program order.
+static void EmitTraceStep(output_buffer *Output, u64 Step, trace_record *Record, op **OpAtOffset, u32 ProgramLength)
+{
+    ReserveOutput(Output, MAX_LINE_LENGTH);
+    size_t LineStart = Output->Used;
+    EmitFormat(Output, "%10llu  0x%08X  ", Step, Record->IP);
+    if((Record->IP < ProgramLength) && OpAtOffset[Record->IP])
+    {
+        EmitMnemonic(Output, OpAtOffset[Record->IP]);
+    }
+    EmitPadding(Output, LineStart, 34);
+    EmitTraceRecord(Output, Record);
+    EmitChar(Output, '\n');
+}
+
+static void EmitTraceStoreBytes(trace_store_writer *Store, void *Data, size_t Size)
+{
+    EmitBytes(&Store->Output, (char *)Data, Size);
+    Store->Offset += Size;
+}
+
+static int BeginTraceStore(trace_store_writer *Store, char *TraceFilename, char *Filename, u8 *OpStream, u32 ProgramLength, op **OpAtOffset)
+{
+    memset(Store, 0, sizeof(*Store));
+    Store->Output.Capacity = Megabytes(1);
+    Store->Output.Base = PushArray(&OutputArena, char, Store->Output.Capacity);
+    Store->Output.File = fopen(TraceFilename, "wb");
+    if(!Store->Output.File)
+    {
+        return(0);
+    }
+
+    Store->Block = PushArray(&TraceStoreArena, u8, TRACE_STORE_STEPS_PER_BLOCK*TRACE_STORE_MAX_RECORD_SIZE);
+    Store->FirstStepAtIP = PushArray(&TraceStoreArena, u64, ProgramLength);
+    Store->Predictor.History = PushArray(&TraceStoreArena, trace_store_history, ProgramLength);
+    Store->RepeatFlags = PushArray(&TraceStoreArena, u8, TRACE_STORE_STEPS_PER_BLOCK*3);
+    Store->OpAtOffset = OpAtOffset;
+    Store->ProgramLength = ProgramLength;
+
+    // NOTE(chuck): The counts and offsets aren't known until the end, so this gets written again by EndTraceStore().
+    trace_store_header Header = {0};
+    Header.FileNameLength = (u32)strlen(Filename);
+    EmitTraceStoreBytes(Store, &Header, sizeof(Header));
+    EmitTraceStoreBytes(Store, Filename, Header.FileNameLength);
+    EmitTraceStoreBytes(Store, OpStream, ProgramLength);
+
+    return(1);
+}
+
+static void FlushTraceStoreRepeat(trace_store_writer *Store)
+{
+    if(Store->RepeatCount)
+    {
+        u8 *At = Store->Block + Store->BlockSize;
+        *At++ = TraceStore_RegisterMask | TraceStore_Extended;
+        *At++ = TraceStore_Repeat;
+        At = PutVarint(At, Store->RepeatCount);
+        memcpy(At, Store->RepeatFlags, Store->RepeatFlagsSize);
+        At += Store->RepeatFlagsSize;
+        Store->BlockSize = (u32)(At - Store->Block);
+        Store->RepeatCount = 0;
+        Store->RepeatFlagsSize = 0;
+    }
+}
+
+static void FlushTraceStoreBlock(trace_store_writer *Store)
+{
+    if(Store->BlockStepCount)
+    {
+        FlushTraceStoreRepeat(Store);
+        *PushStruct(&TraceStoreIndexArena, u64) = Store->Offset;
+
+        Store->BlockHeader.Size = Store->BlockSize;
+        Store->BlockHeader.StepCount = Store->BlockStepCount;
+        EmitTraceStoreBytes(Store, &Store->BlockHeader, sizeof(Store->BlockHeader));
+        EmitTraceStoreBytes(Store, Store->Block, Store->BlockSize);
+
+        if(Store->MaxBlockSize < Store->BlockSize)
+        {
+            Store->MaxBlockSize = Store->BlockSize;
+        }
+        ++Store->BlockCount;
+        Store->BlockSize = 0;
+        Store->BlockStepCount = 0;
+    }
+}
+
+static void AddTraceWrite(trace_store_writer *Store, u32 Key, u32 Address, u32 IP, u16 Before, u16 After)
+{
+    trace_write *Write = PushStruct(&TraceWriteArena, trace_write);
+    Write->Step = Store->StepCount;
+    Write->Key = Key;
+    Write->Address = Address;
+    Write->IP = IP;
+    Write->Before = Before;
+    Write->After = After;
+    ++Store->WriteCount;
+}
+
+static int CompareTraceWrites(const void *A, const void *B)
+{
+    trace_write *WriteA = (trace_write *)A;
+    trace_write *WriteB = (trace_write *)B;
+    int Result = 0;
+    if(WriteA->Key != WriteB->Key)
+    {
+        Result = (WriteA->Key < WriteB->Key) ? -1 : 1;
+    }
+    else if(WriteA->Step != WriteB->Step)
+    {
+        Result = (WriteA->Step < WriteB->Step) ? -1 : 1;
+    }
+    return(Result);
+}
+
+static void ResetTraceWritePredictor(trace_write_predictor *Predictor, u64 FirstStep)
+{
+    ++Predictor->Generation;
+    Predictor->HasLast = 0;
+    memset(&Predictor->Last, 0, sizeof(Predictor->Last));
+    Predictor->Last.Step = FirstStep;
+}
+
+static trace_write_history *GetTraceWriteHistory(trace_write_predictor *Predictor, u32 ProgramLength, u32 IP)
+{
+    trace_write_history *Result = 0;
+    if((IP < ProgramLength) && (Predictor->History[IP].Generation == Predictor->Generation))
+    {
+        Result = &Predictor->History[IP];
+    }
+    return(Result);
+}
+
+// NOTE(chuck): Whichever op wrote after the last one's op last time, or the same op again.
+static u32 PredictTraceWriteIP(trace_write_predictor *Predictor, u32 ProgramLength)
+{
+    u32 Result = Predictor->Last.IP;
+    trace_write_history *History = Predictor->HasLast ? GetTraceWriteHistory(Predictor, ProgramLength, Predictor->Last.IP) : 0;
+    if(History && History->HasNextIP)
+    {
+        Result = History->NextIP;
+    }
+    return(Result);
+}
+
+// NOTE(chuck): What the op at IP's next write under Key should look like. A register write's Before is always the After of the write to it before.
+static void PredictTraceWrite(trace_write_predictor *Predictor, u32 ProgramLength, u32 Key, u32 IP, trace_write *Write)
+{
+    trace_write_history *History = GetTraceWriteHistory(Predictor, ProgramLength, IP);
+    memset(Write, 0, sizeof(*Write));
+    Write->Key = Key;
+    Write->IP = IP;
+    Write->Step = Predictor->Last.Step;
+    Write->Address = Predictor->Last.Address;
+    if(History)
+    {
+        Write->Step = History->Step + History->StepStride;
+        Write->Address = History->Address + History->AddressStride;
+        Write->Before = History->Before;
+        Write->After = (u16)(History->After + History->AfterStride);
+    }
+    if(Key < TRACE_WRITE_FIRST_PAGE_KEY)
+    {
+        Write->Address = Key;
+        Write->Before = Predictor->HasLast ? Predictor->Last.After : 0;
+    }
+}
+
+static void UpdateTraceWritePredictor(trace_write_predictor *Predictor, u32 ProgramLength, trace_write *Write)
+{
+    trace_write_history *Last = Predictor->HasLast ? GetTraceWriteHistory(Predictor, ProgramLength, Predictor->Last.IP) : 0;
+    if(Last)
+    {
+        Last->HasNextIP = 1;
+        Last->NextIP = Write->IP;
+    }
+
+    if(Write->IP < ProgramLength)
+    {
+        trace_write_history *History = &Predictor->History[Write->IP];
+        if(History->Generation == Predictor->Generation)
+        {
+            History->StepStride = Write->Step - History->Step;
+            History->AddressStride = Write->Address - History->Address;
+            History->AfterStride = (u16)(Write->After - History->After);
+        }
+        else
+        {
+            History->Generation = Predictor->Generation;
+            History->HasNextIP = 0;
+            History->StepStride = 0;
+            History->AddressStride = 0;
+            History->AfterStride = 0;
+        }
+        History->Step = Write->Step;
+        History->Address = Write->Address;
+        History->Before = Write->Before;
+        History->After = Write->After;
+    }
+
+    Predictor->HasLast = 1;
+    Predictor->Last = *Write;
+}
+
+// NOTE(chuck): Groups the writes by key and writes out each key's chunks, its chunk table and finally the key directory.
+static void EmitTraceWriteIndex(trace_store_writer *Store, trace_store_header *Header)
+{
+    trace_write *Writes = (trace_write *)TraceWriteArena.Base;
+    if(Store->WriteCount)
+    {
+        qsort(Writes, (size_t)Store->WriteCount, sizeof(trace_write), CompareTraceWrites);
+    }
+
+    u8 *Chunk = PushArray(&TraceStoreArena, u8, TRACE_WRITE_CHUNK_SIZE*TRACE_WRITE_MAX_ENTRY_SIZE);
+    trace_write_predictor Predictor = {0};
+    Predictor.History = PushArray(&TraceStoreArena, trace_write_history, Store->ProgramLength);
+    trace_write_key *Keys = 0;
+    u64 WriteIndex = 0;
+    while(WriteIndex < Store->WriteCount)
+    {
+        u32 Key = Writes[WriteIndex].Key;
+        u64 KeyEnd = WriteIndex;
+        while((KeyEnd < Store->WriteCount) && (Writes[KeyEnd].Key == Key))
+        {
+            ++KeyEnd;
+        }
+
+        trace_write_key *KeyEntry = PushStruct(&TraceStoreIndexArena, trace_write_key);
+        if(!Keys)
+        {
+            Keys = KeyEntry;
+        }
+        KeyEntry->Key = Key;
+        KeyEntry->WriteCount = (u32)(KeyEnd - WriteIndex);
+
+        trace_write_chunk *Chunks = 0;
+        for(u64 ChunkStart = WriteIndex;
+            ChunkStart < KeyEnd;
+            ChunkStart += TRACE_WRITE_CHUNK_SIZE)
+        {
+            u64 ChunkEnd = ChunkStart + TRACE_WRITE_CHUNK_SIZE;
+            if(ChunkEnd > KeyEnd)
+            {
+                ChunkEnd = KeyEnd;
+            }
+
+            trace_write_chunk *ChunkEntry = PushStruct(&TraceStoreArena, trace_write_chunk);
+            if(!Chunks)
+            {
+                Chunks = ChunkEntry;
+            }
+            ChunkEntry->FirstStep = Writes[ChunkStart].Step;
+            ChunkEntry->Offset = Store->Offset;
+            ChunkEntry->WriteCount = (u32)(ChunkEnd - ChunkStart);
+
+            u8 *At = Chunk;
+            u32 RunCount = 0;
+            ResetTraceWritePredictor(&Predictor, ChunkEntry->FirstStep);
+            for(u64 ChunkWriteIndex = ChunkStart;
+                ChunkWriteIndex < ChunkEnd;
+                ++ChunkWriteIndex)
+            {
+                trace_write *Write = &Writes[ChunkWriteIndex];
+                u64 LastStep = Predictor.Last.Step;
+                u32 PredictedIP = PredictTraceWriteIP(&Predictor, Store->ProgramLength);
+                trace_write Predicted;
+                PredictTraceWrite(&Predictor, Store->ProgramLength, Key, Write->IP, &Predicted);
+
+                u8 Tag = 0;
+                if(Write->IP != PredictedIP)
+                {
+                    Tag |= TraceWrite_ExplicitIP;
+                }
+                if(Write->Step != Predicted.Step)
+                {
+                    Tag |= TraceWrite_ExplicitStep;
+                }
+                if(Write->Address != Predicted.Address)
+                {
+                    Tag |= TraceWrite_ExplicitAddress;
+                }
+                if(Write->Before != Predicted.Before)
+                {
+                    Tag |= TraceWrite_ExplicitBefore;
+                }
+                if(Write->After != Predicted.After)
+                {
+                    Tag |= TraceWrite_ExplicitAfter;
+                }
+
+                if(!Tag && (RunCount < (TraceWrite_Run - 1)))
+                {
+                    ++RunCount;
+                }
+                else
+                {
+                    if(RunCount)
+                    {
+                        *At++ = (u8)(TraceWrite_Run | RunCount);
+                        RunCount = 0;
+                    }
+                    if(!Tag)
+                    {
+                        ++RunCount;
+                    }
+                    else
+                    {
+                        *At++ = Tag;
+                        if(Tag & TraceWrite_ExplicitIP)
+                        {
+                            At = PutVarint(At, Write->IP);
+                        }
+                        if(Tag & TraceWrite_ExplicitStep)
+                        {
+                            At = PutVarint(At, Write->Step - LastStep);
+                        }
+                        if(Tag & TraceWrite_ExplicitAddress)
+                        {
+                            *At++ = (u8)(Write->Address & ((1 << TRACE_WRITE_PAGE_SHIFT) - 1));
+                        }
+                        if(Tag & TraceWrite_ExplicitBefore)
+                        {
+                            At = PutVarint(At, Write->Before);
+                        }
+                        if(Tag & TraceWrite_ExplicitAfter)
+                        {
+                            At = PutVarint(At, Write->After);
+                        }
+                    }
+                }
+                UpdateTraceWritePredictor(&Predictor, Store->ProgramLength, Write);
+            }
+            if(RunCount)
+            {
+                *At++ = (u8)(TraceWrite_Run | RunCount);
+            }
+
+            ChunkEntry->Size = (u32)(At - Chunk);
+            EmitTraceStoreBytes(Store, Chunk, ChunkEntry->Size);
+            if(Header->MaxWriteChunkSize < ChunkEntry->Size)
+            {
+                Header->MaxWriteChunkSize = ChunkEntry->Size;
+            }
+            ++KeyEntry->ChunkCount;
+        }
+
+        KeyEntry->ChunkTableOffset = Store->Offset;
+        EmitTraceStoreBytes(Store, Chunks, KeyEntry->ChunkCount*sizeof(trace_write_chunk));
+
+        ++Header->WriteKeyCount;
+        WriteIndex = KeyEnd;
+    }
+
+    Header->WriteIndexOffset = Store->Offset;
+    EmitTraceStoreBytes(Store, Keys, Header->WriteKeyCount*sizeof(trace_write_key));
+}
+
+// NOTE(chuck): Writes one record that didn't go the way the predictor said, against the IP the predictor expected.
+static void EncodeTraceStoreRecord(trace_store_writer *Store, trace_record *Record)
+{
+    u8 Tag = TraceStore_RegisterMask;
+    u8 Extended = 0;
+    if(Record->Register < TraceStore_RegisterMask)
+    {
+        Tag = Record->Register;
+    }
+    else if(Record->Register != TRACE_NO_REGISTER)
+    {
+        Extended |= TraceStore_ExplicitRegister;
+    }
+    if(Record->Flags & Trace_RegisterWrite)
+    {
+        Tag |= TraceStore_RegisterWrite;
+    }
+    if(Record->FlagsAfter != Record->FlagsBefore)
+    {
+        Tag |= TraceStore_FlagsChanged;
+    }
+    if(Record->IP != Store->NextIP)
+    {
+        Tag |= TraceStore_Jump;
+    }
+
+    if(Record->Flags & Trace_MemoryWrite)
+    {
+        Extended |= TraceStore_MemoryWrite;
+    }
+    else
+    {
+        Assert(!Record->MemoryAddress && !Record->MemoryBefore && !Record->MemoryAfter);
+    }
+    if(GetTraceNameIndex(Store->OpAtOffset, Store->ProgramLength, Record->IP) != Record->NameIndex)
+    {
+        Extended |= TraceStore_ExplicitName;
+    }
+    if((Record->RegisterBefore != PredictRegisterBefore(&Store->State, Record->Register, Record->Flags)) ||
+       (!(Record->Flags & Trace_RegisterWrite) && (Record->RegisterAfter != Record->RegisterBefore)))
+    {
+        Extended |= TraceStore_ExplicitRegisterBefore;
+    }
+    if(Record->FlagsBefore != Store->State.Flags)
+    {
+        Extended |= TraceStore_ExplicitFlagsBefore;
+    }
+
+    u8 *At = Store->Block + Store->BlockSize;
+    if(Extended)
+    {
+        *At++ = Tag | TraceStore_Extended;
+        *At++ = Extended;
+    }
+    else
+    {
+        *At++ = Tag;
+    }
+
+    if(Extended & TraceStore_ExplicitName)
+    {
+        At = PutVarint(At, Record->NameIndex);
+    }
+    if(Extended & TraceStore_ExplicitRegister)
+    {
+        At = PutVarint(At, Record->Register);
+    }
+    if(Tag & TraceStore_Jump)
+    {
+        At = PutVarint(At, ZigZag((__int64)Record->IP - (__int64)Store->NextIP));
+    }
+    if(Extended & TraceStore_ExplicitRegisterBefore)
+    {
+        At = PutVarint(At, Record->RegisterBefore);
+    }
+    if((Tag & TraceStore_RegisterWrite) || (Extended & TraceStore_ExplicitRegisterBefore))
+    {
+        At = PutVarint(At, ZigZag((s16)(Record->RegisterAfter - Record->RegisterBefore)));
+    }
+    if(Extended & TraceStore_ExplicitFlagsBefore)
+    {
+        At = PutVarint(At, Record->FlagsBefore);
+    }
+    if(Tag & TraceStore_FlagsChanged)
+    {
+        At = PutVarint(At, Record->FlagsAfter ^ Record->FlagsBefore);
+    }
+    if(Extended & TraceStore_MemoryWrite)
+    {
+        At = PutVarint(At, Record->MemoryAddress);
+        At = PutVarint(At, Record->MemoryBefore);
+        At = PutVarint(At, Record->MemoryAfter);
+    }
+
+    Assert((At - (Store->Block + Store->BlockSize)) <= TRACE_STORE_MAX_RECORD_SIZE);
+    Store->BlockSize = (u32)(At - Store->Block);
+}
+
+static void AddTraceStoreRecord(trace_store_writer *Store, trace_record *Record)
+{
+    Assert(!(Record->Flags & ~(Trace_RegisterWrite | Trace_MemoryWrite)));
+
+    if(!Store->BlockStepCount)
+    {
+        Store->BlockHeader.IP = Record->IP;
+        Store->BlockHeader.State = Store->State;
+        Store->NextIP = Record->IP;
+        ResetTraceStorePredictor(&Store->Predictor);
+    }
+    Store->NextIP = PredictTraceStoreIP(&Store->Predictor, Store->ProgramLength, Store->NextIP);
+
+    trace_record Predicted;
+    trace_store_history *History = PredictTraceStoreRecord(&Store->Predictor, &Store->State, Store->OpAtOffset, Store->ProgramLength, Store->NextIP, &Predicted);
+    if(History && History->SetsFlags)
+    {
+        Predicted.FlagsAfter = Record->FlagsAfter;
+    }
+    if(History && !memcmp(&Predicted, Record, sizeof(Predicted)))
+    {
+        if(History->SetsFlags)
+        {
+            Store->RepeatFlagsSize = (u32)(PutVarint(Store->RepeatFlags + Store->RepeatFlagsSize, Record->FlagsAfter ^ Record->FlagsBefore) - Store->RepeatFlags);
+        }
+        ++Store->RepeatCount;
+    }
+    else
+    {
+        FlushTraceStoreRepeat(Store);
+        EncodeTraceStoreRecord(Store, Record);
+    }
+
+    if((Record->Flags & Trace_RegisterWrite) && (Record->Register < TRACE_WRITE_FIRST_PAGE_KEY))
+    {
+        AddTraceWrite(Store, Record->Register, Record->Register, Record->IP, Record->RegisterBefore, Record->RegisterAfter);
+    }
+    if(Record->Flags & Trace_MemoryWrite)
+    {
+        AddTraceWrite(Store, TRACE_WRITE_FIRST_PAGE_KEY + (Record->MemoryAddress >> TRACE_WRITE_PAGE_SHIFT), Record->MemoryAddress,
+                      Record->IP, Record->MemoryBefore, Record->MemoryAfter);
+    }
+
+    ApplyTraceRecord(&Store->State, Record);
+    UpdateTraceStorePredictor(&Store->Predictor, Store->ProgramLength, Record);
+    Store->NextIP = GetFallThroughOffset(Store->OpAtOffset, Store->ProgramLength, Record->IP);
+    if((Record->IP < Store->ProgramLength) && !Store->FirstStepAtIP[Record->IP])
+    {
+        Store->FirstStepAtIP[Record->IP] = Store->StepCount + 1;
+    }
+
+    ++Store->StepCount;
+    if(++Store->BlockStepCount == TRACE_STORE_STEPS_PER_BLOCK)
+    {
+        FlushTraceStoreBlock(Store);
+    }
+}
+
+static int EndTraceStore(trace_store_writer *Store, char *Filename)
+{
+    FlushTraceStoreBlock(Store);
+
+    trace_store_header Header = {0};
+    Header.Magic = TRACE_STORE_MAGIC;
+    Header.Version = TRACE_STORE_VERSION;
+    Header.FileNameLength = (u32)strlen(Filename);
+    Header.ProgramLength = Store->ProgramLength;
+    Header.StepsPerBlock = TRACE_STORE_STEPS_PER_BLOCK;
+    Header.BlockCount = Store->BlockCount;
+    Header.MaxBlockSize = Store->MaxBlockSize;
+    Header.StepCount = Store->StepCount;
+
+    Header.IndexOffset = Store->Offset;
+    EmitTraceStoreBytes(Store, TraceStoreIndexArena.Base, Store->BlockCount*sizeof(u64));
+
+    Header.IPTableOffset = Store->Offset;
+    u32 LastIP = 0;
+    u64 LastStep = 0;
+    for(u32 IP = 0;
+        IP < Store->ProgramLength;
+        ++IP)
+    {
+        if(Store->FirstStepAtIP[IP])
+        {
+            u64 Step = Store->FirstStepAtIP[IP] - 1;
+            u8 Entry[32];
+            u8 *At = PutVarint(Entry, IP - LastIP);
+            At = PutVarint(At, ZigZag((__int64)(Step - LastStep)));
+            EmitTraceStoreBytes(Store, Entry, At - Entry);
+
+            LastIP = IP;
+            LastStep = Step;
+            ++Header.IPCount;
+        }
+    }
+    Header.IPTableSize = Store->Offset - Header.IPTableOffset;
+
+    EmitTraceWriteIndex(Store, &Header);
+
+    FlushOutput(&Store->Output);
+    fseek(Store->Output.File, 0, SEEK_SET);
+    fwrite(&Header, sizeof(Header), 1, Store->Output.File);
+    int Result = !ferror(Store->Output.File);
+    fclose(Store->Output.File);
+
+    return(Result);
+}
+
+// NOTE(chuck): Expects File to be positioned just past the program bytes, and leaves it wherever.
+static int OpenTraceStore(trace_store_reader *Store, FILE *File, trace_store_header *Header, op **OpAtOffset)
+{
+    memset(Store, 0, sizeof(*Store));
+    Store->File = File;
+    Store->Header = *Header;
+    Store->OpAtOffset = OpAtOffset;
+    Store->ProgramLength = Header->ProgramLength;
+    Store->BlockOffsets = PushArray(&TraceStoreIndexArena, u64, Header->BlockCount);
+    Store->Block = PushArray(&TraceStoreArena, u8, Header->MaxBlockSize);
+    Store->Predictor.History = PushArray(&TraceStoreArena, trace_store_history, Header->ProgramLength);
+    Store->WritePredictor.History = PushArray(&TraceStoreArena, trace_write_history, Header->ProgramLength);
+    Store->WriteKeys = PushArray(&TraceStoreIndexArena, trace_write_key, Header->WriteKeyCount);
+    Store->WriteChunk = PushArray(&TraceStoreArena, u8, Header->MaxWriteChunkSize);
+
+    int Result = ((Header->StepsPerBlock > 0) &&
+                  !_fseeki64(File, Header->IndexOffset, SEEK_SET) &&
+                  (fread(Store->BlockOffsets, sizeof(u64), Header->BlockCount, File) == Header->BlockCount) &&
+                  !_fseeki64(File, Header->WriteIndexOffset, SEEK_SET) &&
+                  (fread(Store->WriteKeys, sizeof(trace_write_key), Header->WriteKeyCount, File) == Header->WriteKeyCount));
+    return(Result);
+}
+
+static int LoadTraceStoreBlock(trace_store_reader *Store, u64 BlockIndex)
+{
+    int Result = 0;
+    if(BlockIndex < Store->Header.BlockCount)
+    {
+        trace_store_block_header BlockHeader;
+        if(!_fseeki64(Store->File, Store->BlockOffsets[BlockIndex], SEEK_SET) &&
+           (fread(&BlockHeader, sizeof(BlockHeader), 1, Store->File) == 1) &&
+           (BlockHeader.Size <= Store->Header.MaxBlockSize) &&
+           (fread(Store->Block, 1, BlockHeader.Size, Store->File) == BlockHeader.Size))
+        {
+            Store->At = Store->Block;
+            Store->StepsLeft = BlockHeader.StepCount;
+            Store->RepeatsLeft = 0;
+            Store->State = BlockHeader.State;
+            Store->NextIP = BlockHeader.IP;
+            Store->Step = BlockIndex*Store->Header.StepsPerBlock;
+            ResetTraceStorePredictor(&Store->Predictor);
+            Result = 1;
+        }
+    }
+    return(Result);
+}
+
+// NOTE(chuck): Reads back one record that EncodeTraceStoreRecord() wrote.
+static u8 *DecodeTraceStoreRecord(trace_store_reader *Store, u8 *At, trace_record *Record)
+{
+    u8 Tag = *At++;
+    u8 Extended = (Tag & TraceStore_Extended) ? *At++ : 0;
+
+    memset(Record, 0, sizeof(*Record));
+    Record->Register = (u8)(Tag & TraceStore_RegisterMask);
+    if(Record->Register == TraceStore_RegisterMask)
+    {
+        Record->Register = TRACE_NO_REGISTER;
+    }
+    if(Tag & TraceStore_RegisterWrite)
+    {
+        Record->Flags |= Trace_RegisterWrite;
+    }
+    if(Extended & TraceStore_MemoryWrite)
+    {
+        Record->Flags |= Trace_MemoryWrite;
+    }
+
+    int NameIndex = (Extended & TraceStore_ExplicitName) ? (int)GetVarint(&At) : -1;
+    if(Extended & TraceStore_ExplicitRegister)
+    {
+        Record->Register = (u8)GetVarint(&At);
+    }
+    Record->IP = Store->NextIP;
+    if(Tag & TraceStore_Jump)
+    {
+        Record->IP = (u32)((__int64)Record->IP + UnZigZag(GetVarint(&At)));
+    }
+    if(NameIndex < 0)
+    {
+        NameIndex = GetTraceNameIndex(Store->OpAtOffset, Store->ProgramLength, Record->IP);
+    }
+    Record->NameIndex = (u16)NameIndex;
+
+    Record->RegisterBefore = (Extended & TraceStore_ExplicitRegisterBefore) ? (u16)GetVarint(&At) : PredictRegisterBefore(&Store->State, Record->Register, Record->Flags);
+    Record->RegisterAfter = Record->RegisterBefore;
+    if((Tag & TraceStore_RegisterWrite) || (Extended & TraceStore_ExplicitRegisterBefore))
+    {
+        Record->RegisterAfter = (u16)(Record->RegisterBefore + UnZigZag(GetVarint(&At)));
+    }
+
+    Record->FlagsBefore = (Extended & TraceStore_ExplicitFlagsBefore) ? (u16)GetVarint(&At) : Store->State.Flags;
+    Record->FlagsAfter = Record->FlagsBefore;
+    if(Tag & TraceStore_FlagsChanged)
+    {
+        Record->FlagsAfter ^= (u16)GetVarint(&At);
+    }
+
+    if(Extended & TraceStore_MemoryWrite)
+    {
+        Record->MemoryAddress = (u32)GetVarint(&At);
+        Record->MemoryBefore = (u16)GetVarint(&At);
+        Record->MemoryAfter = (u16)GetVarint(&At);
+    }
+
+    return(At);
+}
+
+// NOTE(chuck): Hands back the next record in step order, crossing into the next block as needed. Returns 0 at the end of the run.
+static int ReadTraceStoreRecord(trace_store_reader *Store, trace_record *Record)
+{
+    if(!Store->StepsLeft &&
+       ((Store->Step >= Store->Header.StepCount) || !LoadTraceStoreBlock(Store, Store->Step / Store->Header.StepsPerBlock)))
+    {
+        return(0);
+    }
+
+    u8 *At = Store->At;
+    Store->NextIP = PredictTraceStoreIP(&Store->Predictor, Store->ProgramLength, Store->NextIP);
+    if(!Store->RepeatsLeft && (At[0] == (TraceStore_RegisterMask | TraceStore_Extended)) && (At[1] & TraceStore_Repeat))
+    {
+        At += 2;
+        Store->RepeatsLeft = (u32)GetVarint(&At);
+    }
+    if(Store->RepeatsLeft)
+    {
+        trace_store_history *History = PredictTraceStoreRecord(&Store->Predictor, &Store->State, Store->OpAtOffset, Store->ProgramLength, Store->NextIP, Record);
+        if(History && History->SetsFlags)
+        {
+            Record->FlagsAfter ^= (u16)GetVarint(&At);
+        }
+        --Store->RepeatsLeft;
+    }
+    else
+    {
+        At = DecodeTraceStoreRecord(Store, At, Record);
+    }
+
+    Store->At = At;
+    --Store->StepsLeft;
+    ++Store->Step;
+    ApplyTraceRecord(&Store->State, Record);
+    UpdateTraceStorePredictor(&Store->Predictor, Store->ProgramLength, Record);
+    Store->NextIP = GetFallThroughOffset(Store->OpAtOffset, Store->ProgramLength, Record->IP);
+
+    return(1);
+}
+
+// NOTE(chuck): Only the block holding Step gets decoded, and only up to Step.
+static int SeekTraceStore(trace_store_reader *Store, u64 Step)
+{
+    int Result = 0;
+    if((Step < Store->Header.StepCount) && LoadTraceStoreBlock(Store, Step / Store->Header.StepsPerBlock))
+    {
+        Result = 1;
+        trace_record Skipped;
+        while(Result && (Store->Step < Step))
+        {
+            Result = ReadTraceStoreRecord(Store, &Skipped);
+        }
+    }
+    return(Result);
+}
+
+static int FindFirstStepAtIP(trace_store_reader *Store, u32 IP, u64 *Step)
+{
+    int Result = 0;
+
+    u8 *Table = PushArray(&TraceStoreArena, u8, Store->Header.IPTableSize + 1);
+    if(!_fseeki64(Store->File, Store->Header.IPTableOffset, SEEK_SET) &&
+       (fread(Table, 1, Store->Header.IPTableSize, Store->File) == Store->Header.IPTableSize))
+    {
+        u8 *At = Table;
+        u32 EntryIP = 0;
+        u64 EntryStep = 0;
+        for(u32 EntryIndex = 0;
+            EntryIndex < Store->Header.IPCount;
+            ++EntryIndex)
+        {
+            EntryIP += (u32)GetVarint(&At);
+            EntryStep += (u64)UnZigZag(GetVarint(&At));
+            if(EntryIP >= IP)
+            {
+                if(EntryIP == IP)
+                {
+                    *Step = EntryStep;
+                    Result = 1;
+                }
+                break;
+            }
+        }
+    }
+
+    return(Result);
+}
+
+static u16 GetTraceRegister(cpu_state *State, int Register)
+{
+    u16 Result = (Register < TRACE_SEGMENT_REGISTER) ? State->Registers[Register] : State->SegmentRegisters[Register - TRACE_SEGMENT_REGISTER];
+    return(Result);
+}
+
+static void BeginTraceFolder(trace_folder *Folder, output_buffer *Output, op **OpAtOffset, u32 ProgramLength)
+{
+    memset(Folder, 0, sizeof(*Folder));
+    Folder->Output = Output;
+    Folder->OpAtOffset = OpAtOffset;
+    Folder->ProgramLength = ProgramLength;
+    Folder->LastStepAtIP = PushArray(&OpIndexArena, u64, ProgramLength);
+}
+
+static void EmitHeldSteps(trace_folder *Folder, u32 Count)
+{
+    while(Count--)
+    {
+        u64 HistoryIndex = Folder->HistoryCount - Folder->Held;
+        u64 Step = Folder->Step - Folder->Held;
+        EmitTraceStep(Folder->Output, Step, &Folder->History[HistoryIndex % FOLD_HISTORY_SIZE], Folder->OpAtOffset, Folder->ProgramLength);
+        --Folder->Held;
+    }
+}
+
+// NOTE(chuck): Compares how far each register moved between From and To against how far it moved on the first trip.
+static void TrackFoldDelta(trace_folder *Folder, cpu_state *From, cpu_state *To)
+{
+    for(int Register = 0;
+        Register < (TRACE_SEGMENT_REGISTER + 4);
+        ++Register)
+    {
+        u16 Delta = (u16)(GetTraceRegister(To, Register) - GetTraceRegister(From, Register));
+        if(Delta != GetTraceRegister(&Folder->Delta, Register))
+        {
+            Folder->VariesMask |= (1 << Register);
+        }
+    }
+    if(From->Flags != To->Flags)
+    {
+        Folder->VariesMask |= FOLD_FLAGS_VARY;
+    }
+}
+
+static void TallyFoldWrites(trace_folder *Folder, trace_record *Records, u32 Count)
+{
+    for(u32 Index = 0;
+        Index < Count;
+        ++Index)
+    {
+        trace_record *Record = &Records[Index];
+        if(Record->Flags & Trace_MemoryWrite)
+        {
+            if(!Folder->WriteCount || (Folder->LowestWrite > Record->MemoryAddress))
+            {
+                Folder->LowestWrite = Record->MemoryAddress;
+            }
+            if(!Folder->WriteCount || (Folder->HighestWrite < Record->MemoryAddress))
+            {
+                Folder->HighestWrite = Record->MemoryAddress;
+            }
+            ++Folder->WriteCount;
+        }
+    }
+}
+
+static void EmitFoldSummary(trace_folder *Folder)
+{
+    output_buffer *Output = Folder->Output;
+    u64 LastFoldedStep = Folder->FirstFoldedStep + Folder->Repeats*Folder->Period - 1;
+    EmitFormat(Output, "                      ; loop of %u steps at 0x%08X went around %llu more times (steps %llu-%llu)\n",
+               Folder->Period, Folder->Body[0].IP, Folder->Repeats, Folder->FirstFoldedStep, LastFoldedStep);
+
+    int Any = 0;
+    for(int Register = 0;
+        Register < (TRACE_SEGMENT_REGISTER + 4);
+        ++Register)
+    {
+        s16 Delta = (s16)GetTraceRegister(&Folder->Delta, Register);
+        if(Delta && !(Folder->VariesMask & (1 << Register)))
+        {
+            EmitFormat(Output, "%s%s %+d", Any ? ", " : "                      ; each time: ", GetTraceRegisterName((u8)Register), Delta);
+            Any = 1;
+        }
+    }
+    if(Any)
+    {
+        EmitChar(Output, '\n');
+    }
+
+    Any = 0;
+    for(int Register = 0;
+        Register < (TRACE_SEGMENT_REGISTER + 4);
+        ++Register)
+    {
+        if(Folder->VariesMask & (1 << Register))
+        {
+            EmitFormat(Output, "%s%s", Any ? ", " : "                      ; varies: ", GetTraceRegisterName((u8)Register));
+            Any = 1;
+        }
+    }
+    if(Folder->VariesMask & FOLD_FLAGS_VARY)
+    {
+        EmitFormat(Output, "%sflags", Any ? ", " : "                      ; varies: ");
+        Any = 1;
+    }
+    if(Any)
+    {
+        EmitChar(Output, '\n');
+    }
+
+    Any = 0;
+    for(int Register = 0;
+        Register < (TRACE_SEGMENT_REGISTER + 4);
+        ++Register)
+    {
+        if(GetTraceRegister(&Folder->Delta, Register) || (Folder->VariesMask & (1 << Register)))
+        {
+            EmitFormat(Output, "%s%s:0x%04X", Any ? " " : "                      ; after: ", GetTraceRegisterName((u8)Register), GetTraceRegister(&Folder->IterationStart, Register));
+            Any = 1;
+        }
+    }
+    if(Any)
+    {
+        EmitChar(Output, '\n');
+    }
+
+    if(Folder->WriteCount)
+    {
+        EmitFormat(Output, "                      ; memory writes: %llu to [%u]", Folder->WriteCount, Folder->LowestWrite);
+        if(Folder->HighestWrite != Folder->LowestWrite)
+        {
+            EmitFormat(Output, "..[%u]", Folder->HighestWrite);
+        }
+        EmitChar(Output, '\n');
+    }
+}
+
+// NOTE(chuck): Closes out a loop. Whatever part of an iteration got through before the pattern broke is printed as is.
+static void EndFold(trace_folder *Folder)
+{
+    EmitFoldSummary(Folder);
+
+    u64 Step = Folder->FirstFoldedStep + Folder->Repeats*Folder->Period;
+    for(u32 Position = 0;
+        Position < Folder->Position;
+        ++Position)
+    {
+        EmitTraceStep(Folder->Output, Step + Position, &Folder->Iteration[Position], Folder->OpAtOffset, Folder->ProgramLength);
+    }
+
+    Folder->Folding = 0;
+    Folder->HistoryCount = 0;
+    Folder->Held = 0;
+}
+
+static void AddFoldStep(trace_folder *Folder, trace_record *Record)
+{
+    if(Folder->Folding)
+    {
+        if(Record->IP == Folder->Body[Folder->Position].IP)
+        {
+            Folder->Iteration[Folder->Position++] = *Record;
+            ApplyTraceRecord(&Folder->State, Record);
+            ++Folder->Step;
+
+            if(Folder->Position == Folder->Period)
+            {
+                TallyFoldWrites(Folder, Folder->Iteration, Folder->Period);
+                TrackFoldDelta(Folder, &Folder->IterationStart, &Folder->State);
+                Folder->IterationStart = Folder->State;
+                ++Folder->Repeats;
+                Folder->Position = 0;
+            }
+            return;
+        }
+
+        EndFold(Folder);
+    }
+
+    u32 Slot = (u32)(Folder->HistoryCount % FOLD_HISTORY_SIZE);
+    Folder->History[Slot] = *Record;
+    Folder->HistoryState[Slot] = Folder->State;
+    ++Folder->HistoryCount;
+    ++Folder->Held;
+    ApplyTraceRecord(&Folder->State, Record);
+
+    u64 LastStep = 0;
+    if(Record->IP < Folder->ProgramLength)
+    {
+        LastStep = Folder->LastStepAtIP[Record->IP];
+        Folder->LastStepAtIP[Record->IP] = Folder->Step + 1;
+    }
+    ++Folder->Step;
+
+    u64 Period = LastStep ? (Folder->Step - LastStep) : 0;
+    int IsLoop = (Period && (Period <= FOLD_MAX_PERIOD) && (Folder->HistoryCount >= 2*Period));
+    for(u64 Back = 0;
+        IsLoop && (Back < Period);
+        ++Back)
+    {
+        u64 Newer = Folder->HistoryCount - 1 - Back;
+        u64 Older = Newer - Period;
+        IsLoop = (Folder->History[Newer % FOLD_HISTORY_SIZE].IP == Folder->History[Older % FOLD_HISTORY_SIZE].IP);
+    }
+
+    if(IsLoop)
+    {
+        // NOTE(chuck): The older copy is the first iteration and gets printed. The newer copy is the first repeat and doesn't.
+        if(Folder->Held > Period)
+        {
+            EmitHeldSteps(Folder, Folder->Held - (u32)Period);
+        }
+
+        u64 SecondStart = Folder->HistoryCount - Period;
+        u64 FirstStart = SecondStart - Period;
+        for(u32 Position = 0;
+            Position < Period;
+            ++Position)
+        {
+            Folder->Body[Position] = Folder->History[(SecondStart + Position) % FOLD_HISTORY_SIZE];
+        }
+
+        cpu_state *FirstState = &Folder->HistoryState[FirstStart % FOLD_HISTORY_SIZE];
+        cpu_state *SecondState = &Folder->HistoryState[SecondStart % FOLD_HISTORY_SIZE];
+        for(int Register = 0;
+            Register < (TRACE_SEGMENT_REGISTER + 4);
+            ++Register)
+        {
+            u16 Delta = (u16)(GetTraceRegister(SecondState, Register) - GetTraceRegister(FirstState, Register));
+            if(Register < TRACE_SEGMENT_REGISTER)
+            {
+                Folder->Delta.Registers[Register] = Delta;
+            }
+            else
+            {
+                Folder->Delta.SegmentRegisters[Register - TRACE_SEGMENT_REGISTER] = Delta;
+            }
+        }
+        Folder->VariesMask = (FirstState->Flags != SecondState->Flags) ? FOLD_FLAGS_VARY : 0;
+        TrackFoldDelta(Folder, SecondState, &Folder->State);
+        Folder->WriteCount = 0;
+        TallyFoldWrites(Folder, Folder->Body, (u32)Period);
+
+        Folder->Folding = 1;
+        Folder->Period = (u32)Period;
+        Folder->Position = 0;
+        Folder->Repeats = 1;
+        Folder->FirstFoldedStep = Folder->Step - Period;
+        Folder->IterationStart = Folder->State;
+        Folder->Held = 0;
+    }
+    else if(Folder->Held > FOLD_MAX_PERIOD)
+    {
+        EmitHeldSteps(Folder, 1);
+    }
+}
+
+static void EndTraceFolder(trace_folder *Folder)
+{
+    if(Folder->Folding)
+    {
+        EndFold(Folder);
+    }
+    EmitHeldSteps(Folder, Folder->Held);
+}
+
+// NOTE(chuck): Reads the next line of the reference without its line ending. Anything past MAX_LINE_LENGTH is thrown away.
+static int ReadReferenceLine(reference_trace *Reference)
+{
+    int Result = 0;
+    if(fgets(Reference->Line, sizeof(Reference->Line), Reference->File))
+    {
+        size_t Length = strlen(Reference->Line);
+        if(Length && (Reference->Line[Length - 1] != '\n'))
+        {
+            int Char;
+            while(((Char = fgetc(Reference->File)) != EOF) && (Char != '\n'))
+            {
+            }
+        }
+        while(Length && ((Reference->Line[Length - 1] == '\n') || (Reference->Line[Length - 1] == '\r')))
+        {
+            Reference->Line[--Length] = 0;
+        }
+
+        ++Reference->LineNumber;
+        Result = 1;
+    }
+    return(Result);
+}
+
+static void RememberReferenceLine(reference_trace *Reference)
+{
+    u32 Slot = Reference->ContextCount++ % COMPARE_CONTEXT_LINES;
+    Reference->ContextLineNumber[Slot] = Reference->LineNumber;
+    memcpy(Reference->Context[Slot], Reference->Line, sizeof(Reference->Line));
+}
+
+static int IsBlankLine(char *Line)
+{
+    while((*Line == ' ') || (*Line == '\t'))
+    {
+        ++Line;
+    }
+    int Result = (*Line == 0);
+    return(Result);
+}
+
+// NOTE(chuck): Same numbering as trace_record.Register, or -1.
+static int GetTraceRegisterIndex(char *Name, size_t Length)
+{
+    int Result = -1;
+    if(Length == 2)
+    {
+        for(int RegisterIndex = 0;
+            RegisterIndex < 8;
+            ++RegisterIndex)
+        {
+            if(!strncmp(Name, RegisterLookup[8 + RegisterIndex], 2))
+            {
+                Result = RegisterIndex;
+            }
+        }
+        for(int SegmentRegisterIndex = 0;
+            SegmentRegisterIndex < 4;
+            ++SegmentRegisterIndex)
+        {
+            if(!strncmp(Name, SegmentRegisterLookup[SegmentRegisterIndex], 2))
+            {
+                Result = TRACE_SEGMENT_REGISTER + SegmentRegisterIndex;
+            }
+        }
+    }
+    return(Result);
+}
+
+static int ParseFlagLetters(char *At, char *End)
+{
+    int Result = 0;
+    for(;
+        At < End;
+        ++At)
+    {
+        switch(*At)
+        {
+            case 'C': Result |= FLAG_CARRY; break;
+            case 'P': Result |= FLAG_PARITY; break;
+            case 'A': Result |= FLAG_AUX_CARRY; break;
+            case 'Z': Result |= FLAG_ZERO; break;
+            case 'S': Result |= FLAG_SIGN; break;
+            case 'T': Result |= FLAG_TRAP; break;
+            case 'I': Result |= FLAG_INTERRUPT; break;
+            case 'D': Result |= FLAG_DIRECTION; break;
+            case 'O': Result |= FLAG_OVERFLOW; break;
+            default: return(-1);
+        }
+    }
+    return(Result);
+}
+
+// NOTE(chuck): Picks apart everything after the ';' of a reference step. Returns 0 if it doesn't look like one.
+static int ParseReferenceStep(char *Line, reference_step *Step)
+{
+    memset(Step, 0, sizeof(*Step));
+
+    char *At = strchr(Line, ';');
+    if(!At)
+    {
+        return(0);
+    }
+    ++At;
+
+    for(;;)
+    {
+        while(*At == ' ')
+        {
+            ++At;
+        }
+        if(!*At)
+        {
+            break;
+        }
+
+        char *Token = At;
+        while(*At && (*At != ' '))
+        {
+            ++At;
+        }
+
+        char *Colon = memchr(Token, ':', At - Token);
+        char *Arrow = Colon ? strstr(Colon, "->") : 0;
+        if(!Colon || !Arrow || (Arrow > At))
+        {
+            return(0);
+        }
+
+        size_t NameLength = Colon - Token;
+        if((NameLength == 5) && !strncmp(Token, "flags", 5))
+        {
+            int Before = ParseFlagLetters(Colon + 1, Arrow);
+            int After = ParseFlagLetters(Arrow + 2, At);
+            if((Before < 0) || (After < 0))
+            {
+                return(0);
+            }
+            Step->HasFlags = 1;
+            Step->FlagsBefore = (u16)Before;
+            Step->FlagsAfter = (u16)After;
+        }
+        else
+        {
+            char *BeforeEnd;
+            char *AfterEnd;
+            u32 Before = (u32)strtoul(Colon + 1, &BeforeEnd, 16);
+            u32 After = (u32)strtoul(Arrow + 2, &AfterEnd, 16);
+            if((BeforeEnd != Arrow) || (AfterEnd != At))
+            {
+                return(0);
+            }
+
+            int Register = GetTraceRegisterIndex(Token, NameLength);
+            if((NameLength == 2) && !strncmp(Token, "ip", 2))
+            {
+                Step->HasIP = 1;
+                Step->IPBefore = Before;
+                Step->IPAfter = After;
+            }
+            else if((Register >= 0) && (Step->RegisterCount < COMPARE_MAX_REGISTERS))
+            {
+                Step->Register[Step->RegisterCount] = (u8)Register;
+                Step->RegisterBefore[Step->RegisterCount] = (u16)Before;
+                Step->RegisterAfter[Step->RegisterCount] = (u16)After;
+                ++Step->RegisterCount;
+            }
+            else
+            {
+                return(0);
+            }
+        }
+    }
+
+    return(1);
+}
+
+// NOTE(chuck): The reference leaves out registers and flags that didn't actually change, so do the same before comparing.
+static int DidRecordChangeRegister(trace_record *Record)
+{
+    int Result = ((Record->Flags & Trace_RegisterWrite) &&
+                  (Record->Register < (TRACE_SEGMENT_REGISTER + 4)) &&
+                  (Record->RegisterBefore != Record->RegisterAfter));
+    return(Result);
+}
+
+static char *CompareReferenceStep(reference_step *Expected, trace_record *Record, u32 IPAfter)
+{
+    char *Result = 0;
+
+    int ChangedRegister = DidRecordChangeRegister(Record);
+    if(Expected->RegisterCount != ChangedRegister)
+    {
+        Result = ChangedRegister ? "a register changed that shouldn't have" : "a register should have changed";
+    }
+    else if(ChangedRegister &&
+            ((Expected->Register[0] != Record->Register) ||
+             (Expected->RegisterBefore[0] != Record->RegisterBefore) ||
+             (Expected->RegisterAfter[0] != Record->RegisterAfter)))
+    {
+        Result = "wrong register change";
+    }
+    else if(Expected->HasIP && (Expected->IPBefore != Record->IP))
+    {
+        Result = "wrong ip";
+    }
+    else if(Expected->HasIP && (Expected->IPAfter != IPAfter))
+    {
+        Result = "wrong next ip";
+    }
+    else if(Expected->HasFlags != (Record->FlagsBefore != Record->FlagsAfter))
+    {
+        Result = Expected->HasFlags ? "flags should have changed" : "flags changed that shouldn't have";
+    }
+    else if(Expected->HasFlags &&
+            ((Expected->FlagsBefore != Record->FlagsBefore) ||
+             (Expected->FlagsAfter != Record->FlagsAfter)))
+    {
+        Result = "wrong flags";
+    }
+
+    return(Result);
+}
+
+static void EmitReferenceFlags(output_buffer *Output, u16 Flags)
+{
+    if(Flags)
+    {
+        EmitFlags(Output, Flags);
+    }
+}
+
+// NOTE(chuck): A record, written out the way the reference traces write their changes.
+static void EmitReferenceChanges(output_buffer *Output, trace_record *Record, u32 IPAfter, int ShowIP)
+{
+    if(DidRecordChangeRegister(Record))
+    {
+        EmitFormat(Output, "%s:0x%x->0x%x ", GetTraceRegisterName(Record->Register), Record->RegisterBefore, Record->RegisterAfter);
+    }
+    if(ShowIP)
+    {
+        EmitFormat(Output, "ip:0x%x->0x%x ", Record->IP, IPAfter);
+    }
+    if(Record->FlagsBefore != Record->FlagsAfter)
+    {
+        EmitBytes(Output, "flags:", 6);
+        EmitReferenceFlags(Output, Record->FlagsBefore);
+        EmitBytes(Output, "->", 2);
+        EmitReferenceFlags(Output, Record->FlagsAfter);
+        EmitChar(Output, ' ');
+    }
+}
+
+static void EmitCompareState(output_buffer *Output, cpu_state *State)
+{
+    for(int RegisterIndex = 0;
+        RegisterIndex < 8;
+        ++RegisterIndex)
+    {
+        EmitFormat(Output, "%s:0x%04X ", RegisterLookup[8 + RegisterIndex], State->Registers[RegisterIndex]);
+    }
+    for(int SegmentRegisterIndex = 0;
+        SegmentRegisterIndex < 4;
+        ++SegmentRegisterIndex)
+    {
+        EmitFormat(Output, "%s:0x%04X ", SegmentRegisterLookup[SegmentRegisterIndex], State->SegmentRegisters[SegmentRegisterIndex]);
+    }
+    EmitBytes(Output, "flags:", 6);
+    EmitFlags(Output, State->Flags);
+    EmitChar(Output, '\n');
+}
+
+static void EmitCompareContext(output_buffer *Output, reference_trace *Reference)
+{
+    u32 First = (Reference->ContextCount > COMPARE_CONTEXT_LINES) ? (Reference->ContextCount - COMPARE_CONTEXT_LINES) : 0;
+    for(u32 ContextIndex = First;
+        ContextIndex < Reference->ContextCount;
+        ++ContextIndex)
+    {
+        u32 Slot = ContextIndex % COMPARE_CONTEXT_LINES;
+        EmitFormat(Output, "          %8llu  %s\n", Reference->ContextLineNumber[Slot], Reference->Context[Slot]);
+    }
+}
+
+// NOTE(chuck): Skips to the next line that is either a step or the start of the final registers. Returns 0 if there isn't one.
+static int ReadReferenceStepLine(reference_trace *Reference, int *IsFinal)
+{
+    int Result = 0;
+    *IsFinal = 0;
+    while(ReadReferenceLine(Reference))
+    {
+        if(!IsBlankLine(Reference->Line) && strncmp(Reference->Line, "---", 3))
+        {
+            *IsFinal = !strncmp(Reference->Line, "Final registers:", 16);
+            Result = 1;
+            break;
+        }
+    }
+    return(Result);
+}
+
+static trace_write_key *FindTraceWriteKey(trace_store_reader *Store, u32 Key)
+{
+    trace_write_key *Result = 0;
+    u32 Low = 0;
+    u32 High = Store->Header.WriteKeyCount;
+    while(Low < High)
+    {
+        u32 Middle = Low + (High - Low)/2;
+        if(Store->WriteKeys[Middle].Key < Key)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+    if((Low < Store->Header.WriteKeyCount) && (Store->WriteKeys[Low].Key == Key))
+    {
+        Result = &Store->WriteKeys[Low];
+    }
+    return(Result);
+}
+
+static trace_write_chunk *LoadTraceWriteChunks(trace_store_reader *Store, trace_write_key *Key)
+{
+    trace_write_chunk *Result = PushArray(&TraceStoreArena, trace_write_chunk, Key->ChunkCount);
+    if(_fseeki64(Store->File, Key->ChunkTableOffset, SEEK_SET) ||
+       (fread(Result, sizeof(trace_write_chunk), Key->ChunkCount, Store->File) != Key->ChunkCount))
+    {
+        Result = 0;
+    }
+    return(Result);
+}
+
+// NOTE(chuck): The last chunk that starts at or before Step, or the first chunk if they all start after it.
+static u32 FindTraceWriteChunk(trace_write_chunk *Chunks, u32 ChunkCount, u64 Step)
+{
+    u32 Low = 0;
+    u32 High = ChunkCount;
+    while(Low < High)
+    {
+        u32 Middle = Low + (High - Low)/2;
+        if(Chunks[Middle].FirstStep <= Step)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+    u32 Result = Low ? (Low - 1) : 0;
+    return(Result);
+}
+
+static u32 DecodeTraceWriteChunk(trace_store_reader *Store, trace_write_key *Key, trace_write_chunk *Chunk, trace_write *Writes)
+{
+    u32 Result = 0;
+    if((Chunk->Size <= Store->Header.MaxWriteChunkSize) &&
+       (Chunk->WriteCount <= TRACE_WRITE_CHUNK_SIZE) &&
+       !_fseeki64(Store->File, Chunk->Offset, SEEK_SET) &&
+       (fread(Store->WriteChunk, 1, Chunk->Size, Store->File) == Chunk->Size))
+    {
+        u8 *At = Store->WriteChunk;
+        u32 RunLeft = 0;
+        trace_write_predictor *Predictor = &Store->WritePredictor;
+        ResetTraceWritePredictor(Predictor, Chunk->FirstStep);
+        for(u32 WriteIndex = 0;
+            WriteIndex < Chunk->WriteCount;
+            ++WriteIndex)
+        {
+            u8 Tag = 0;
+            if(RunLeft)
+            {
+                --RunLeft;
+            }
+            else
+            {
+                Tag = *At++;
+                if(Tag & TraceWrite_Run)
+                {
+                    RunLeft = (u32)(Tag & ~TraceWrite_Run) - 1;
+                    Tag = 0;
+                }
+            }
+
+            trace_write *Write = &Writes[WriteIndex];
+            u64 LastStep = Predictor->Last.Step;
+            u32 IP = (Tag & TraceWrite_ExplicitIP) ? (u32)GetVarint(&At) : PredictTraceWriteIP(Predictor, Store->ProgramLength);
+            PredictTraceWrite(Predictor, Store->ProgramLength, Key->Key, IP, Write);
+            if(Tag & TraceWrite_ExplicitStep)
+            {
+                Write->Step = LastStep + GetVarint(&At);
+            }
+            if(Tag & TraceWrite_ExplicitAddress)
+            {
+                Write->Address = ((Key->Key - TRACE_WRITE_FIRST_PAGE_KEY) << TRACE_WRITE_PAGE_SHIFT) | *At++;
+            }
+            if(Tag & TraceWrite_ExplicitBefore)
+            {
+                Write->Before = (u16)GetVarint(&At);
+            }
+            if(Tag & TraceWrite_ExplicitAfter)
+            {
+                Write->After = (u16)GetVarint(&At);
+            }
+            UpdateTraceWritePredictor(Predictor, Store->ProgramLength, Write);
+        }
+        Result = Chunk->WriteCount;
+    }
+    return(Result);
+}
+
+// NOTE(chuck): Puts the cursor on the first write to Key at or after FromStep. Returns 0 if nothing ever wrote under Key.
+static int BeginTraceWriteCursor(trace_store_reader *Store, trace_write_cursor *Cursor, u32 Key, u64 FromStep)
+{
+    memset(Cursor, 0, sizeof(*Cursor));
+    Cursor->Key = FindTraceWriteKey(Store, Key);
+    Cursor->Chunks = Cursor->Key ? LoadTraceWriteChunks(Store, Cursor->Key) : 0;
+
+    int Result = (Cursor->Chunks != 0);
+    if(Result)
+    {
+        Cursor->ChunkIndex = FindTraceWriteChunk(Cursor->Chunks, Cursor->Key->ChunkCount, FromStep);
+        Cursor->WriteCount = DecodeTraceWriteChunk(Store, Cursor->Key, &Cursor->Chunks[Cursor->ChunkIndex], Cursor->Writes);
+        while((Cursor->WriteIndex < Cursor->WriteCount) && (Cursor->Writes[Cursor->WriteIndex].Step < FromStep))
+        {
+            ++Cursor->WriteIndex;
+        }
+    }
+    return(Result);
+}
+
+// NOTE(chuck): The write the cursor is sitting on, or 0 once they have all gone by.
+static trace_write *GetTraceWrite(trace_store_reader *Store, trace_write_cursor *Cursor)
+{
+    while(Cursor->Key &&
+          (Cursor->WriteIndex == Cursor->WriteCount) &&
+          ((Cursor->ChunkIndex + 1) < Cursor->Key->ChunkCount))
+    {
+        ++Cursor->ChunkIndex;
+        Cursor->WriteIndex = 0;
+        Cursor->WriteCount = DecodeTraceWriteChunk(Store, Cursor->Key, &Cursor->Chunks[Cursor->ChunkIndex], Cursor->Writes);
+    }
+
+    trace_write *Result = (Cursor->WriteIndex < Cursor->WriteCount) ? &Cursor->Writes[Cursor->WriteIndex] : 0;
+    return(Result);
+}
+
+// NOTE(chuck): Searches backwards from Step, one chunk at a time. Only memory keys can need more than one chunk, since a register key never has writes that don't match.
+static int FindLastTraceWrite(trace_store_reader *Store, u32 Key, u32 Address, u64 Step, trace_write *Result)
+{
+    int Found = 0;
+    trace_write_key *KeyEntry = FindTraceWriteKey(Store, Key);
+    trace_write_chunk *Chunks = KeyEntry ? LoadTraceWriteChunks(Store, KeyEntry) : 0;
+    if(Chunks && Step)
+    {
+        trace_write *Writes = PushArray(&TraceStoreArena, trace_write, TRACE_WRITE_CHUNK_SIZE);
+        u32 ChunkIndex = FindTraceWriteChunk(Chunks, KeyEntry->ChunkCount, Step - 1);
+        for(;;)
+        {
+            u32 WriteCount = DecodeTraceWriteChunk(Store, KeyEntry, &Chunks[ChunkIndex], Writes);
+            while(WriteCount--)
+            {
+                if((Writes[WriteCount].Step < Step) && (Writes[WriteCount].Address == Address))
+                {
+                    *Result = Writes[WriteCount];
+                    Found = 1;
+                    break;
+                }
+            }
+
+            if(Found || !ChunkIndex)
+            {
+                break;
+            }
+            --ChunkIndex;
+        }
+    }
+    return(Found);
+}
+
+static void EmitTraceWrite(output_buffer *Output, trace_write *Write)
+{
+    EmitFormat(Output, "%10llu  0x%08X  ", Write->Step, Write->IP);
+    if(Write->Key < TRACE_WRITE_FIRST_PAGE_KEY)
+    {
+        EmitString(Output, GetTraceRegisterName((u8)Write->Address));
+    }
+    else
+    {
+        EmitChar(Output, '[');
+        EmitInt(Output, (int)Write->Address);
+        EmitChar(Output, ']');
+    }
+    EmitBytes(Output, ":0x", 3);
+    EmitHex(Output, Write->Before, 4);
+    EmitBytes(Output, "->0x", 4);
+    EmitHex(Output, Write->After, 4);
+    EmitChar(Output, '\n');
+}
+
+// NOTE(chuck): Every write to the registers or memory in [First, Last], merged into step order across all of the keys involved.
+static u64 EmitTraceWrites(output_buffer *Output, trace_store_reader *Store, u32 FirstKey, u32 LastKey, u32 FirstAddress, u32 LastAddress, u64 FromStep, u64 ToStep)
+{
+    u64 Result = 0;
+
+    u32 CursorCount = 0;
+    trace_write_cursor *Cursors = PushArray(&TraceStoreArena, trace_write_cursor, LastKey - FirstKey + 1);
+    for(u32 Key = FirstKey;
+        Key <= LastKey;
+        ++Key)
+    {
+        if(BeginTraceWriteCursor(Store, &Cursors[CursorCount], Key, FromStep))
+        {
+            ++CursorCount;
+        }
+    }
+
+    for(;;)
+    {
+        trace_write *Next = 0;
+        trace_write_cursor *NextCursor = 0;
+        for(u32 CursorIndex = 0;
+            CursorIndex < CursorCount;
+            ++CursorIndex)
+        {
+            trace_write *Write = GetTraceWrite(Store, &Cursors[CursorIndex]);
+            if(Write && (!Next || (Write->Step < Next->Step)))
+            {
+                Next = Write;
+                NextCursor = &Cursors[CursorIndex];
+            }
+        }
+
+        if(!Next || (Next->Step >= ToStep))
+        {
+            break;
+        }
+
+        if((Next->Address >= FirstAddress) && (Next->Address <= LastAddress))
+        {
+            EmitTraceWrite(Output, Next);
+            ++Result;
+        }
+        ++NextCursor->WriteIndex;
+    }
+
+    return(Result);
+}
+
+// NOTE(chuck): Runs the program against a reference trace and stops at the first step that disagrees. Returns nonzero on any mismatch.
+static int CompareAgainstReference(output_buffer *Output, char *ReferenceFilename, program *Program)
+{
+    reference_trace *Reference = PushStruct(&OutputArena, reference_trace);
+    Reference->File = fopen(ReferenceFilename, "rb");
+    if(!Reference->File)
+    {
+        fprintf(stderr, "ERROR: Unable to open %s.\n", ReferenceFilename);
+        return(1);
+    }
+
+    int Result = 0;
+    char *Divergence = 0;
+    u64 StepIndex = 0;
+    int ReferenceHasIP = 0;
+    int AtFinal = 0;
+    int HaveLine = 0;
+    int HaveStep = 0;
+    u32 FinalIP = 0;
+    trace_record Record = {0};
+    u32 IPAfter = 0;
+    while(StepProgram(Program, &Record) && !Program->Stopped)
+    {
+        HaveStep = 1;
+        IPAfter = Program->IP;
+        FinalIP = IPAfter;
+
+        HaveLine = ReadReferenceStepLine(Reference, &AtFinal);
+        if(!HaveLine || AtFinal)
+        {
+            Divergence = "the reference stops here, but the simulation keeps going";
+            break;
+        }
+
+        reference_step Expected;
+        if(!ParseReferenceStep(Reference->Line, &Expected))
+        {
+            fprintf(stderr, "ERROR: %s(%llu): Not a step: %s\n", ReferenceFilename, Reference->LineNumber, Reference->Line);
+            fclose(Reference->File);
+            return(1);
+        }
+        ReferenceHasIP |= Expected.HasIP;
+
+        Divergence = CompareReferenceStep(&Expected, &Record, IPAfter);
+        if(Divergence)
+        {
+            break;
+        }
+
+        RememberReferenceLine(Reference);
+        ++StepIndex;
+    }
+
+    if(!Divergence)
+    {
+        HaveStep = 0;
+        HaveLine = ReadReferenceStepLine(Reference, &AtFinal);
+        if(HaveLine && !AtFinal)
+        {
+            Divergence = "the simulation stops here, but the reference keeps going";
+        }
+    }
+
+    if(Divergence)
+    {
+        Result = 1;
+        EmitFormat(Output, "DIVERGED at step %llu: %s.\n", StepIndex, Divergence);
+        EmitCompareContext(Output, Reference);
+        if(HaveLine && !AtFinal)
+        {
+            EmitFormat(Output, "expected  %8llu  %s\n", Reference->LineNumber, Reference->Line);
+        }
+        else
+        {
+            EmitFormat(Output, "expected            (end of steps)\n");
+        }
+
+        if(HaveStep)
+        {
+            // NOTE(chuck): Undo the step so that the state shown is the one the step started from.
+            cpu_state Before = CPUState;
+            if(Record.Flags & Trace_RegisterWrite)
+            {
+                if(Record.Register < TRACE_SEGMENT_REGISTER)
+                {
+                    Before.Registers[Record.Register] = Record.RegisterBefore;
+                }
+                else if(Record.Register < (TRACE_SEGMENT_REGISTER + 4))
+                {
+                    Before.SegmentRegisters[Record.Register - TRACE_SEGMENT_REGISTER] = Record.RegisterBefore;
+                }
+            }
+            Before.Flags = Record.FlagsBefore;
+
+            EmitFormat(Output, "actual    0x%08X  ", Record.IP);
+            // NOTE(chuck): Same text -exec would show for it. A jump with nowhere to put a label just loses its operand here.
+            int HitError = 0;
+            EmitOpText(Output, GetExecutableOp(Program, Record.IP, 0), Program->OpStream, Program->OpAtOffset, Program->ProgramLength, &HitError);
+            EmitBytes(Output, " ; ", 3);
+            EmitReferenceChanges(Output, &Record, IPAfter, ReferenceHasIP);
+            EmitBytes(Output, "\nbefore    ", 11);
+            EmitCompareState(Output, &Before);
+        }
+        else
+        {
+            EmitFormat(Output, "actual              (end of steps)\n");
+        }
+    }
+    else
+    {
+        // NOTE(chuck): Registers that are still zero don't get listed in the reference, so anything not listed has to be zero here.
+        cpu_state Expected = {0};
+        int HasIP = 0;
+        u32 ExpectedIP = 0;
+        while(ReadReferenceLine(Reference) && !IsBlankLine(Reference->Line))
+        {
+            char *Name = Reference->Line;
+            while(*Name == ' ')
+            {
+                ++Name;
+            }
+            char *Colon = strchr(Name, ':');
+            char *Value = Colon ? Colon + 1 : 0;
+            while(Value && (*Value == ' '))
+            {
+                ++Value;
+            }
+
+            int Register = Colon ? GetTraceRegisterIndex(Name, Colon - Name) : -1;
+            if(Colon && ((Colon - Name) == 5) && !strncmp(Name, "flags", 5))
+            {
+                Expected.Flags = (u16)ParseFlagLetters(Value, Value + strlen(Value));
+            }
+            else if(Colon && ((Colon - Name) == 2) && !strncmp(Name, "ip", 2))
+            {
+                HasIP = 1;
+                ExpectedIP = (u32)strtoul(Value, 0, 16);
+            }
+            else if(Register >= TRACE_SEGMENT_REGISTER)
+            {
+                Expected.SegmentRegisters[Register - TRACE_SEGMENT_REGISTER] = (u16)strtoul(Value, 0, 16);
+            }
+            else if(Register >= 0)
+            {
+                Expected.Registers[Register] = (u16)strtoul(Value, 0, 16);
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: %s(%llu): Not a final register: %s\n", ReferenceFilename, Reference->LineNumber, Reference->Line);
+                fclose(Reference->File);
+                return(1);
+            }
+        }
+
+        for(int Register = 0;
+            Register < (TRACE_SEGMENT_REGISTER + 4);
+            ++Register)
+        {
+            u16 Want = (Register < TRACE_SEGMENT_REGISTER) ? Expected.Registers[Register] : Expected.SegmentRegisters[Register - TRACE_SEGMENT_REGISTER];
+            u16 Got = (Register < TRACE_SEGMENT_REGISTER) ? CPUState.Registers[Register] : CPUState.SegmentRegisters[Register - TRACE_SEGMENT_REGISTER];
+            if(Want != Got)
+            {
+                EmitFormat(Output, "DIVERGED in the final registers: %s should be 0x%04X, but is 0x%04X.\n", GetTraceRegisterName((u8)Register), Want, Got);
+                Result = 1;
+            }
+        }
+        if(HasIP && (ExpectedIP != FinalIP))
+        {
+            EmitFormat(Output, "DIVERGED in the final registers: ip should be 0x%04X, but is 0x%04X.\n", ExpectedIP, FinalIP);
+            Result = 1;
+        }
+        if(Expected.Flags != CPUState.Flags)
+        {
+            EmitBytes(Output, "DIVERGED in the final registers: flags should be ", 49);
+            EmitFlags(Output, Expected.Flags);
+            EmitBytes(Output, ", but are ", 10);
+            EmitFlags(Output, CPUState.Flags);
+            EmitBytes(Output, ".\n", 2);
+            Result = 1;
+        }
+
+        if(!Result)
+        {
+            EmitFormat(Output, "MATCHED %llu steps and the final registers of %s.\n", StepIndex, ReferenceFilename);
+        }
+    }
+
+    fclose(Reference->File);
+    return(Result);
+}
+
+// NOTE(chuck): A register name, or a memory address in anything strtoul() takes.
+static int ParseTraceLocation(char *Text, u32 *Key, u32 *Address, size_t Length)
+{
+    int Result = 0;
+    int Register = GetTraceRegisterIndex(Text, Length);
+    if(Register >= 0)
+    {
+        *Key = *Address = (u32)Register;
+        Result = 1;
+    }
+    else if(Length && (Length < 32))
+    {
+        char Number[32];
+        memcpy(Number, Text, Length);
+        Number[Length] = 0;
+
+        char *End;
+        *Address = (u32)strtoul(Number, &End, 0);
+        *Key = TRACE_WRITE_FIRST_PAGE_KEY + (*Address >> TRACE_WRITE_PAGE_SHIFT);
+        Result = (*End == 0);
+    }
+    return(Result);
+}
+
+// NOTE(chuck): last <where> <step>               The last write to a register or address before a step.
+//              writes <where>[..<where>] [from] [to]  Every write to a register or range of memory, in step order.
+//              history <where> [from] [to]        Same as writes, for a single register or address.
+static int RunTraceQuery(output_buffer *Output, trace_store_reader *Store, int ArgCount, char **Args)
+{
+    int Result = 1;
+    char *Query = (ArgCount > 0) ? Args[0] : "";
+    char *Where = (ArgCount > 1) ? Args[1] : "";
+    char *Range = strstr(Where, "..");
+    size_t FirstLength = Range ? (size_t)(Range - Where) : strlen(Where);
+
+    u32 FirstKey, FirstAddress, LastKey, LastAddress;
+    int Parsed = ParseTraceLocation(Where, &FirstKey, &FirstAddress, FirstLength);
+    LastKey = FirstKey;
+    LastAddress = FirstAddress;
+    if(Parsed && Range)
+    {
+        Parsed = (ParseTraceLocation(Range + 2, &LastKey, &LastAddress, strlen(Range + 2)) &&
+                  ((FirstKey < TRACE_WRITE_FIRST_PAGE_KEY) == (LastKey < TRACE_WRITE_FIRST_PAGE_KEY)) &&
+                  (FirstAddress <= LastAddress));
+    }
+
+    int IsLast = !strcmp(Query, "last") && (ArgCount > 2) && !Range;
+    int IsWrites = !strcmp(Query, "writes") || (!strcmp(Query, "history") && !Range);
+    if((IsLast || IsWrites) && !Parsed)
+    {
+        fprintf(stderr, "ERROR: \"%s\" is not a register, address or range.\n", Where);
+    }
+    else if(IsLast)
+    {
+        u64 Step = strtoull(Args[2], 0, 10);
+        trace_write Write;
+        if(FindLastTraceWrite(Store, FirstKey, FirstAddress, Step, &Write))
+        {
+            EmitTraceWrite(Output, &Write);
+        }
+        else
+        {
+            EmitFormat(Output, "%s was not written before step %llu.\n", Where, Step);
+        }
+        Result = 0;
+    }
+    else if(IsWrites)
+    {
+        u64 FromStep = (ArgCount > 2) ? strtoull(Args[2], 0, 10) : 0;
+        u64 ToStep = (ArgCount > 3) ? strtoull(Args[3], 0, 10) : Store->Header.StepCount;
+        u64 WriteCount = EmitTraceWrites(Output, Store, FirstKey, LastKey, FirstAddress, LastAddress, FromStep, ToStep);
+        EmitFormat(Output, "%llu writes.\n", WriteCount);
+        Result = 0;
+    }
+    else
+    {
+        fprintf(stderr, "USAGE: -query-trace <trace store> last <register | address> <step>\n"
+                        "       -query-trace <trace store> writes <register | address>[..<register | address>] [from step] [to step]\n"
+                        "       -query-trace <trace store> history <register | address> [from step] [to step]\n");
+    }
+
+    return(Result);
+}
+
+int main(int ArgCount, char **Args)
+{
+    int Result = 0;
+    int HitError = 0;
+
+    // NOTE(chuck): -async[=block|drop|grow], -ring=<records> and -max-steps=<count> can go in front of -exec, -trace or -compare. Skip past them so the mode is always Args[1].
+    int Async = 0;
+    trace_full_policy FullPolicy = TraceFull_Block;
+    u32 RingCapacity = TRACE_RING_DEFAULT_CAPACITY;
+    u64 MaxSteps = DEFAULT_MAX_STEPS;
+    while(ArgCount > 2)
+    {
+        if(!strcmp(Args[1], "-async") || !strcmp(Args[1], "-async=block"))
+        {
+            Async = 1;
+            FullPolicy = TraceFull_Block;
+        }
+        else if(!strcmp(Args[1], "-async=drop"))
+        {
+            Async = 1;
+            FullPolicy = TraceFull_Drop;
+        }
+        else if(!strcmp(Args[1], "-async=grow"))
+        {
+            Async = 1;
+            FullPolicy = TraceFull_Grow;
+        }
+        else if(!strncmp(Args[1], "-ring=", 6))
+        {
+            RingCapacity = (u32)atoi(Args[1] + 6);
+            if(RingCapacity < 1)
+            {
+                RingCapacity = 1;
+            }
+        }
+        else if(!strncmp(Args[1], "-max-steps=", 11))
+        {
+            MaxSteps = strtoull(Args[1] + 11, 0, 10);
+            if(!MaxSteps)
+            {
+                MaxSteps = ~(u64)0;
+            }
+        }
+        else
+        {
+            break;
+        }
+        ++Args;
+        --ArgCount;
+    }
+
+    char *Filename = Args[1];
+
+    output_buffer Output = {0};
+    Output.Capacity = Megabytes(1);
+    Output.Base = PushArray(&OutputArena, char, Output.Capacity);
+    Output.File = stdout;
+
+    // NOTE(chuck): -trace runs the program and writes a binary trace instead of any text, and -trace-store does the same into a packed, indexed trace store. -print-trace turns either one back into exactly what -exec would have printed. -seek-trace jumps into a trace store at a step (or the first time an IP was hit) and prints the records from there. -compare runs the program against a reference listing trace. -query-trace looks up register and memory writes in a trace store. -fold-trace prints either kind of trace with its loops folded up.
+    int Exec = 0;
+    output_format Format = Format_ASM;
+    int WriteTrace = 0;
+    int PackTrace = 0;
+    int ReadTrace = 0;
+    int SeekTrace = 0;
+    char *SeekTo = 0;
+    int SeekCount = 16;
+    int QueryTrace = 0;
+    int FoldTrace = 0;
+    char *TraceFilename = 0;
+    char *ReferenceFilename = 0;
+    if(!strcmp(Args[1], "-exec"))
+    {
+        Exec = 1;
+        Filename = Args[2];
+        EmitFormat(&Output, "--- %s ---\n", Filename);
+    }
+    else if(!strcmp(Args[1], "-trace") || !strcmp(Args[1], "-trace-store"))
+    {
+        Exec = 1;
+        WriteTrace = 1;
+        PackTrace = !strcmp(Args[1], "-trace-store");
+        TraceFilename = Args[2];
+        Filename = Args[3];
+    }
+    else if(!strcmp(Args[1], "--format=jsonl") || !strcmp(Args[1], "--format=csv"))
+    {
+        Format = !strcmp(Args[1], "--format=jsonl") ? Format_JSONL : Format_CSV;
+        Filename = Args[2];
+    }
+    else if(!strcmp(Args[1], "-print-trace"))
+    {
+        Exec = 1;
+        ReadTrace = 1;
+        TraceFilename = Args[2];
+        Filename = Args[2];
+    }
+    else if(!strcmp(Args[1], "-fold-trace"))
+    {
+        Exec = 1;
+        ReadTrace = 1;
+        FoldTrace = 1;
+        TraceFilename = Args[2];
+        Filename = Args[2];
+    }
+    else if(!strcmp(Args[1], "-query-trace"))
+    {
+        Exec = 1;
+        ReadTrace = 1;
+        QueryTrace = 1;
+        TraceFilename = Args[2];
+        Filename = Args[2];
+    }
+    else if(!strcmp(Args[1], "-compare"))
+    {
+        ReferenceFilename = Args[2];
+        Filename = Args[3];
+    }
+    else if(!strcmp(Args[1], "-seek-trace"))
+    {
+        if(ArgCount < 4)
+        {
+            fprintf(stderr, "USAGE: %s -seek-trace <trace store> <step | ip=<hex offset>> [count]\n", Args[0]);
+            return(1);
+        }
+
+        Exec = 1;
+        ReadTrace = 1;
+        SeekTrace = 1;
+        TraceFilename = Args[2];
+        Filename = Args[2];
+        SeekTo = Args[3];
+        if(ArgCount > 4)
+        {
+            SeekCount = atoi(Args[4]);
+        }
+    }
+
+    if(!BuildOpDispatch())
+    {
+        FlushOutput(&Output);
+        return(1);
+    }
+
+    FILE *File = fopen(Filename, "rb");
+    if(!File)
+    {
+        FlushOutput(&Output);
+        fprintf(stderr, "ERROR: Unable to open %s.\n", Filename);
+        return(1);
+    }
+
+    size_t ByteLength = 0;
+    FILE *TraceFile = 0;
+    int UseTraceStore = 0;
+    trace_store_header StoreHeader = {0};
+    u32 Magic = 0;
+    if(ReadTrace)
+    {
+        fread(&Magic, sizeof(Magic), 1, File);
+        fseek(File, 0, SEEK_SET);
+    }
+
+    if(ReadTrace && (Magic == TRACE_STORE_MAGIC))
+    {
+        TraceFile = File;
+        UseTraceStore = 1;
+
+        char TraceProgramName[1024] = {0};
+        if((fread(&StoreHeader, sizeof(StoreHeader), 1, TraceFile) != 1) ||
+           (StoreHeader.Version != TRACE_STORE_VERSION) ||
+           (StoreHeader.FileNameLength >= sizeof(TraceProgramName)) ||
+           (fread(TraceProgramName, 1, StoreHeader.FileNameLength, TraceFile) != StoreHeader.FileNameLength))
+        {
+            FlushOutput(&Output);
+            fprintf(stderr, "ERROR: %s is not a trace store from this version of the simulator.\n", TraceFilename);
+            return(1);
+        }
+
+        EmitFormat(&Output, "--- %s ---\n", TraceProgramName);
+        ByteLength = StoreHeader.ProgramLength;
+    }
+    else if(SeekTrace || QueryTrace)
+    {
+        FlushOutput(&Output);
+        fprintf(stderr, "ERROR: %s is not a trace store. Only -trace-store output can be searched.\n", TraceFilename);
+        return(1);
+    }
+    else if(ReadTrace)
+    {
+        TraceFile = File;
+
+        trace_header Header = {0};
+        char TraceProgramName[1024] = {0};
+        if((fread(&Header, sizeof(Header), 1, TraceFile) != 1) ||
+           (Header.Magic != TRACE_MAGIC) ||
+           (Header.Version != TRACE_VERSION) ||
+           (Header.RecordSize != sizeof(trace_record)) ||
+           (Header.FileNameLength >= sizeof(TraceProgramName)) ||
+           (fread(TraceProgramName, 1, Header.FileNameLength, TraceFile) != Header.FileNameLength))
+        {
+            FlushOutput(&Output);
+            fprintf(stderr, "ERROR: %s is not a trace from this version of the simulator.\n", TraceFilename);
+            return(1);
+        }
+
+        EmitFormat(&Output, "--- %s ---\n", TraceProgramName);
+        ByteLength = Header.ProgramLength;
+    }
+    else
+    {
+        fseek(File, 0, SEEK_END);
+        ByteLength = (size_t)ftell(File);
+        fseek(File, 0, SEEK_SET);
+    }
+
+    // NOTE(chuck): The decoders peek a few bytes past the current op without checking, so leave some zeroes past the end of the data.
+    u8 *OpStream = PushArray(&OpStreamArena, u8, ByteLength + 16);
+    ByteLength = fread(OpStream, 1, ByteLength, File);
+    if(!ReadTrace)
+    {
+        fclose(File);
+    }
+
+    u8 *EndOfData = OpStream + ByteLength;
+    parsing_context Context = {OpStream, OpStream};
+    op *PreviousOp = 0;
+    while(Context.IP < EndOfData)
+    {
+        op Op = DecodeOp(&Context);
+        ApplyPrefix(PreviousOp, &Op);
+
+        PreviousOp = PushStruct(&OpListArena, op);
+        *PreviousOp = Op;
+        ++OpCount;
+
+        Assert(Op.ByteLength);
+        Context.IP += Op.ByteLength;
+    }
+
+    op *OpList = (op *)OpListArena.Base;
+
+    // NOTE(chuck): The program is loaded at the bottom of memory, with every segment register at zero, so offsets into the program are also its addresses.
+    Memory = PushArray(&MemoryArena, u8, MEMORY_SIZE);
+    memcpy(Memory, OpStream, (ByteLength < (size_t)MEMORY_SIZE) ? ByteLength : (size_t)MEMORY_SIZE);
+
+    // NOTE(chuck): Map every byte offset in the stream to the op that starts there (if any), so that resolving a jump (or a traced IP) is a single lookup instead of a search over every op.
+    op **OpAtOffset = PushArray(&OpIndexArena, op *, ByteLength + 1);
+    memset(OpAtOffset, 0, (ByteLength + 1)*sizeof(op *));
+    for(int OpIndex = 0;
+        OpIndex < OpCount;
+        ++OpIndex)
+    {
+        op *Op = &OpList[OpIndex];
+        OpAtOffset[Op->IP - OpStream] = Op;
+    }
+
+    // NOTE(chuck): Labels get settled before anything runs, so that a -compare report names jump targets the same way the listing does.
+    for(int OpIndex = 0;
+        OpIndex < OpCount;
+        ++OpIndex)
+    {
+        op *Op = &OpList[OpIndex];
+        if(Op->IsRelativeJump)
+        {
+            op *Target = GetJumpTarget(Op, OpStream, OpAtOffset, ByteLength);
+            if(Target)
+            {
+                Target->IsJumpTarget = 1;
+            }
+        }
+    }
+
+    // NOTE(chuck): Number the labels in stream order, now that all of the targets are known.
+    int LabelCount = 0;
+    for(int OpIndex = 0;
+        OpIndex < OpCount;
+        ++OpIndex)
+    {
+        op *Op = &OpList[OpIndex];
+        if(Op->IsJumpTarget)
+        {
+            Op->JumpTargetIndex = LabelCount++;
+        }
+    }
+
+    program Program;
+    InitProgram(&Program, OpStream, (u32)ByteLength, OpAtOffset);
+    Program.StepsLeft = MaxSteps;
+
+    if(ReferenceFilename)
+    {
+        Result = CompareAgainstReference(&Output, ReferenceFilename, &Program);
+        ReportStepLimit(&Program, MaxSteps);
+        FlushOutput(&Output);
+        return(Result);
+    }
+
+    if(WriteTrace)
+    {
+        output_buffer Trace = {0};
+        trace_store_writer Store;
+        if(PackTrace)
+        {
+            if(!BeginTraceStore(&Store, TraceFilename, Filename, OpStream, (u32)ByteLength, OpAtOffset))
+            {
+                fprintf(stderr, "ERROR: Unable to open %s.\n", TraceFilename);
+                return(1);
+            }
+        }
+        else
+        {
+            Trace.Capacity = Megabytes(1);
+            Trace.Base = PushArray(&OutputArena, char, Trace.Capacity);
+            Trace.File = fopen(TraceFilename, "wb");
+            if(!Trace.File)
+            {
+                fprintf(stderr, "ERROR: Unable to open %s.\n", TraceFilename);
+                return(1);
+            }
+
+            trace_header Header = {TRACE_MAGIC, TRACE_VERSION, sizeof(trace_record), (u32)strlen(Filename), (u32)ByteLength};
+            EmitBytes(&Trace, (char *)&Header, sizeof(Header));
+            EmitBytes(&Trace, Filename, Header.FileNameLength);
+            EmitBytes(&Trace, (char *)OpStream, ByteLength);
+        }
+
+        // NOTE(chuck): Same ops that -exec runs, with no text at all.
+        if(Async)
+        {
+            trace_ring Ring;
+            InitTraceRing(&Ring, RingCapacity, FullPolicy);
+            simulation_work Work = {&Program, &Ring};
+            HANDLE Simulation = CreateThread(0, 0, SimulationThread, &Work, 0, 0);
+
+            trace_record Record;
+            while(PopTraceRecord(&Ring, &Record))
+            {
+                if(PackTrace)
+                {
+                    AddTraceStoreRecord(&Store, &Record);
                 }
                 else
                 {
-                    if(Op->IsFar)
-                    {
-                        LinePointer += sprintf(LinePointer, "far ");
-                    }
+                    EmitBytes(&Trace, (char *)&Record, sizeof(Record));
+                }
+            }
 
-                    // NOTE(chuck): Don't bother with tracking which side. Just blast it on the left.
-                    if(Op->EmitSize)
-                    {
-                        LinePointer += sprintf(LinePointer, Op->Word ? "word " : "byte ");
-                    }
-                    LinePointer += PrintParam(LinePointer, Op, &Op->Param[0]);
+            WaitForSingleObject(Simulation, INFINITE);
+            CloseHandle(Simulation);
+            ReportDroppedTraceRecords(&Ring);
+        }
+
+        else
+        {
+            trace_record Record;
+            while(StepProgram(&Program, &Record))
+            {
+                if(PackTrace)
+                {
+                    AddTraceStoreRecord(&Store, &Record);
+                }
+                else
+                {
+                    EmitBytes(&Trace, (char *)&Record, sizeof(Record));
                 }
             }
+        }
 
-            if(Op->ParamCount > 1)
+        if(Program.Stopped)
+        {
+            Result = 1;
+        }
+        ReportStepLimit(&Program, MaxSteps);
+
+        if(PackTrace)
+        {
+            if(!EndTraceStore(&Store, Filename))
             {
-                LinePointer += sprintf(LinePointer, ", ");
-                LinePointer += PrintParam(LinePointer, Op, &Op->Param[1]);
+                fprintf(stderr, "ERROR: Unable to write %s.\n", TraceFilename);
+                Result = 1;
             }
+        }
+        else
+        {
+            FlushOutput(&Trace);
+            fclose(Trace.File);
+        }
+
+        return(Result);
+    }
+
+    if(Format != Format_ASM)
+    {
+        if(Format == Format_CSV)
+        {
+            EmitCSVHeader(&Output);
+        }
 
-            if(HitError)
+        u8 *Start = 0;
+        int Flags = 0;
+        int SegmentOverride = 0;
+        for(int OpIndex = 0;
+            OpIndex < OpCount;
+            ++OpIndex)
+        {
+            op *Op = &OpList[OpIndex];
+            if(!Start)
             {
-                Line[0] = ';';
+                Start = Op->IP;
             }
 
-            if(IsPrefix(Op))
+            if(Op->Error)
             {
-                printf("%s", Line);
+                Result = 1;
             }
-            else
+
+            if(!Op->Error && IsPrefix(Op))
             {
-                // TODO(chuck): This is fudgeville!
-                if((OpIndex > 0) && IsPrefix(&OpList[OpIndex - 1]))
+                if(Op->NameIndex == OP_NAME_LOCK)
+                {
+                    Flags |= INSTRUCTION_FLAG_LOCK;
+                }
+                else if(Op->NameIndex == OP_NAME_REP)
                 {
-                    printf("%-34s", Line);
+                    Flags |= INSTRUCTION_FLAG_REP;
                 }
                 else
                 {
-                    printf("%-40s", Line);
+                    Flags |= INSTRUCTION_FLAG_SEGMENT;
+                    SegmentOverride = Op->SegmentOverride;
                 }
             }
-
-            if(!IsPrefix(Op))
+            else
             {
-                char OpBytes[1024] = {0};
-                char *OpBytesPointer = OpBytes;
-                unsigned char *IP = Op->IP;
-                int ByteLength = Op->ByteLength;
+                EmitStructuredOp(&Output, Format, Op, OpStream, Start, Flags, SegmentOverride);
+                Start = 0;
+                Flags = 0;
+            }
+        }
 
-                // TODO(chuck): This is fudgeville!
-                if((OpIndex > 0) && IsPrefix(&OpList[OpIndex - 1]))
-                {
-                    IP = OpList[OpIndex - 1].IP;
-                    ++ByteLength;
-                }
+        // NOTE(chuck): A prefix at the very end of the stream has nothing to attach to, so it goes out by itself.
+        if(Start)
+        {
+            EmitStructuredOp(&Output, Format, &OpList[OpCount - 1], OpStream, Start, Flags, SegmentOverride);
+        }
 
-                for(int OpByteIndex = 0;
-                    OpByteIndex < ByteLength;
-                    ++OpByteIndex)
-                {
-                    int BytesWritten = sprintf(OpBytesPointer, " %02X", IP[OpByteIndex]);
-                    OpBytesPointer += BytesWritten;
-                    __int64 EmitLength = (OpBytesPointer - OpBytes);
-                    int OpBytesLength = ArrayLength(OpBytes);
-                    Assert(EmitLength < OpBytesLength);
-                }
-                sprintf(Temp, "; 0x%08llX:%s", (IP - OpStream), OpBytes);
-                printf("%-30s", Temp);
+        FlushOutput(&Output);
 
-                if(Exec)
-                {
-                    char Exec[1024] = {0};
-                    char *E = Exec;
-                    E += sprintf(E, "  [exec] ");
+        return(Result);
+    }
 
-                    op_param *Source = 0;
-                    op_param *Dest = 0;
-                    char *DestName = 0;
-                    u16 FlagsBefore = CPUState.Flags;
+    trace_store_reader Store;
+    if(UseTraceStore && !OpenTraceStore(&Store, TraceFile, &StoreHeader, OpAtOffset))
+    {
+        FlushOutput(&Output);
+        fprintf(stderr, "ERROR: The index in %s is damaged.\n", TraceFilename);
+        return(1);
+    }
 
-                    u16 SourceValue = 0xcccc;
-                    if(Op->ParamCount >= SOURCE)
-                    {
-                        Source = &Op->Param[SOURCE];
+    if(FoldTrace)
+    {
+        trace_folder *Folder = PushStruct(&OutputArena, trace_folder);
+        BeginTraceFolder(Folder, &Output, OpAtOffset, (u32)ByteLength);
 
-                        if(Source->Type == Param_Immediate)
-                        {
-                            SourceValue = (u16)Source->ImmediateValue;
-                        }
-                        else if(Source->Type == Param_Register)
-                        {
-                            if(Source->RegisterOrMemoryIndex < 8)
-                            {
-                                if(Source->RegisterOrMemoryIndex < 4)
-                                {
-                                    SourceValue = CPUState.Registers[Source->RegisterOrMemoryIndex];
-                                }
-                                else
-                                {
-                                    SourceValue = CPUState.Registers[Source->RegisterOrMemoryIndex - 4] >> 8;
-                                }
-                            }
-                            else
-                            {
-                                SourceValue = CPUState.Registers[Source->RegisterOrMemoryIndex - 8];
-                            }
-                        }
-                        else if(Source->Type == Param_SegmentRegister)
-                        {
-                            SourceValue = CPUState.SegmentRegisters[Source->RegisterOrMemoryIndex];
-                        }
-                    }
+        trace_record Record;
+        while(UseTraceStore ? ReadTraceStoreRecord(&Store, &Record) : (fread(&Record, sizeof(Record), 1, TraceFile) == 1))
+        {
+            AddFoldStep(Folder, &Record);
+        }
+        EndTraceFolder(Folder);
 
-                    u16 DestValue = 0xcccc;
-                    if(Op->ParamCount >= DESTINATION)
-                    {
-                        Dest = &Op->Param[DESTINATION];
+        FlushOutput(&Output);
+        fclose(TraceFile);
+        return(Result);
+    }
 
-                        int DestRegisterIndex = 0xcccc;
-                        if(Dest->Type == Param_Register)
-                        {
-                            int DestRegisterIndex = Dest->RegisterOrMemoryIndex;
-
-                            if(DestRegisterIndex < 8)
-                            {
-                                if(DestRegisterIndex < 4)
-                                {
-                                    DestValue = CPUState.Registers[DestRegisterIndex];
-                                    DestName  = RegisterLookup[8 + DestRegisterIndex];
-                                }
-                                else
-                                {
-                                    DestRegisterIndex -= 4;
-                                    DestValue = CPUState.Registers[DestRegisterIndex];
-                                    DestName  = RegisterLookup[8 + DestRegisterIndex];
-                                }
-                            }
-                            else
-                            {
-                                DestName = RegisterLookup[DestRegisterIndex];
-                                DestRegisterIndex -= 8;
-                                DestValue = CPUState.Registers[DestRegisterIndex];
-                            }
-                        }
-                        else if(Dest->Type == Param_SegmentRegister)
-                        {
-                            DestName  = SegmentRegisterLookup[Dest->RegisterOrMemoryIndex];
-                            DestValue = CPUState.SegmentRegisters[Dest->RegisterOrMemoryIndex];
-                        }
-                    }
+    if(QueryTrace)
+    {
+        Result = RunTraceQuery(&Output, &Store, ArgCount - 3, Args + 3);
+        FlushOutput(&Output);
+        fclose(TraceFile);
+        return(Result);
+    }
 
-                    if(Op->NameIndex == OP_NAME_MOV)
-                    {
-                        u16 DestValueAfter  = 0xcccc;
-                        u16 DestValueBefore = DestValue;
+    if(SeekTrace)
+    {
+        u64 Step = 0;
+        int Found = 1;
+        if(!strncmp(SeekTo, "ip=", 3))
+        {
+            Found = FindFirstStepAtIP(&Store, (u32)strtoul(SeekTo + 3, 0, 16), &Step);
+        }
+        else
+        {
+            Step = strtoull(SeekTo, 0, 10);
+        }
 
-                        if(Dest->Type == Param_Register)
-                        {
-                            int DestRegisterIndex = Dest->RegisterOrMemoryIndex;
-                            if(DestRegisterIndex < 8)
-                            {
-                                if(DestRegisterIndex < 4)
-                                {
-                                    DestName = RegisterLookup[8 + DestRegisterIndex];
-                                    u16 NewValue  = (CPUState.Registers[DestRegisterIndex] & 0xff00);
-                                        NewValue |= (SourceValue & 0xff);
-                                    CPUState.Registers[DestRegisterIndex] = NewValue;
-                                }
-                                else
-                                {
-                                    DestRegisterIndex -= 4;
-                                    DestName = RegisterLookup[8 + DestRegisterIndex];
-                                    u16 NewValue  = (CPUState.Registers[DestRegisterIndex] & 0x00ff);
-                                        NewValue |= ((SourceValue & 0xff) << 8);
-                                    CPUState.Registers[DestRegisterIndex] = NewValue;
-                                }
-                            }
-                            else
-                            {
-                                DestName = RegisterLookup[DestRegisterIndex];
-                                DestRegisterIndex -= 8;
-                                CPUState.Registers[DestRegisterIndex] = (SourceValue & 0xffff);
-                            }
-
-                            DestValueAfter = CPUState.Registers[DestRegisterIndex];
-                        }
-                        else if(Dest->Type == Param_SegmentRegister)
-                        {
-                            DestName = SegmentRegisterLookup[Dest->RegisterOrMemoryIndex];
-                            DestValueAfter = CPUState.SegmentRegisters[Dest->RegisterOrMemoryIndex] = (SourceValue & 0xffff);
-                        }
+        if(!Found || !SeekTraceStore(&Store, Step))
+        {
+            FlushOutput(&Output);
+            fprintf(stderr, "ERROR: %s has no step at %s (%llu steps in all).\n", TraceFilename, SeekTo, StoreHeader.StepCount);
+            return(1);
+        }
 
-                        E += sprintf(E, "%s:0x%04X->0x%04X", DestName, DestValueBefore, DestValueAfter);
-                    }
-                    else if((Op->NameIndex == OP_NAME_SUB) ||
-                            (Op->NameIndex == OP_NAME_CMP) ||
-                            (Op->NameIndex == OP_NAME_ADD))
-                    {
-                        int IsAdd = (Op->NameIndex == OP_NAME_ADD);
-                        int IsSub = (Op->NameIndex == OP_NAME_SUB);
-                        int IsCmp = (Op->NameIndex == OP_NAME_CMP);
-                        u16 DestValueBefore = DestValue;
-                        u16 ComputedValue = 0xcccc;
-                        u16 *DestRegister = 0;
-
-                        if(Dest->Type == Param_Register)
-                        {
-                            int DestRegisterIndex = Dest->RegisterOrMemoryIndex;
-                            if(DestRegisterIndex < 8)
-                            {
-                                if(DestRegisterIndex < 4)
-                                {
-                                    DestName = RegisterLookup[8 + DestRegisterIndex];
-                                    DestRegister = &CPUState.Registers[DestRegisterIndex];
-                                    ComputedValue = *DestRegister;
-                                    if(IsAdd)
-                                    {
-                                        ComputedValue += (SourceValue & 0xff);
-                                    }
-                                    else
-                                    {
-                                        ComputedValue -= (SourceValue & 0xff);
-                                    }
-                                }
-                                else
-                                {
-                                    DestRegisterIndex -= 4;
-                                    DestName = RegisterLookup[8 + DestRegisterIndex];
-                                    DestRegister = &CPUState.Registers[DestRegisterIndex];
-                                    ComputedValue = *DestRegister;
-                                    if(IsAdd)
-                                    {
-                                        ComputedValue += ((SourceValue & 0xff) << 8);
-                                    }
-                                    else
-                                    {
-                                        ComputedValue -= ((SourceValue & 0xff) << 8);
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                DestName = RegisterLookup[DestRegisterIndex];
-                                DestRegisterIndex -= 8;
-                                DestRegister = &CPUState.Registers[DestRegisterIndex];
-                                ComputedValue = *DestRegister;
-                                if(IsAdd)
-                                {
-                                    ComputedValue += (SourceValue & 0xffff);
-                                }
-                                else
-                                {
-                                    ComputedValue -= (SourceValue & 0xffff);
-                                }
-                            }
-                        }
-                        else if(Dest->Type == Param_SegmentRegister)
-                        {
-                            DestName = SegmentRegisterLookup[Dest->RegisterOrMemoryIndex];
-                            DestRegister = &CPUState.SegmentRegisters[Dest->RegisterOrMemoryIndex];
-                            ComputedValue = *DestRegister;
-                            if(IsAdd)
-                            {
-                                ComputedValue += SourceValue;
-                            }
-                            else
-                            {
-                                ComputedValue -= SourceValue;
-                            }
-                        }
+        trace_record Record;
+        for(int RecordIndex = 0;
+            (RecordIndex < SeekCount) && ReadTraceStoreRecord(&Store, &Record);
+            ++RecordIndex)
+        {
+            EmitTraceStep(&Output, Store.Step - 1, &Record, OpAtOffset, (u32)ByteLength);
+        }
 
-                        if(!IsCmp)
-                        {
-                            *DestRegister = ComputedValue;
-                            E += sprintf(E, "%s:0x%04X->0x%04X ", DestName, DestValueBefore, ComputedValue);
-                        }
+        FlushOutput(&Output);
+        fclose(TraceFile);
+        return(Result);
+    }
 
-                        CPUState.Flags = SetFlags(FlagsBefore, ComputedValue);
-                        if(CPUState.Flags != FlagsBefore)
-                        {
-                            E += sprintf(E, "flags: ");
-                            E += PrintFlags(E, FlagsBefore);
-                            E += sprintf(E, "->");
-                            E += PrintFlags(E, CPUState.Flags);
-                        }
-                    }
+    EmitString(&Output, "bits 16\n");
 
-                    printf("%s", Exec);
-                }
+    // NOTE(chuck): With -async, the simulation races ahead on its own thread and the steps below get printed from its records as they come in.
+    trace_ring Ring;
+    simulation_work Work = {&Program, &Ring};
+    HANDLE Simulation = 0;
+    if(Exec && Async && !ReadTrace)
+    {
+        InitTraceRing(&Ring, RingCapacity, FullPolicy);
+        Simulation = CreateThread(0, 0, SimulationThread, &Work, 0, 0);
+    }
+
+    if(!Exec)
+    {
+        for(int OpIndex = 0;
+            OpIndex < OpCount;
+            ++OpIndex)
+        {
+            op *Op = &OpList[OpIndex];
+            op *PreviousOp = (OpIndex > 0) ? &OpList[OpIndex - 1] : 0;
+            if(EmitListingOp(&Output, Op, PreviousOp, OpStream, OpAtOffset, ByteLength, &HitError))
+            {
+                EmitChar(&Output, '\n');
+            }
+
+            if(Op->Error)
+            {
+                Result = 1;
+            }
+        }
+    }
+    else if(ReadTrace)
+    {
+        trace_record Record;
+        while(UseTraceStore ? ReadTraceStoreRecord(&Store, &Record) : (fread(&Record, sizeof(Record), 1, TraceFile) == 1))
+        {
+            if(Record.IP >= ByteLength)
+            {
+                FlushOutput(&Output);
+                fprintf(stderr, "\nERROR: %s does not match the program at 0x%08X.\n", TraceFilename, Record.IP);
+                return(1);
+            }
 
-                printf("\n");
+            ApplyTraceRecord(&CPUState, &Record);
+            if(!EmitExecutedStep(&Output, &Program, OpList, &Record, &HitError))
+            {
+                Result = 1;
             }
         }
     }
+    else if(Async)
+    {
+        // NOTE(chuck): Records that were dropped just never show up. ReportDroppedTraceRecords() says how many there were.
+        trace_record Record;
+        while(PopTraceRecord(&Ring, &Record))
+        {
+            EmitExecutedStep(&Output, &Program, OpList, &Record, &HitError);
+        }
+    }
+    else
+    {
+        trace_record Record;
+        while(StepProgram(&Program, &Record))
+        {
+            EmitExecutedStep(&Output, &Program, OpList, &Record, &HitError);
+        }
+    }
+
+    if(Simulation)
+    {
+        WaitForSingleObject(Simulation, INFINITE);
+        CloseHandle(Simulation);
+        ReportDroppedTraceRecords(&Ring);
+    }
+
+    if(Program.Stopped)
+    {
+        Result = 1;
+    }
+    if(!ReadTrace)
+    {
+        ReportStepLimit(&Program, MaxSteps);
+    }
 
     if(Exec)
     {
-        printf("\nFinal registers:\n");
+        EmitString(&Output, "\nFinal registers:\n");
         int DisplayOrder[8] = {0, 3, 1, 2, 4, 5, 6, 7};
         for(int RegisterIndex = 0;
             RegisterIndex < 8;
@@ -1851,22 +5421,29 @@ int main(int ArgCount, char **Args)
         {
             int DisplayRegisterIndex = DisplayOrder[RegisterIndex];
             u16 Value = CPUState.Registers[DisplayRegisterIndex];
-            printf("      %s: 0x%04X (%d)\n", RegisterLookup[8 + DisplayRegisterIndex], Value, Value);
+            EmitFormat(&Output, "      %s: 0x%04X (%d)\n", RegisterLookup[8 + DisplayRegisterIndex], Value, Value);
         }
 
-        printf("\n");
+        EmitChar(&Output, '\n');
         for(int SegmentRegisterIndex = 0;
             SegmentRegisterIndex < 4;
             ++SegmentRegisterIndex)
         {
             u16 Value = CPUState.SegmentRegisters[SegmentRegisterIndex];
-            printf("      %s: 0x%04X (%d)\n", SegmentRegisterLookup[SegmentRegisterIndex], Value, Value);
+            EmitFormat(&Output, "      %s: 0x%04X (%d)\n", SegmentRegisterLookup[SegmentRegisterIndex], Value, Value);
         }
 
         char *T = Temp;
         T += sprintf(T, "   flags: ");
         T += PrintFlags(T, CPUState.Flags);
-        printf("%s\n", Temp);
+        EmitString(&Output, Temp);
+        EmitChar(&Output, '\n');
+    }
+
+    FlushOutput(&Output);
+    if(TraceFile)
+    {
+        fclose(TraceFile);
     }
 
     return(Result);
@@ -1,11 +1,42 @@
 typedef unsigned char u8;
 typedef unsigned short u16;
+typedef unsigned int u32;
+typedef unsigned __int64 u64;
 typedef char s8;
 typedef short s16;
 
 #define Assert(Condition) if(!(Condition)) { __debugbreak(); }
 #define ArrayLength(A) (sizeof(A) / sizeof((A)[0]))
 
+#define Kilobytes(Value) ((Value)*1024LL)
+#define Megabytes(Value) (Kilobytes(Value)*1024LL)
+#define Gigabytes(Value) (Megabytes(Value)*1024LL)
+
+// NOTE(chuck): Each arena is one big address space reservation that gets committed as it fills up, so
+// anything pushed into it stays contiguous and never moves. That lets the arena double as a growable array.
+#define ARENA_RESERVE_SIZE Gigabytes(4)
+#define ARENA_COMMIT_SIZE Megabytes(1)
+typedef struct
+{
+    u8 *Base;
+    size_t Reserved;
+    size_t Committed;
+    size_t Used;
+} arena;
+
+// NOTE(chuck): Everything that goes to stdout is assembled here and written out in large blocks.
+#define MAX_LINE_LENGTH 1024
+typedef struct
+{
+    char *Base;
+    size_t Capacity;
+    size_t Used;
+    FILE *File;
+} output_buffer;
+
+#define PushArray(Arena, Type, Count) (Type *)PushSize((Arena), sizeof(Type)*(Count))
+#define PushStruct(Arena, Type) PushArray(Arena, Type, 1)
+
 #define MEMORY_MODE_MAYBE_NO_DISPLACEMENT 0x00
 #define MEMORY_MODE_8BIT_DISPLACEMENT     0x01
 #define MEMORY_MODE_16BIT_DISPLACEMENT    0x02
@@ -338,9 +369,408 @@ typedef struct
     options DecodeOptions;
 } op_definition;
 
+/* NOTE(chuck): Execution follows IP, so it goes wherever the jumps send it instead of down the listing. OpAtOffset is built once, straight from the linear decode, so finding the op at a taken branch is a single lookup. A branch that lands somewhere the linear decode never started an op (the middle of another op, usually) gets decoded right there and remembered in DecodedAtOffset.
+
+   Only the thread doing the executing touches DecodedAtOffset and IP. Everyone else sticks to OpAtOffset, which never changes after the decode, so the trace store writer and reader always agree on it. */
+#define DEFAULT_MAX_STEPS 10000000 // NOTE(chuck): Plenty for any of the listings to finish, but a program that loops forever still stops. -max-steps=0 means no limit at all.
+typedef struct
+{
+    u8 *OpStream;
+    u32 ProgramLength;
+    op **OpAtOffset;
+    op **DecodedAtOffset;
+
+    u32 IP;
+    u64 StepsLeft;
+    int Stopped; // NOTE(chuck): Execution ran into bytes that aren't an op. Its last record is for those bytes.
+} program;
+
+// NOTE(chuck): Besides NASM text, disassembly can come out as one JSON object per line or one CSV row per instruction, built straight from the op fields so nothing downstream has to parse assembly.
+typedef enum
+{
+    Format_ASM,
+    Format_JSONL,
+    Format_CSV,
+} output_format;
+
+// NOTE(chuck): Prefixes are ops of their own here, but structured output folds them into the instruction they belong to as flags.
+#define INSTRUCTION_FLAG_LOCK    (1 << 0)
+#define INSTRUCTION_FLAG_REP     (1 << 1)
+#define INSTRUCTION_FLAG_SEGMENT (1 << 2)
+#define INSTRUCTION_FLAG_WIDE    (1 << 3)
+#define INSTRUCTION_FLAG_FAR     (1 << 4)
+static char *InstructionFlagNames[] =
+{
+    "lock",
+    "rep",
+    "segment",
+    "wide",
+    "far",
+};
+
+static char *EffectiveAddressTerms[8][2] =
+{
+    {"bx", "si"},
+    {"bx", "di"},
+    {"bp", "si"},
+    {"bp", "di"},
+    {"si", ""},
+    {"di", ""},
+    {"bp", ""},
+    {"bx", ""},
+};
+
+// NOTE(chuck): A binary trace is a trace_header, the file name, the program bytes, and then one fixed-size trace_record per executed op until the end of the file. The program is carried along so that -print-trace can rebuild the -exec text without needing the original file.
+#define TRACE_MAGIC 0x54363853 // NOTE(chuck): "S86T"
+#define TRACE_VERSION 1
 typedef struct
 {
-    op *Op;
-    __int64 Offset;
-} jump;
+    u32 Magic;
+    u32 Version;
+    u32 RecordSize;
+    u32 FileNameLength;
+    u32 ProgramLength;
+} trace_header;
+
+#define TRACE_NO_REGISTER 0xff
+#define TRACE_SEGMENT_REGISTER 8 // NOTE(chuck): Register 0-7 are the 16-bit general registers, 8-11 are the segment registers.
+typedef enum
+{
+    Trace_RegisterWrite = (1 << 0),
+    Trace_MemoryWrite = (1 << 1),
+} trace_flags;
+
+typedef struct
+{
+    u32 IP;
+    u16 NameIndex;
+    u8 Register;
+    u8 Flags;
+    u16 RegisterBefore;
+    u16 RegisterAfter;
+    u16 FlagsBefore;
+    u16 FlagsAfter;
+    u32 MemoryAddress;
+    u16 MemoryBefore;
+    u16 MemoryAfter;
+} trace_record;
+
+/* NOTE(chuck): With -async, the simulation runs on its own thread and hands its trace records to the thread doing the writing through a single-producer/single-consumer ring, so the simulation never waits on formatting, the terminal or the disk (unless the ring fills up and the policy says to wait).
+
+   Each side only ever writes its own index. The producer stores the record and then publishes it by bumping WriteIndex, the consumer reads the record and then frees the slot by bumping ReadIndex. Under the grow policy, a full segment isn't resized in place: the producer starts a new one twice the size and links it from Next, and the consumer moves over once it has emptied the old one. */
+typedef enum
+{
+    TraceFull_Block, // NOTE(chuck): Wait for the writer to make room.
+    TraceFull_Drop, // NOTE(chuck): Throw the record away and count it.
+    TraceFull_Grow, // NOTE(chuck): Switch to a bigger ring.
+} trace_full_policy;
+
+typedef struct trace_ring_segment trace_ring_segment;
+struct trace_ring_segment
+{
+    trace_record *Records;
+    u32 Capacity; // NOTE(chuck): Always a power of two, the indices just count up and get masked.
+    volatile u32 WriteIndex;
+    volatile u32 ReadIndex;
+    trace_ring_segment *volatile Next;
+};
+
+typedef struct
+{
+    trace_full_policy Policy;
+    trace_ring_segment *ProducerSegment;
+    trace_ring_segment *ConsumerSegment;
+    volatile int Done;
+    unsigned __int64 DroppedCount;
+} trace_ring;
+
+#define TRACE_RING_DEFAULT_CAPACITY (1 << 16)
+
+typedef struct
+{
+    u16 Registers[8];
+    u16 SegmentRegisters[4];
+    u16 Flags;
+} cpu_state;
+
+// NOTE(chuck): The whole 1 MB the 8086 can address. Segment:offset addresses wrap around at the top, same as on the real thing.
+#define MEMORY_SIZE Megabytes(1)
+#define MEMORY_ADDRESS_MASK ((u32)MEMORY_SIZE - 1)
+
+/* NOTE(chuck): A trace store holds the same records as a -trace file, but packed down to what actually changed and cut into blocks so that any step can be reached without decoding the whole run.
+
+   The file is a trace_store_header, the file name, the program bytes, the blocks, the block index (one u64 file offset per block), the IP table and finally the write index. Every block opens with a trace_store_block_header carrying the full CPU state going into its first step, so decoding can start at any block. Block N holds steps N*StepsPerBlock on up, so finding the block for a step is a divide.
+
+   Within a block, each record is a tag byte (see trace_store_tag), an optional second tag byte, and then LEB128 varints for whatever the tags say is there. The op name comes from the program and the "before" values come from the running state, so in the common case a record is just the tag, the register delta and the flag bits that flipped.
+
+   The IP table lists every IP that was ever executed along with the first step that executed it, sorted by IP and delta coded, so "first time at IP X" doesn't need to look at any of the blocks before the answer.
+
+   The write index answers "who wrote this and when" without touching the blocks at all. Every register write and every memory write goes under a key (the register, or the 256-byte page of memory), and each key's writes are kept in step order in chunks of TRACE_WRITE_CHUNK_SIZE. A key has a table with the first step of each of its chunks, so getting to any step for that key is a binary search plus decoding one chunk. The keys themselves are listed, sorted, in a directory of trace_write_keys at WriteIndexOffset.
+
+   Both the blocks and the write index code each record against what the same op did the last time around (see trace_store_history and trace_write_history), so a loop costs a few bytes per iteration instead of a few bytes per step. */
+#define TRACE_STORE_MAGIC 0x5a363853 // NOTE(chuck): "S86Z"
+#define TRACE_STORE_VERSION 3
+#define TRACE_STORE_STEPS_PER_BLOCK 4096
+#define TRACE_STORE_MAX_RECORD_SIZE 40
+typedef struct
+{
+    u32 Magic;
+    u32 Version;
+    u32 FileNameLength;
+    u32 ProgramLength;
+    u32 StepsPerBlock;
+    u32 BlockCount;
+    u32 MaxBlockSize;
+    u32 IPCount;
+    u64 StepCount;
+    u64 IndexOffset;
+    u64 IPTableOffset;
+    u64 IPTableSize;
+    u64 WriteIndexOffset;
+    u32 WriteKeyCount;
+    u32 MaxWriteChunkSize;
+} trace_store_header;
+
+typedef struct
+{
+    u32 Size;
+    u32 StepCount;
+    u32 IP;
+    cpu_state State;
+} trace_store_block_header;
+
+typedef enum
+{
+    TraceStore_RegisterMask = 0x0f, // NOTE(chuck): TRACE_NO_REGISTER is stored as 0xf.
+    TraceStore_RegisterWrite = (1 << 4),
+    TraceStore_FlagsChanged = (1 << 5),
+    TraceStore_Jump = (1 << 6), // NOTE(chuck): The IP isn't the fall-through of the last op, so a zigzagged delta follows.
+    TraceStore_Extended = (1 << 7),
+
+    // NOTE(chuck): Second tag byte. These cover records that don't line up with the running state, which -exec doesn't produce today but which still have to come back out exactly.
+    TraceStore_MemoryWrite = (1 << 0),
+    TraceStore_ExplicitName = (1 << 1),
+    TraceStore_ExplicitRegisterBefore = (1 << 2),
+    TraceStore_ExplicitFlagsBefore = (1 << 3),
+    TraceStore_ExplicitRegister = (1 << 4), // NOTE(chuck): Garbage segment register encodings can name registers past the ones that fit in the tag.
+    TraceStore_Repeat = (1 << 5), // NOTE(chuck): A varint count follows: that many records in a row went the way their ops' last records did. Then, for each of those ops that sets flags, its flags XOR.
+} trace_store_tag;
+
+/* NOTE(chuck): Loops are most of any long run, and a loop's records come out the same every time around, give or take a stride. So within a block, every op remembers how its last record went: the op that came after it, what it did to its register, and how far its memory write moved from the one before. A record that goes the way that predicts isn't stored on its own, and a whole run of them is just a TraceStore_Repeat count. The flags an add or a cmp leaves behind can't be predicted like that, so ops that have set flags before carry just their flags in the run. The history starts over with every block, so blocks still decode on their own. */
+typedef struct
+{
+    u32 Generation; // NOTE(chuck): Entries from an earlier block (or an earlier pass over this one) have an older generation and count as empty.
+    int HasNextIP;
+    u32 NextIP;
+    u8 Register;
+    u8 Flags;
+    u16 RegisterDelta;
+    int SetsFlags;
+    u16 MemoryBefore;
+    u16 MemoryAfter;
+    u16 MemoryAfterStride;
+    u32 MemoryAddress;
+    u32 MemoryAddressStride;
+} trace_store_history;
+
+typedef struct
+{
+    trace_store_history *History; // NOTE(chuck): One per program byte.
+    u32 Generation;
+    int HasLastIP;
+    u32 LastIP;
+} trace_store_predictor;
+
+#define TRACE_WRITE_CHUNK_SIZE 128
+#define TRACE_WRITE_PAGE_SHIFT 8
+#define TRACE_WRITE_FIRST_PAGE_KEY (TRACE_SEGMENT_REGISTER + 4) // NOTE(chuck): Keys below this are registers, numbered like trace_record.Register.
+#define TRACE_WRITE_MAX_ENTRY_SIZE 24
+typedef struct
+{
+    u64 Step;
+    u32 Key;
+    u32 Address; // NOTE(chuck): The register for register keys.
+    u32 IP;
+    u16 Before;
+    u16 After;
+} trace_write;
+
+/* NOTE(chuck): A chunk mostly holds the same few ops writing over and over, so each write is coded against what its op's last write in the chunk predicts: the same distance in steps, address and value as last time. A trace_write_tag says which fields missed, and a run of writes that all hit is a single TraceWrite_Run byte. */
+typedef enum
+{
+    TraceWrite_ExplicitIP = (1 << 0),
+    TraceWrite_ExplicitStep = (1 << 1),
+    TraceWrite_ExplicitAddress = (1 << 2),
+    TraceWrite_ExplicitBefore = (1 << 3),
+    TraceWrite_ExplicitAfter = (1 << 4),
+    TraceWrite_Run = (1 << 7), // NOTE(chuck): The low bits are how many writes in a row hit.
+} trace_write_tag;
+
+typedef struct
+{
+    u32 Generation; // NOTE(chuck): Same trick as trace_store_history, only per chunk.
+    int HasNextIP;
+    u32 NextIP;
+    u64 Step;
+    u64 StepStride;
+    u32 Address;
+    u32 AddressStride;
+    u16 Before;
+    u16 After;
+    u16 AfterStride;
+} trace_write_history;
+
+typedef struct
+{
+    trace_write_history *History; // NOTE(chuck): One per program byte.
+    u32 Generation;
+    int HasLast;
+    trace_write Last;
+} trace_write_predictor;
+
+typedef struct
+{
+    u32 Key;
+    u32 WriteCount;
+    u32 ChunkCount;
+    u32 Reserved;
+    u64 ChunkTableOffset;
+} trace_write_key;
+
+typedef struct
+{
+    u64 FirstStep;
+    u64 Offset;
+    u32 Size;
+    u32 WriteCount;
+} trace_write_chunk;
+
+typedef struct
+{
+    output_buffer Output;
+    u64 Offset; // NOTE(chuck): Where the next byte from Output will land in the file.
+
+    u8 *Block;
+    u32 BlockSize;
+    u32 BlockStepCount;
+    trace_store_block_header BlockHeader;
+
+    cpu_state State;
+    u32 NextIP;
+    trace_store_predictor Predictor;
+    u32 RepeatCount; // NOTE(chuck): Predicted records waiting to go out as one TraceStore_Repeat.
+    u8 *RepeatFlags;
+    u32 RepeatFlagsSize;
+    u64 StepCount;
+    u32 BlockCount;
+    u32 MaxBlockSize;
+    u64 *FirstStepAtIP; // NOTE(chuck): Step + 1, so that zero means never.
+    u64 WriteCount; // NOTE(chuck): The trace_writes themselves pile up in TraceWriteArena until the end.
+
+    op **OpAtOffset;
+    u32 ProgramLength;
+} trace_store_writer;
+
+typedef struct
+{
+    FILE *File;
+    trace_store_header Header;
+    u64 *BlockOffsets;
+
+    u8 *Block;
+    u8 *At;
+    u32 StepsLeft;
+    u32 RepeatsLeft;
+
+    cpu_state State;
+    u32 NextIP;
+    trace_store_predictor Predictor;
+    u64 Step;
+
+    trace_write_key *WriteKeys;
+    u8 *WriteChunk;
+    trace_write_predictor WritePredictor;
+
+    op **OpAtOffset;
+    u32 ProgramLength;
+} trace_store_reader;
+
+// NOTE(chuck): Walks one key's writes in step order, a chunk at a time.
+typedef struct
+{
+    trace_write_key *Key;
+    trace_write_chunk *Chunks;
+    u32 ChunkIndex;
+    u32 WriteIndex;
+    u32 WriteCount;
+    trace_write Writes[TRACE_WRITE_CHUNK_SIZE];
+} trace_write_cursor;
+
+/* NOTE(chuck): -compare checks a run against one of the reference listing_00NN_*.txt traces, one line per step as it goes. Only the current reference line and the last few that matched are ever kept around, so the length of the run doesn't matter.
+
+   A reference step line looks like "add cx, 1 ; cx:0x3->0x4 ip:0x16->0x19 flags:A->". Registers and flags only show up when they changed, and ip only shows up in traces from the listings that model it. */
+#define COMPARE_CONTEXT_LINES 8
+#define COMPARE_MAX_REGISTERS 4
+typedef struct
+{
+    int RegisterCount;
+    u8 Register[COMPARE_MAX_REGISTERS];
+    u16 RegisterBefore[COMPARE_MAX_REGISTERS];
+    u16 RegisterAfter[COMPARE_MAX_REGISTERS];
+
+    int HasIP;
+    u32 IPBefore;
+    u32 IPAfter;
+
+    int HasFlags;
+    u16 FlagsBefore;
+    u16 FlagsAfter;
+} reference_step;
+
+typedef struct
+{
+    FILE *File;
+    u64 LineNumber;
+    char Line[MAX_LINE_LENGTH];
+
+    u32 ContextCount;
+    u64 ContextLineNumber[COMPARE_CONTEXT_LINES];
+    char Context[COMPARE_CONTEXT_LINES][MAX_LINE_LENGTH];
+} reference_trace;
+
+/* NOTE(chuck): -fold-trace prints a trace one step per line, except that a run of steps repeating the same IPs over and over is cut down to its first iteration plus a summary: how many more times it went around, how much each register moved per trip when that was the same every time, which ones didn't move the same way every time, and how many memory writes the folded trips made and where.
+
+   Loops are found as the steps go by. Every step is checked against the last time its IP came up, and if the FOLD_MAX_PERIOD or fewer steps since then are an exact repeat of the ones before that, that's a loop. The most recent steps are held back from printing until they can't be the first repeat of a loop anymore. */
+#define FOLD_MAX_PERIOD 256
+#define FOLD_HISTORY_SIZE (2*FOLD_MAX_PERIOD)
+typedef struct
+{
+    output_buffer *Output;
+    op **OpAtOffset;
+    u32 ProgramLength;
+    u64 *LastStepAtIP; // NOTE(chuck): Step + 1, so that zero means never.
+
+    u64 Step;
+    cpu_state State;
+
+    // NOTE(chuck): The last FOLD_HISTORY_SIZE steps, and the state going into each. The newest Held of them haven't been printed yet.
+    trace_record History[FOLD_HISTORY_SIZE];
+    cpu_state HistoryState[FOLD_HISTORY_SIZE];
+    u64 HistoryCount;
+    u32 Held;
 
+    int Folding;
+    u32 Period;
+    u32 Position;
+    u64 Repeats;
+    u64 FirstFoldedStep;
+    trace_record Body[FOLD_MAX_PERIOD];
+    trace_record Iteration[FOLD_MAX_PERIOD];
+    cpu_state IterationStart;
+    cpu_state Delta;
+    u16 VariesMask; // NOTE(chuck): Bit per trace register, plus FOLD_FLAGS_VARY.
+    u64 WriteCount; // NOTE(chuck): Memory writes in the folded trips, which never get printed one by one.
+    u32 LowestWrite;
+    u32 HighestWrite;
+} trace_folder;
+#define FOLD_FLAGS_VARY (1 << 15)
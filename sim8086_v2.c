@@ -90,7 +90,25 @@ static char *SegmentRegisterLookup[4] =
     "ds",
 };
 
-static op_definition OpTable[256] = {0};
+// NOTE(chuck): Generated by "sim8086_v2 -bake 8086_decoding_guide.txt sim8086_v2_table.h". The decoder
+// only ever looks at BakedOpTable, so it doesn't need the guide around at runtime.
+#include "sim8086_v2_table.h"
+
+static char *ParamTypeNames[] =
+{
+    "Param_Unknown",
+    "Param_Immed8",
+    "Param_Immed16",
+    "Param_Reg8",
+    "Param_Reg16",
+    "Param_Mem8",
+    "Param_Mem16",
+    "Param_RegOrMem8",
+    "Param_RegOrMem16",
+    "Param_SegReg",
+    "Param_Literal",
+    "Param_ShortLabel",
+};
 
 static file LoadFile(char *Filename)
 {
@@ -164,139 +182,220 @@ static void ParseParamType(op_variant *OpVariant, int ParamIndex, char *ParamDes
     }
 }
 
-int main(int ArgCount, char **Args)
+static void ParseDecodingGuide(op_definition *Table, file Guide)
 {
-    int Result = 0;
+    char *At = strstr((s8 *)Guide.Data, "00 |");
+    char *AtEnd = (s8 *)Guide.Data + Guide.Size;
+    Assert(At);
     
-    if(ArgCount != 2)
+    char Temp[1024] = {0};
+    while(*At)
     {
-        printf("Usage: %s <assembly>\n", Args[0]);
-    }
-    else
-    {
-        file Guide = LoadFile("C:/dev/computer_enhance/8086_decoding_guide.txt");
-        char *At = strstr((s8 *)Guide.Data, "00 |");
-        char *AtEnd = At + Guide.Size;
-        
-        char Temp[1024] = {0};
-        while(*At)
-        {
-            char *LineStart = At;
+        char *LineStart = At;
 
-            int OpCodeHex = strtol(At, 0, 16);
-            op_definition *OpDef = &OpTable[OpCodeHex];
-            OpDef->OpCode = OpCodeHex;
-            At += 5;
+        int OpCodeHex = strtol(At, 0, 16);
+        op_definition *OpDef = &Table[OpCodeHex];
+        OpDef->OpCode = OpCodeHex;
+        At += 5;
 
-            memcpy(Temp, At, 4);
-            memcpy(Temp + 4, At + 5, 4);
-            Temp[8] = 0;
-            
-            int OpCodeBinary = strtol(Temp, 0, 2);
-            // NOTE(chuck): Integrity validation. These must be sorted.
-            Assert(OpCodeHex == OpCodeBinary);
-
-            Assert(OpDef->OpVariantCount < ArrayCount(OpDef->OpVariant));
-            int OpVariantIndex = OpDef->OpVariantCount++;
-            op_variant *OpVariant = &OpDef->OpVariant[OpVariantIndex];
-            OpVariant->MaxBytes = 1;
-            
-            // NOTE(chuck): "2ND BYTE" column
-            At = strchr(At, '|') + 2;
-            if(At[0] != ' ')
+        memcpy(Temp, At, 4);
+        memcpy(Temp + 4, At + 5, 4);
+        Temp[8] = 0;
+        
+        int OpCodeBinary = strtol(Temp, 0, 2);
+        // NOTE(chuck): Integrity validation. These must be sorted.
+        Assert(OpCodeHex == OpCodeBinary);
+
+        Assert(OpDef->OpVariantCount < ArrayCount(OpDef->OpVariant));
+        int OpVariantIndex = OpDef->OpVariantCount++;
+        op_variant *OpVariant = &OpDef->OpVariant[OpVariantIndex];
+        OpVariant->MaxBytes = 1;
+        
+        // NOTE(chuck): "2ND BYTE" column
+        At = strchr(At, '|') + 2;
+        if(At[0] != ' ')
+        {
+            if(!memcmp(At, "MOD ", 4))
             {
-                if(!memcmp(At, "MOD ", 4))
-                {
-                    OpVariant->UseMod = 1;
+                OpVariant->UseMod = 1;
 
-                    if((At[4] == '0') || (At[4] == '1'))
-                    {
-                        OpDef->UseExtension = 1;
+                if((At[4] == '0') || (At[4] == '1'))
+                {
+                    OpDef->UseExtension = 1;
 
-                        memcpy(Temp, At + 4, 3);
-                        Temp[3] = 0;
+                    memcpy(Temp, At + 4, 3);
+                    Temp[3] = 0;
 
-                        OpDef->Extension = strtol(Temp, 0, 2);
-                        // NOTE(chuck): Integrity validation. These must be sorted.
-                        Assert(OpVariantIndex == OpDef->Extension);
-                    }
+                    OpDef->Extension = strtol(Temp, 0, 2);
+                    // NOTE(chuck): Integrity validation. These must be sorted.
+                    Assert(OpVariantIndex == OpDef->Extension);
                 }
-
-                ++OpVariant->MaxBytes;
             }
-            
-            // NOTE(chuck): "BYTES 3, 4, 5, 6" column
-            At = strchr(At, '|') + 2;
 
-            char *NextColumn = strchr(At, '|');
-            if(At[0] != ' ')
+            ++OpVariant->MaxBytes;
+        }
+        
+        // NOTE(chuck): "BYTES 3, 4, 5, 6" column
+        At = strchr(At, '|') + 2;
+
+        char *NextColumn = strchr(At, '|');
+        if(At[0] != ' ')
+        {
+            char *Param = At;
+            do
             {
-                char *Param = At;
-                do
+                ++OpVariant->MaxBytes;
+                Param = strchr(Param, ',');
+                if(Param)
                 {
-                    ++OpVariant->MaxBytes;
-                    Param = strchr(Param, ',');
-                    if(Param)
-                    {
-                        ++Param;
-                    }
-                } while(Param && (Param < NextColumn));
-            }
+                    ++Param;
+                }
+            } while(Param && (Param < NextColumn));
+        }
 
-            char *EndOfLine = strchr(At, '\n');
-            if(!EndOfLine)
-            {
-                EndOfLine = AtEnd;
-            }
+        char *EndOfLine = strchr(At, '\n');
+        if(!EndOfLine)
+        {
+            EndOfLine = AtEnd;
+        }
 
-            // NOTE(chuck): "FORMAT" column
-            OpVariant->Name = NextColumn + 2;
-            char *NameEnd = strchr(OpVariant->Name, ' ');
-            if(NameEnd > EndOfLine)
-            {
-                NameEnd = EndOfLine;
-            }
-            OpVariant->NameLength = (int)(NameEnd - OpVariant->Name);
-            char *Slash = strchr(OpVariant->Name, '/');
-            int SlashIndex = (int)(Slash - OpVariant->Name);
-            if(OpVariant->NameLength > SlashIndex)
-            {
-                OpVariant->NameLength = SlashIndex;
-            }
-            if(NameEnd == EndOfLine)
+        // NOTE(chuck): "FORMAT" column
+        OpVariant->Name = NextColumn + 2;
+        char *NameEnd = strchr(OpVariant->Name, ' ');
+        if(NameEnd > EndOfLine)
+        {
+            NameEnd = EndOfLine;
+        }
+        OpVariant->NameLength = (int)(NameEnd - OpVariant->Name);
+        // NOTE(chuck): The last line of the guide has no '/' after it, so strchr can come back empty here.
+        char *Slash = strchr(OpVariant->Name, '/');
+        if(Slash && (Slash < NameEnd))
+        {
+            OpVariant->NameLength = (int)(Slash - OpVariant->Name);
+        }
+        if(NameEnd == EndOfLine)
+        {
+            OpVariant->Format = NameEnd;
+            OpVariant->FormatLength = 0;
+        }
+        else
+        {
+            OpVariant->Format = NameEnd + 1;
+
+            char *SecondParam = strchr(OpVariant->Format, ',');
+            ParseParamType(OpVariant, 0, OpVariant->Format, AtEnd);
+
+            OpVariant->ParamCount = 1;
+            if(SecondParam && (SecondParam < EndOfLine))
             {
-                OpVariant->Format = NameEnd;
-                OpVariant->FormatLength = 0;
+                ++OpVariant->ParamCount;
+                ++SecondParam;
+                ParseParamType(OpVariant, 1, SecondParam, AtEnd);
             }
-            else
-            {
-                OpVariant->Format = NameEnd + 1;
+            OpVariant->FormatLength = (int)(EndOfLine - OpVariant->Format);
+        }
+        
+        // int L = (int)(At - LineStart);
+        // printf("%02X %d :: %.*s\n", OpDef->OpCode, OpVariant->MaxBytes, L, LineStart);//OpVariant->FormatLength, OpVariant->Format);
 
-                char *SecondParam = strchr(OpVariant->Format, ',');
-                ParseParamType(OpVariant, 0, OpVariant->Format, AtEnd);
+        At = EndOfLine;
+        if(At < AtEnd)
+        {
+            Assert(*At == '\n');
+            ++At;
+        }
+    }
+}
 
-                OpVariant->ParamCount = 1;
-                if(SecondParam && (SecondParam < EndOfLine))
-                {
-                    ++OpVariant->ParamCount;
-                    ++SecondParam;
-                    ParseParamType(OpVariant, 1, SecondParam, AtEnd);
-                }
-                OpVariant->FormatLength = (int)(EndOfLine - OpVariant->Format);
-            }
-            
-            // int L = (int)(At - LineStart);
-            // printf("%02X %d :: %.*s\n", OpDef->OpCode, OpVariant->MaxBytes, L, LineStart);//OpVariant->FormatLength, OpVariant->Format);
+static void WriteBakedString(FILE *Out, char *String, int Length)
+{
+    fprintf(Out, "\"");
+    for(int Index = 0;
+        Index < Length;
+        ++Index)
+    {
+        if((String[Index] == '"') || (String[Index] == '\\'))
+        {
+            fprintf(Out, "\\");
+        }
+        fprintf(Out, "%c", String[Index]);
+    }
+    fprintf(Out, "\"");
+}
 
-            At = EndOfLine;
-            if(At < AtEnd)
+static void WriteBakedTable(FILE *Out, op_definition *Table, char *GuideFilename)
+{
+    fprintf(Out, "// NOTE(chuck): Generated from %s by sim8086_v2 -bake. Do not edit by hand.\n\n", GuideFilename);
+    fprintf(Out, "static op_definition BakedOpTable[256] =\n{\n");
+    for(int OpCode = 0;
+        OpCode < 256;
+        ++OpCode)
+    {
+        op_definition *OpDef = &Table[OpCode];
+        fprintf(Out, "    [0x%02X] = {.OpCode=0x%02X, .UseExtension=%d, .Extension=%d, .OpVariantCount=%d, .OpVariant=\n    {\n",
+                OpCode, OpDef->OpCode, OpDef->UseExtension, OpDef->Extension, OpDef->OpVariantCount);
+        for(int OpVariantIndex = 0;
+            OpVariantIndex < OpDef->OpVariantCount;
+            ++OpVariantIndex)
+        {
+            op_variant *OpVariant = &OpDef->OpVariant[OpVariantIndex];
+            fprintf(Out, "        {.UseMod=%d, .MaxBytes=%d, .Name=", OpVariant->UseMod, OpVariant->MaxBytes);
+            WriteBakedString(Out, OpVariant->Name, OpVariant->NameLength);
+            fprintf(Out, ", .NameLength=%d, .Format=", OpVariant->NameLength);
+            WriteBakedString(Out, OpVariant->Format, OpVariant->FormatLength);
+            fprintf(Out, ", .FormatLength=%d, .ParamCount=%d, .Param={", OpVariant->FormatLength, OpVariant->ParamCount);
+            for(int ParamIndex = 0;
+                ParamIndex < OpVariant->ParamCount;
+                ++ParamIndex)
             {
-                Assert(*At == '\n');
-                ++At;
+                op_param *Param = &OpVariant->Param[ParamIndex];
+                fprintf(Out, "%s{%s", ParamIndex ? ", " : "", ParamTypeNames[Param->Type]);
+                if(Param->Type == Param_Literal)
+                {
+                    fprintf(Out, ", ");
+                    WriteBakedString(Out, Param->Literal, (int)Param->LiteralLength);
+                    fprintf(Out, ", %d", (int)Param->LiteralLength);
+                }
+                fprintf(Out, "}");
             }
+            fprintf(Out, "}},\n");
         }
+        fprintf(Out, "    }},\n");
+    }
+    fprintf(Out, "};\n");
+}
+
+int main(int ArgCount, char **Args)
+{
+    int Result = 0;
+    
+    if((ArgCount == 4) && !strcmp(Args[1], "-bake"))
+    {
+        // NOTE(chuck): Only the generator reads the guide text. Run this whenever the guide changes.
+        static op_definition GuideOpTable[256] = {0};
+        file Guide = LoadFile(Args[2]);
+        ParseDecodingGuide(GuideOpTable, Guide);
 
-        // printf("---\n");
+        FILE *Out = fopen(Args[3], "wb");
+        if(Out)
+        {
+            WriteBakedTable(Out, GuideOpTable, Args[2]);
+            fclose(Out);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to open %s for writing.\n", Args[3]);
+            Result = 1;
+        }
+    }
+    else if(ArgCount != 2)
+    {
+        printf("Usage: %s <assembly>\n", Args[0]);
+        printf("       %s -bake <decoding guide> <output header>\n", Args[0]);
+    }
+    else
+    {
+        char Temp[1024] = {0};
 
         char *AssemblyFilename = Args[1];
         file Assembly = LoadFile(AssemblyFilename);
@@ -311,7 +410,7 @@ int main(int ArgCount, char **Args)
             
             char *T = Temp;
 
-            op_definition *OpDef = &OpTable[OpCode];
+            op_definition *OpDef = &BakedOpTable[OpCode];
             if(OpDef->UseExtension)
             {
                 OpVariantIndex = (P[1] & 0b00111000) >> 3;
@@ -0,0 +1,1204 @@
+// NOTE(chuck): Generated from 8086_decoding_guide.txt by sim8086_v2 -bake. Do not edit by hand.
+
+static op_definition BakedOpTable[256] =
+{
+    [0x00] = {.OpCode=0x00, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADD", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x01] = {.OpCode=0x01, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADD", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x02] = {.OpCode=0x02, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADD", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x03] = {.OpCode=0x03, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADD", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x04] = {.OpCode=0x04, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="ADD", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x05] = {.OpCode=0x05, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="ADD", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x06] = {.OpCode=0x06, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="ES", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "ES", 2}}},
+    }},
+    [0x07] = {.OpCode=0x07, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="ES", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "ES", 2}}},
+    }},
+    [0x08] = {.OpCode=0x08, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="OR", .NameLength=2, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x09] = {.OpCode=0x09, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="OR", .NameLength=2, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x0A] = {.OpCode=0x0A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="OR", .NameLength=2, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x0B] = {.OpCode=0x0B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="OR", .NameLength=2, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x0C] = {.OpCode=0x0C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="OR", .NameLength=2, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x0D] = {.OpCode=0x0D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="OR", .NameLength=2, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x0E] = {.OpCode=0x0E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="CS", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "CS", 2}}},
+    }},
+    [0x0F] = {.OpCode=0x0F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x10] = {.OpCode=0x10, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADC", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x11] = {.OpCode=0x11, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADC", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x12] = {.OpCode=0x12, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADC", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x13] = {.OpCode=0x13, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ADC", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x14] = {.OpCode=0x14, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="ADC", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x15] = {.OpCode=0x15, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="ADC", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x16] = {.OpCode=0x16, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="SS", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SS", 2}}},
+    }},
+    [0x17] = {.OpCode=0x17, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="SS", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SS", 2}}},
+    }},
+    [0x18] = {.OpCode=0x18, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SBB", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x19] = {.OpCode=0x19, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SBB", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x1A] = {.OpCode=0x1A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SBB", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x1B] = {.OpCode=0x1B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SBB", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x1C] = {.OpCode=0x1C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="SBB", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x1D] = {.OpCode=0x1D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="SBB", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x1E] = {.OpCode=0x1E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="DS", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DS", 2}}},
+    }},
+    [0x1F] = {.OpCode=0x1F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="DS", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DS", 2}}},
+    }},
+    [0x20] = {.OpCode=0x20, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="AND", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x21] = {.OpCode=0x21, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="AND", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x22] = {.OpCode=0x22, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="AND", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x23] = {.OpCode=0x23, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="AND", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x24] = {.OpCode=0x24, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="AND", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x25] = {.OpCode=0x25, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="AND", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x26] = {.OpCode=0x26, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="ES:+", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x27] = {.OpCode=0x27, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DAA", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x28] = {.OpCode=0x28, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SUB", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x29] = {.OpCode=0x29, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SUB", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x2A] = {.OpCode=0x2A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SUB", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x2B] = {.OpCode=0x2B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="SUB", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x2C] = {.OpCode=0x2C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="SUB", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x2D] = {.OpCode=0x2D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="SUB", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x2E] = {.OpCode=0x2E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CS:+", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x2F] = {.OpCode=0x2F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DAS", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x30] = {.OpCode=0x30, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="XOR", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x31] = {.OpCode=0x31, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="XOR", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x32] = {.OpCode=0x32, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="XOR", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x33] = {.OpCode=0x33, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="XOR", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x34] = {.OpCode=0x34, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="XOR", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x35] = {.OpCode=0x35, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="XOR", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x36] = {.OpCode=0x36, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="SS:+", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x37] = {.OpCode=0x37, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="AAA", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x38] = {.OpCode=0x38, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="CMP", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x39] = {.OpCode=0x39, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="CMP", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x3A] = {.OpCode=0x3A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="CMP", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x3B] = {.OpCode=0x3B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="CMP", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x3C] = {.OpCode=0x3C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="CMP", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0x3D] = {.OpCode=0x3D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="CMP", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0x3E] = {.OpCode=0x3E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DS:+", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x3F] = {.OpCode=0x3F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="AAS", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x40] = {.OpCode=0x40, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="AX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "AX", 2}}},
+    }},
+    [0x41] = {.OpCode=0x41, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="CX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "CX", 2}}},
+    }},
+    [0x42] = {.OpCode=0x42, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="DX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DX", 2}}},
+    }},
+    [0x43] = {.OpCode=0x43, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="BX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BX", 2}}},
+    }},
+    [0x44] = {.OpCode=0x44, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="SP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SP", 2}}},
+    }},
+    [0x45] = {.OpCode=0x45, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="BP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BP", 2}}},
+    }},
+    [0x46] = {.OpCode=0x46, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="SI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SI", 2}}},
+    }},
+    [0x47] = {.OpCode=0x47, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INC", .NameLength=3, .Format="DI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DI", 2}}},
+    }},
+    [0x48] = {.OpCode=0x48, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="AX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "AX", 2}}},
+    }},
+    [0x49] = {.OpCode=0x49, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="CX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "CX", 2}}},
+    }},
+    [0x4A] = {.OpCode=0x4A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="DX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DX", 2}}},
+    }},
+    [0x4B] = {.OpCode=0x4B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="BX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BX", 2}}},
+    }},
+    [0x4C] = {.OpCode=0x4C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="SP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SP", 2}}},
+    }},
+    [0x4D] = {.OpCode=0x4D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="BP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BP", 2}}},
+    }},
+    [0x4E] = {.OpCode=0x4E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="SI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SI", 2}}},
+    }},
+    [0x4F] = {.OpCode=0x4F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="DEC", .NameLength=3, .Format="DI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DI", 2}}},
+    }},
+    [0x50] = {.OpCode=0x50, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="AX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "AX", 2}}},
+    }},
+    [0x51] = {.OpCode=0x51, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="CX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "CX", 2}}},
+    }},
+    [0x52] = {.OpCode=0x52, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="DX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DX", 2}}},
+    }},
+    [0x53] = {.OpCode=0x53, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="BX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BX", 2}}},
+    }},
+    [0x54] = {.OpCode=0x54, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="SP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SP", 2}}},
+    }},
+    [0x55] = {.OpCode=0x55, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="BP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BP", 2}}},
+    }},
+    [0x56] = {.OpCode=0x56, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="SI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SI", 2}}},
+    }},
+    [0x57] = {.OpCode=0x57, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSH", .NameLength=4, .Format="DI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DI", 2}}},
+    }},
+    [0x58] = {.OpCode=0x58, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="AX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "AX", 2}}},
+    }},
+    [0x59] = {.OpCode=0x59, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="CX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "CX", 2}}},
+    }},
+    [0x5A] = {.OpCode=0x5A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="DX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DX", 2}}},
+    }},
+    [0x5B] = {.OpCode=0x5B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="BX", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BX", 2}}},
+    }},
+    [0x5C] = {.OpCode=0x5C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="SP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SP", 2}}},
+    }},
+    [0x5D] = {.OpCode=0x5D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="BP", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "BP", 2}}},
+    }},
+    [0x5E] = {.OpCode=0x5E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="SI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "SI", 2}}},
+    }},
+    [0x5F] = {.OpCode=0x5F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POP", .NameLength=3, .Format="DI", .FormatLength=2, .ParamCount=1, .Param={{Param_Literal, "DI", 2}}},
+    }},
+    [0x60] = {.OpCode=0x60, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x61] = {.OpCode=0x61, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used POPA?", .FormatLength=14, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x62] = {.OpCode=0x62, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x63] = {.OpCode=0x63, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x64] = {.OpCode=0x64, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x65] = {.OpCode=0x65, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x66] = {.OpCode=0x66, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x67] = {.OpCode=0x67, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x68] = {.OpCode=0x68, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x69] = {.OpCode=0x69, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x6A] = {.OpCode=0x6A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x6B] = {.OpCode=0x6B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x6C] = {.OpCode=0x6C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x6D] = {.OpCode=0x6D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x6E] = {.OpCode=0x6E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x6F] = {.OpCode=0x6F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x70] = {.OpCode=0x70, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JO", .NameLength=2, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x71] = {.OpCode=0x71, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNO", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x72] = {.OpCode=0x72, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JB", .NameLength=2, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x73] = {.OpCode=0x73, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNB", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x74] = {.OpCode=0x74, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JE", .NameLength=2, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x75] = {.OpCode=0x75, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNE", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x76] = {.OpCode=0x76, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JBE", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x77] = {.OpCode=0x77, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNBE", .NameLength=4, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x78] = {.OpCode=0x78, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JS", .NameLength=2, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x79] = {.OpCode=0x79, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNS", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x7A] = {.OpCode=0x7A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JP", .NameLength=2, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x7B] = {.OpCode=0x7B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNP", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x7C] = {.OpCode=0x7C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JL", .NameLength=2, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x7D] = {.OpCode=0x7D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNL", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x7E] = {.OpCode=0x7E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JLE", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x7F] = {.OpCode=0x7F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JNLE", .NameLength=4, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0x80] = {.OpCode=0x80, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=5, .Name="ADD", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="OR", .NameLength=2, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="ADC", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="SBB", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="AND", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="SUB", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="XOR", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="CMP", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+    }},
+    [0x81] = {.OpCode=0x81, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=6, .Name="ADD", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="OR", .NameLength=2, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="ADC", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="SBB", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="AND", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="SUB", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="XOR", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=6, .Name="CMP", .NameLength=3, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+    }},
+    [0x82] = {.OpCode=0x82, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=5, .Name="ADD", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=5, .Name="ADC", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="SBB", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=5, .Name="SUB", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=5, .Name="CMP", .NameLength=3, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+    }},
+    [0x83] = {.OpCode=0x83, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=5, .Name="ADD", .NameLength=3, .Format="REG16/MEM16,IMMED8", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=5, .Name="ADC", .NameLength=3, .Format="REG16/MEM16,IMMED8", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=5, .Name="SBB", .NameLength=3, .Format="REG16/MEM16,IMMED8", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=5, .Name="SUB", .NameLength=3, .Format="REG16/MEM16,IMMED8", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=5, .Name="CMP", .NameLength=3, .Format="REG16/MEM16,IMMED8", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed8}}},
+    }},
+    [0x84] = {.OpCode=0x84, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="TEST", .NameLength=4, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x85] = {.OpCode=0x85, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="TEST", .NameLength=4, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x86] = {.OpCode=0x86, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="XCHG", .NameLength=4, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x87] = {.OpCode=0x87, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="XCHG", .NameLength=4, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x88] = {.OpCode=0x88, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG8/MEM8,REG8", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Reg8}}},
+    }},
+    [0x89] = {.OpCode=0x89, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG16/MEM16,REG16", .FormatLength=17, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Reg16}}},
+    }},
+    [0x8A] = {.OpCode=0x8A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG8,REG8/MEM8", .FormatLength=14, .ParamCount=2, .Param={{Param_Reg8}, {Param_RegOrMem8}}},
+    }},
+    [0x8B] = {.OpCode=0x8B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG16,REG16/MEM16", .FormatLength=17, .ParamCount=2, .Param={{Param_Reg16}, {Param_RegOrMem16}}},
+    }},
+    [0x8C] = {.OpCode=0x8C, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG16/MEM16,SEGREG", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_SegReg}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG16/MEM16,SEGREG", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_SegReg}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG16/MEM16,SEGREG", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_SegReg}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="REG16/MEM16,SEGREG", .FormatLength=18, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_SegReg}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x8D] = {.OpCode=0x8D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="LEA", .NameLength=3, .Format="REG16,MEM16", .FormatLength=11, .ParamCount=2, .Param={{Param_Reg16}, {Param_Mem16}}},
+    }},
+    [0x8E] = {.OpCode=0x8E, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="SEGREG,REG16/MEM16", .FormatLength=18, .ParamCount=2, .Param={{Param_SegReg}, {Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="SEGREG,REG16/MEM16", .FormatLength=18, .ParamCount=2, .Param={{Param_SegReg}, {Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="SEGREG,REG16/MEM16", .FormatLength=18, .ParamCount=2, .Param={{Param_SegReg}, {Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MOV", .NameLength=3, .Format="SEGREG,REG16/MEM16", .FormatLength=18, .ParamCount=2, .Param={{Param_SegReg}, {Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x8F] = {.OpCode=0x8F, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="POP", .NameLength=3, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0x90] = {.OpCode=0x90, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="NOP", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x91] = {.OpCode=0x91, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,CX", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "CX", 2}}},
+    }},
+    [0x92] = {.OpCode=0x92, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,DX", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "DX", 2}}},
+    }},
+    [0x93] = {.OpCode=0x93, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,BX", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "BX", 2}}},
+    }},
+    [0x94] = {.OpCode=0x94, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,SP", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "SP", 2}}},
+    }},
+    [0x95] = {.OpCode=0x95, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,BP", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "BP", 2}}},
+    }},
+    [0x96] = {.OpCode=0x96, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,SI", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "SI", 2}}},
+    }},
+    [0x97] = {.OpCode=0x97, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XCHG", .NameLength=4, .Format="AX,DI", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "DI", 2}}},
+    }},
+    [0x98] = {.OpCode=0x98, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CBW", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x99] = {.OpCode=0x99, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CWD", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x9A] = {.OpCode=0x9A, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=5, .Name="CALL", .NameLength=4, .Format="FAR_PROC", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "FAR_PROC", 8}}},
+    }},
+    [0x9B] = {.OpCode=0x9B, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="WAIT", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x9C] = {.OpCode=0x9C, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="PUSHF", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x9D] = {.OpCode=0x9D, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="POPF", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x9E] = {.OpCode=0x9E, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="SAHF", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0x9F] = {.OpCode=0x9F, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="LAHF", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xA0] = {.OpCode=0xA0, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="AL,MEM8", .FormatLength=7, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Mem8}}},
+    }},
+    [0xA1] = {.OpCode=0xA1, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="AX,MEM16", .FormatLength=8, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Mem16}}},
+    }},
+    [0xA2] = {.OpCode=0xA2, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="MEM8,AL", .FormatLength=7, .ParamCount=2, .Param={{Param_Mem8}, {Param_Literal, "AL", 2}}},
+    }},
+    [0xA3] = {.OpCode=0xA3, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="MEM16,AX", .FormatLength=8, .ParamCount=2, .Param={{Param_Mem16}, {Param_Literal, "AX", 2}}},
+    }},
+    [0xA4] = {.OpCode=0xA4, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="MOVSB", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xA5] = {.OpCode=0xA5, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="MOVSW", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xA6] = {.OpCode=0xA6, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CMPSB", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xA7] = {.OpCode=0xA7, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CMPSW", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xA8] = {.OpCode=0xA8, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="TEST", .NameLength=4, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0xA9] = {.OpCode=0xA9, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="TEST", .NameLength=4, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0xAA] = {.OpCode=0xAA, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="STOSB", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xAB] = {.OpCode=0xAB, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="STOSW", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xAC] = {.OpCode=0xAC, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="LODSB", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xAD] = {.OpCode=0xAD, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="LODSW", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xAE] = {.OpCode=0xAE, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="SCASB", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xAF] = {.OpCode=0xAF, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="SCASW", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xB0] = {.OpCode=0xB0, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0xB1] = {.OpCode=0xB1, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="CL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "CL", 2}, {Param_Immed8}}},
+    }},
+    [0xB2] = {.OpCode=0xB2, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="DL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "DL", 2}, {Param_Immed8}}},
+    }},
+    [0xB3] = {.OpCode=0xB3, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="BL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "BL", 2}, {Param_Immed8}}},
+    }},
+    [0xB4] = {.OpCode=0xB4, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="AH,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AH", 2}, {Param_Immed8}}},
+    }},
+    [0xB5] = {.OpCode=0xB5, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="CH,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "CH", 2}, {Param_Immed8}}},
+    }},
+    [0xB6] = {.OpCode=0xB6, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="DH,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "DH", 2}, {Param_Immed8}}},
+    }},
+    [0xB7] = {.OpCode=0xB7, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="MOV", .NameLength=3, .Format="BH,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "BH", 2}, {Param_Immed8}}},
+    }},
+    [0xB8] = {.OpCode=0xB8, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="AX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed16}}},
+    }},
+    [0xB9] = {.OpCode=0xB9, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="CX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "CX", 2}, {Param_Immed16}}},
+    }},
+    [0xBA] = {.OpCode=0xBA, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="DX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "DX", 2}, {Param_Immed16}}},
+    }},
+    [0xBB] = {.OpCode=0xBB, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="BX,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "BX", 2}, {Param_Immed16}}},
+    }},
+    [0xBC] = {.OpCode=0xBC, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="SP,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "SP", 2}, {Param_Immed16}}},
+    }},
+    [0xBD] = {.OpCode=0xBD, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="BP,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "BP", 2}, {Param_Immed16}}},
+    }},
+    [0xBE] = {.OpCode=0xBE, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="SI,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "SI", 2}, {Param_Immed16}}},
+    }},
+    [0xBF] = {.OpCode=0xBF, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="MOV", .NameLength=3, .Format="DI,IMMED16", .FormatLength=10, .ParamCount=2, .Param={{Param_Literal, "DI", 2}, {Param_Immed16}}},
+    }},
+    [0xC0] = {.OpCode=0xC0, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xC1] = {.OpCode=0xC1, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xC2] = {.OpCode=0xC2, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="RET", .NameLength=3, .Format="IMMED16 ; intrasegment", .FormatLength=22, .ParamCount=1, .Param={{Param_Immed16}}},
+    }},
+    [0xC3] = {.OpCode=0xC3, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="RET", .NameLength=3, .Format="; intrasegment", .FormatLength=14, .ParamCount=1, .Param={{Param_Literal, "", 0}}},
+    }},
+    [0xC4] = {.OpCode=0xC4, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="LES", .NameLength=3, .Format="REG16,MEM16", .FormatLength=11, .ParamCount=2, .Param={{Param_Reg16}, {Param_Mem16}}},
+    }},
+    [0xC5] = {.OpCode=0xC5, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="LDS", .NameLength=3, .Format="REG16,MEM16", .FormatLength=11, .ParamCount=2, .Param={{Param_Reg16}, {Param_Mem16}}},
+    }},
+    [0xC6] = {.OpCode=0xC6, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=5, .Name="MOV", .NameLength=3, .Format="MEM8,IMMED8", .FormatLength=11, .ParamCount=2, .Param={{Param_Mem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xC7] = {.OpCode=0xC7, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=6, .Name="MOV", .NameLength=3, .Format="MEM16,IMMED16", .FormatLength=13, .ParamCount=2, .Param={{Param_Mem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xC8] = {.OpCode=0xC8, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xC9] = {.OpCode=0xC9, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xCA] = {.OpCode=0xCA, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="RETF", .NameLength=4, .Format="IMMED16 ; intersegment", .FormatLength=22, .ParamCount=1, .Param={{Param_Immed16}}},
+    }},
+    [0xCB] = {.OpCode=0xCB, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="RETF", .NameLength=4, .Format="; intersegment", .FormatLength=14, .ParamCount=1, .Param={{Param_Literal, "", 0}}},
+    }},
+    [0xCC] = {.OpCode=0xCC, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INT3", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xCD] = {.OpCode=0xCD, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="INT", .NameLength=3, .Format="IMMED8", .FormatLength=6, .ParamCount=1, .Param={{Param_Immed8}}},
+    }},
+    [0xCE] = {.OpCode=0xCE, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="INTO", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xCF] = {.OpCode=0xCF, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="IRET", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xD0] = {.OpCode=0xD0, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ROL", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ROR", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCL", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCR", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAL", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SHR", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAR", .NameLength=3, .Format="REG8/MEM8,1", .FormatLength=11, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "1", 1}}},
+    }},
+    [0xD1] = {.OpCode=0xD1, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ROL", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ROR", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCL", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCR", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAL", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SHR", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAR", .NameLength=3, .Format="REG16/MEM16,1", .FormatLength=13, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "1", 1}}},
+    }},
+    [0xD2] = {.OpCode=0xD2, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ROL", .NameLength=3, .Format="REG8/MEM8,CL", .FormatLength=12, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ROR", .NameLength=3, .Format="REG8/MEM8,CL", .FormatLength=12, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCL", .NameLength=3, .Format="REG8/MEM8,CL", .FormatLength=12, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCR", .NameLength=3, .Format="REG8/MEM8,CL", .FormatLength=12, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAL", .NameLength=3, .Format="REG8/MEM8,CL", .FormatLength=12, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SHR", .NameLength=3, .Format="REG81 MEM8,CL", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "REG81", 5}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAR", .NameLength=3, .Format="REG8/MEM8,CL", .FormatLength=12, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Literal, "CL", 2}}},
+    }},
+    [0xD3] = {.OpCode=0xD3, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ROL", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ROR", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCL", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="RCR", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAL", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SHR", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="SAR", .NameLength=3, .Format="REG16/MEM16,CL", .FormatLength=14, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Literal, "CL", 2}}},
+    }},
+    [0xD4] = {.OpCode=0xD4, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="AAM", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xD5] = {.OpCode=0xD5, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="AAD", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xD6] = {.OpCode=0xD6, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xD7] = {.OpCode=0xD7, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="XLAT", .NameLength=4, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xD8] = {.OpCode=0xD8, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xD9] = {.OpCode=0xD9, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xDA] = {.OpCode=0xDA, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xDB] = {.OpCode=0xDB, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xDC] = {.OpCode=0xDC, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xDD] = {.OpCode=0xDD, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xDE] = {.OpCode=0xDE, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xDF] = {.OpCode=0xDF, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+        {.UseMod=1, .MaxBytes=4, .Name="ESC", .NameLength=3, .Format="OPCODE,SOURCE", .FormatLength=13, .ParamCount=2, .Param={{Param_Literal, "OPCODE", 6}, {Param_Literal, "SOURCE", 6}}},
+    }},
+    [0xE0] = {.OpCode=0xE0, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="LOOPNE", .NameLength=6, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0xE1] = {.OpCode=0xE1, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="LOOPE", .NameLength=5, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0xE2] = {.OpCode=0xE2, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="LOOP", .NameLength=4, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0xE3] = {.OpCode=0xE3, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JCXZ", .NameLength=4, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0xE4] = {.OpCode=0xE4, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="IN", .NameLength=2, .Format="AL,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Immed8}}},
+    }},
+    [0xE5] = {.OpCode=0xE5, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="IN", .NameLength=2, .Format="AX,IMMED8", .FormatLength=9, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Immed8}}},
+    }},
+    [0xE6] = {.OpCode=0xE6, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="OUT", .NameLength=3, .Format="IMMED8,AL", .FormatLength=9, .ParamCount=2, .Param={{Param_Immed8}, {Param_Literal, "AL", 2}}},
+    }},
+    [0xE7] = {.OpCode=0xE7, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="OUT", .NameLength=3, .Format="IMMED8,AX", .FormatLength=9, .ParamCount=2, .Param={{Param_Immed8}, {Param_Literal, "AX", 2}}},
+    }},
+    [0xE8] = {.OpCode=0xE8, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="CALL", .NameLength=4, .Format="NEAR-PROC", .FormatLength=9, .ParamCount=1, .Param={{Param_Literal, "NEAR-PROC", 9}}},
+    }},
+    [0xE9] = {.OpCode=0xE9, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=3, .Name="JMP", .NameLength=3, .Format="NEAR-LABEL", .FormatLength=10, .ParamCount=1, .Param={{Param_Literal, "NEAR-LABEL", 10}}},
+    }},
+    [0xEA] = {.OpCode=0xEA, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=5, .Name="JMP", .NameLength=3, .Format="FAR-LABEL", .FormatLength=9, .ParamCount=1, .Param={{Param_Literal, "FAR-LABEL", 9}}},
+    }},
+    [0xEB] = {.OpCode=0xEB, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=2, .Name="JMP", .NameLength=3, .Format="SHORT-LABEL", .FormatLength=11, .ParamCount=1, .Param={{Param_ShortLabel}}},
+    }},
+    [0xEC] = {.OpCode=0xEC, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="IN", .NameLength=2, .Format="AL,DX", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AL", 2}, {Param_Literal, "DX", 2}}},
+    }},
+    [0xED] = {.OpCode=0xED, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="IN", .NameLength=2, .Format="AX,DX", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "AX", 2}, {Param_Literal, "DX", 2}}},
+    }},
+    [0xEE] = {.OpCode=0xEE, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="OUT", .NameLength=3, .Format="DX,AL", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "DX", 2}, {Param_Literal, "AL", 2}}},
+    }},
+    [0xEF] = {.OpCode=0xEF, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="OUT", .NameLength=3, .Format="DX,AX", .FormatLength=5, .ParamCount=2, .Param={{Param_Literal, "DX", 2}, {Param_Literal, "AX", 2}}},
+    }},
+    [0xF0] = {.OpCode=0xF0, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="LOCK+", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xF1] = {.OpCode=0xF1, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xF2] = {.OpCode=0xF2, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="REPNE", .NameLength=5, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xF3] = {.OpCode=0xF3, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="REP", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xF4] = {.OpCode=0xF4, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="HLT", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xF5] = {.OpCode=0xF5, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CMC", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xF6] = {.OpCode=0xF6, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=5, .Name="TEST", .NameLength=4, .Format="REG8/MEM8,IMMED8", .FormatLength=16, .ParamCount=2, .Param={{Param_RegOrMem8}, {Param_Immed8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="NOT", .NameLength=3, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=4, .Name="NEG", .NameLength=3, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MUL", .NameLength=3, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=4, .Name="IMUL", .NameLength=4, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=4, .Name="DIV", .NameLength=3, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=4, .Name="IDIV", .NameLength=4, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+    }},
+    [0xF7] = {.OpCode=0xF7, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=6, .Name="TEST", .NameLength=4, .Format="REG16/MEM16,IMMED16", .FormatLength=19, .ParamCount=2, .Param={{Param_RegOrMem16}, {Param_Immed16}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="NOT", .NameLength=3, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="NEG", .NameLength=3, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="MUL", .NameLength=3, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="IMUL", .NameLength=4, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="DIV", .NameLength=3, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="IDIV", .NameLength=4, .Format="REG16/MEM16", .FormatLength=11, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+    }},
+    [0xF8] = {.OpCode=0xF8, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CLC", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xF9] = {.OpCode=0xF9, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="STC", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xFA] = {.OpCode=0xFA, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CLI", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xFB] = {.OpCode=0xFB, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="STI", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xFC] = {.OpCode=0xFC, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="CLD", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xFD] = {.OpCode=0xFD, .UseExtension=0, .Extension=0, .OpVariantCount=1, .OpVariant=
+    {
+        {.UseMod=0, .MaxBytes=1, .Name="STD", .NameLength=3, .Format="", .FormatLength=0, .ParamCount=0, .Param={}},
+    }},
+    [0xFE] = {.OpCode=0xFE, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="INC", .NameLength=3, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=4, .Name="DEC", .NameLength=3, .Format="REG8/MEM8", .FormatLength=9, .ParamCount=1, .Param={{Param_RegOrMem8}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+    [0xFF] = {.OpCode=0xFF, .UseExtension=1, .Extension=7, .OpVariantCount=8, .OpVariant=
+    {
+        {.UseMod=1, .MaxBytes=4, .Name="INC", .NameLength=3, .Format="MEM16", .FormatLength=5, .ParamCount=1, .Param={{Param_Mem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="DEC", .NameLength=3, .Format="MEM16", .FormatLength=5, .ParamCount=1, .Param={{Param_Mem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="CALL", .NameLength=4, .Format="REG16/MEM16 ; intrasegment", .FormatLength=26, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="CALL", .NameLength=4, .Format="FAR MEM16 ; intersegment", .FormatLength=24, .ParamCount=1, .Param={{Param_Literal, "FAR", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="JMP", .NameLength=3, .Format="REG16/MEM16 ; intrasegment", .FormatLength=26, .ParamCount=1, .Param={{Param_RegOrMem16}}},
+        {.UseMod=1, .MaxBytes=4, .Name="JMP", .NameLength=3, .Format="FAR MEM16 ; intersegment", .FormatLength=24, .ParamCount=1, .Param={{Param_Literal, "FAR", 3}}},
+        {.UseMod=1, .MaxBytes=4, .Name="PUSH", .NameLength=4, .Format="MEM16", .FormatLength=5, .ParamCount=1, .Param={{Param_Mem16}}},
+        {.UseMod=1, .MaxBytes=2, .Name=";", .NameLength=1, .Format="not used", .FormatLength=8, .ParamCount=1, .Param={{Param_Literal, "not", 3}}},
+    }},
+};
@@ -51,4 +51,7 @@ for %%f in (%PART1%\*.asm) do (
     )
 )
 
+rem NOTE(chuck): sim8086 and sim86 have to agree on the shape of their JSONL.
+call python %CURRENT_DIRECTORY%t_jsonl.py %CURRENT_DIRECTORY%build\sim8086.exe
+
 echo %CURRENT_DIRECTORY%sim8086.log
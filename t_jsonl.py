@@ -0,0 +1,63 @@
+# NOTE(chuck): sim8086 and sim86 both have --format=jsonl, and tools reading it shouldn't have to care
+# which one wrote it. This runs both over every part1 listing and checks that each instruction comes
+# out with the same keys, and with the same operands in the same order.
+#
+#   python t_jsonl.py [sim8086 executable] [sim86 executable]
+
+import json
+import os
+import subprocess
+import sys
+
+here = os.path.dirname(os.path.abspath(__file__))
+sim8086 = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, "build", "sim8086.exe")
+sim86 = sys.argv[2] if len(sys.argv) > 2 else os.path.join(here, "perfaware", "sim86", "build", "sim86_msvc_release.exe")
+part1 = os.path.join(here, "perfaware", "part1")
+
+def shape(value):
+    if isinstance(value, dict):
+        return {key: shape(item) for key, item in value.items()}
+    if isinstance(value, list):
+        return [shape(item) for item in value]
+    return type(value).__name__
+
+def operand_order(instruction):
+    return [(operand["type"], operand.get("name")) for operand in instruction["operands"]]
+
+def keys_only(instruction):
+    # NOTE(chuck): The flags list is a list of strings either way, it just isn't always the same strings.
+    result = shape(instruction)
+    result["flags"] = []
+    return result
+
+def run(executable, listing):
+    output = subprocess.run([executable, "--format=jsonl", listing], capture_output=True, text=True).stdout
+    return [json.loads(line) for line in output.splitlines() if line.startswith("{")]
+
+failures = 0
+for name in sorted(os.listdir(part1)):
+    listing = os.path.join(part1, name)
+    if "." in name or not os.path.isfile(listing):
+        continue
+
+    a = run(sim8086, listing)
+    b = run(sim86, listing)
+    problem = None
+    if len(a) != len(b):
+        problem = f"{len(a)} instructions from sim8086, {len(b)} from sim86"
+    else:
+        for x, y in zip(a, b):
+            if list(x.keys()) != list(y.keys()) or keys_only(x) != keys_only(y):
+                problem = f"different keys at address {x['address']}"
+                break
+            if operand_order(x) != operand_order(y):
+                problem = f"different operands at address {x['address']}"
+                break
+
+    if problem:
+        print(f"FAIL {name}: {problem}")
+        failures += 1
+    else:
+        print(f"PASS {name}")
+
+sys.exit(1 if failures else 0)